@@ -67,6 +67,32 @@ public:
    */
   virtual double getRecordValue(std::size_t index) const = 0;
 
+  /**
+   * @brief Copy consecutive records of the DataSource into a buffer.
+   *
+   * @details
+   * The default implementation calls getRecordValue for each record. The
+   * DataSources which store their records contiguously should override it,
+   * so that their users pay one virtual call per block instead of one per record.
+   *
+   * @param offset
+   * The zero-based index of the first record to copy.
+   *
+   * @param records
+   * The buffer which receives the values, of at least count elements.
+   *
+   * @param count
+   * The number of records to copy.
+   *
+   * @throw Elements::Exception
+   * If a record does not exist.
+   */
+  virtual void readRecords(std::size_t offset, double* records, std::size_t count) const {
+    for (std::size_t i = 0; i < count; ++i) {
+      records[i] = getRecordValue(offset + i);
+    }
+  }
+
   virtual ~DataSourceInterface() = default;
 };
 
@@ -82,12 +108,20 @@ public:
    * @brief Compute the sum of the values of the records stored into the provided
    * DataSource
    *
+   * @details
+   * The records are read by blocks of block_size values with readRecords. Each block
+   * is reduced pairwise with several independent accumulators, which the compiler
+   * vectorizes, and the block sums are added with a compensated summation.
+   *
    * @param data_source
    * A reference to an object implementing DataSourceInterface.
    *
    * @return The sum of the values of the records into the DataSource object
    */
   double sumRecords(const DataSourceInterface& data_source);
+
+  /// The number of records read at once by sumRecords
+  static constexpr std::size_t block_size = 1024;
 };
 
 }  // namespace Examples
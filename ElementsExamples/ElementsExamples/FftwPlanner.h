@@ -0,0 +1,140 @@
+/**
+ * @file ElementsExamples/FftwPlanner.h
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+/**
+ * @addtogroup ElementsExamples ElementsExamples
+ * @{
+ */
+
+#ifndef ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_FFTWPLANNER_H_
+#define ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_FFTWPLANNER_H_
+
+#include <cstddef>  // for std::size_t
+#include <map>      // for map
+#include <mutex>    // for mutex
+#include <tuple>    // for tuple
+
+#include <fftw3.h>
+
+#include "ElementsKernel/Export.h"
+#include "ElementsKernel/Path.h"  // for Path::Item
+
+namespace Elements {
+namespace Examples {
+
+/**
+ * @class FftwPlanner
+ * @ingroup ElementsExamples
+ * @brief Plan the 1D complex FFTs once and reuse the plans.
+ *
+ * @details
+ * The plans are created at the first transform of each kind, with FFTW_MEASURE by default,
+ * and kept until the planner is destroyed. They are keyed by size, direction, in-place
+ * and alignment: the plans of arrays which are not SIMD aligned, like those of fftw_malloc,
+ * are created with FFTW_UNALIGNED, and thus apply to any array.
+ *
+ * The FFTW wisdom is imported from the wisdom file at construction, and exported back
+ * at destruction, so that the measurements of a run are reused by the next ones.
+ *
+ * The transforms can be run concurrently: the planning is serialized by a mutex shared by
+ * all the planners, as the FFTW planner is not thread-safe, while the execution is not.
+ * fftw_cleanup must not be called before all the planners are destroyed.
+ */
+class ELEMENTS_API FftwPlanner {
+public:
+  /**
+   * @brief Create a planner, and import the wisdom file if it exists.
+   *
+   * @param wisdom_file
+   * The file of the FFTW wisdom, or an empty path not to persist it.
+   *
+   * @param planning_flags
+   * The planning rigor, e.g. FFTW_MEASURE or FFTW_PATIENT.
+   */
+  explicit FftwPlanner(const Path::Item& wisdom_file = Path::Item(), unsigned planning_flags = FFTW_MEASURE);
+
+  /**
+   * @brief Destroy the plans, and export the wisdom file.
+   */
+  ~FftwPlanner();
+
+  FftwPlanner(const FftwPlanner&) = delete;
+  FftwPlanner& operator=(const FftwPlanner&) = delete;
+
+  /**
+   * @brief The plan of the transforms of arrays like in and out, created if needed.
+   *
+   * @details
+   * The plan is owned by the planner, and should be run with fftw_execute_dft
+   * on arrays of the same size, in-place-ness and alignment as in and out.
+   * The arrays are not read nor written.
+   *
+   * @param direction
+   * FFTW_FORWARD or FFTW_BACKWARD.
+   */
+  fftw_plan plan(std::size_t size, int direction, const fftw_complex* in, const fftw_complex* out);
+
+  /**
+   * @brief Transform in into out, which can be the same array, with the cached plan.
+   *
+   * @details
+   * As in FFTW, the backward transform is not normalized.
+   */
+  void execute(std::size_t size, int direction, fftw_complex* in, fftw_complex* out);
+
+  /**
+   * @brief Export the wisdom accumulated so far to the wisdom file,
+   * which is created with its directory if needed.
+   *
+   * @return false if there is no wisdom file or if it could not be written.
+   */
+  bool saveWisdom() const;
+
+  /**
+   * @brief The number of cached plans.
+   */
+  std::size_t planCount() const;
+
+  /**
+   * @brief The wisdom file of the ElementsExamples configuration, or else of the user's cache.
+   *
+   * @details
+   * ElementsExamples/fftw.wisdom is looked up in the configuration path. If it is not found,
+   * it is $XDG_CACHE_HOME/elements/ElementsExamples/fftw.wisdom, or
+   * ~/.cache/elements/ElementsExamples/fftw.wisdom, which may not exist yet.
+   * An empty path is returned if there is no home directory.
+   */
+  static Path::Item defaultWisdomFile();
+
+private:
+  /// size, direction, in-place, aligned
+  using PlanKey = std::tuple<std::size_t, int, bool, bool>;
+
+  static std::mutex& planningMutex();
+
+  Path::Item                   m_wisdom_file;
+  unsigned                     m_planning_flags;
+  std::map<PlanKey, fftw_plan> m_plans;
+};
+
+}  // namespace Examples
+}  // namespace Elements
+
+#endif  // ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_FFTWPLANNER_H_
+
+/**@}*/
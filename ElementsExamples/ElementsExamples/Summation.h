@@ -0,0 +1,79 @@
+/**
+ * @file ElementsExamples/Summation.h
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+/**
+ * @addtogroup ElementsExamples ElementsExamples
+ * @{
+ */
+
+#ifndef ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_SUMMATION_H_
+#define ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_SUMMATION_H_
+
+#include <cstddef>  // for std::size_t
+
+#include "ElementsKernel/Export.h"  // For ELEMENTS_API
+
+namespace Elements {
+namespace Examples {
+
+/**
+ * @class NaiveSummation
+ * @ingroup ElementsExamples
+ * @brief Summation policy adding the values one after the other.
+ *
+ * @details
+ * The rounding error grows linearly with the number of values.
+ */
+struct ELEMENTS_API NaiveSummation {
+  static double sum(const double* values, std::size_t count);
+};
+
+/**
+ * @class KahanSummation
+ * @ingroup ElementsExamples
+ * @brief Summation policy carrying the rounding error of each addition.
+ *
+ * @details
+ * The Neumaier variant of the compensated summation is used, which also handles
+ * the values larger than the running sum. The error does not depend on the
+ * number of values, but the loop cannot be vectorized.
+ */
+struct ELEMENTS_API KahanSummation {
+  static double sum(const double* values, std::size_t count);
+};
+
+/**
+ * @class PairwiseSummation
+ * @ingroup ElementsExamples
+ * @brief Summation policy adding the two halves of the values recursively.
+ *
+ * @details
+ * The rounding error grows with the logarithm of the number of values. The
+ * small ranges are summed with several independent partial sums, which the
+ * compiler vectorizes.
+ */
+struct ELEMENTS_API PairwiseSummation {
+  static double sum(const double* values, std::size_t count);
+};
+
+}  // namespace Examples
+}  // namespace Elements
+
+#endif  // ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_SUMMATION_H_
+
+/**@}*/
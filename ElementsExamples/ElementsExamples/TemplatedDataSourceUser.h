@@ -27,6 +27,10 @@
 #ifndef ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_TEMPLATEDDATASOURCEUSER_H_
 #define ELEMENTSEXAMPLES_ELEMENTSEXAMPLES_TEMPLATEDDATASOURCEUSER_H_
 
+#include <cstddef>  // for std::size_t
+
+#include "ElementsExamples/Summation.h"  // for PairwiseSummation
+
 namespace Elements {
 namespace Examples {
 
@@ -42,18 +46,35 @@ public:
    * @brief Compute the sum of the values of the records stored into the provided
    * DataSource
    *
+   * @details
+   * The records are split in chunks of chunk_size records, which are summed
+   * concurrently, then the partial sums of the chunks are summed in order. As
+   * the chunks do not depend on the number of threads, neither does the result.
+   *
    * @tparam T
    * A type representing a DataSource. The type must declare the methods
    * + size_t countRecords() const
    * + double getRecordValue(size_t index) const
+   * and the latter must be callable concurrently.
+   *
+   * @tparam Summation
+   * The summation policy, which declares the method
+   * + static double sum(const double* values, size_t count)
+   * like NaiveSummation, KahanSummation and PairwiseSummation.
    *
    * @param data_source
    * A reference to a DataSource object.
    *
+   * @param thread_count
+   * The number of threads, 0 for the number of hardware threads.
+   *
    * @return The sum of the values of the records into the DataSource object
    */
-  template <typename T>
-  double sumRecords(const T& data_source);
+  template <typename T, typename Summation = PairwiseSummation>
+  double sumRecords(const T& data_source, std::size_t thread_count = 0);
+
+  /// The number of records summed by a thread at once
+  static constexpr std::size_t chunk_size = 4096;
 };
 
 }  // namespace Examples
@@ -21,23 +21,43 @@
 
 #include "ElementsExamples/DataSourceUser.h"
 
-#include <cstdlib>  // for size_t
+#include <algorithm>  // for std::min
+#include <cmath>      // for std::abs
+#include <cstdlib>    // for size_t
+#include <vector>     // for std::vector
+
+#include "ElementsExamples/Summation.h"  // for PairwiseSummation
 
 namespace Elements {
 namespace Examples {
 
+using std::size_t;
+
+constexpr size_t DataSourceUser::block_size;
+
 double DataSourceUser::sumRecords(const DataSourceInterface& data_source) {
 
-  using std::size_t;
+  double sum          = 0.;
+  double compensation = 0.;
 
-  double sum = 0.;
+  std::vector<double> block(block_size);
 
   size_t records_number = data_source.countRecords();
-  for (size_t index = 0; index < records_number; ++index) {
-    sum += data_source.getRecordValue(index);
+  for (size_t offset = 0; offset < records_number; offset += block_size) {
+    const size_t count = std::min(block_size, records_number - offset);
+    data_source.readRecords(offset, block.data(), count);
+    // Neumaier summation of the block sums
+    const double block_sum = PairwiseSummation::sum(block.data(), count);
+    const double total     = sum + block_sum;
+    if (std::abs(sum) >= std::abs(block_sum)) {
+      compensation += (sum - total) + block_sum;
+    } else {
+      compensation += (block_sum - total) + sum;
+    }
+    sum = total;
   }
 
-  return sum;
+  return sum + compensation;
 }
 
 }  // namespace Examples
@@ -17,25 +17,132 @@
 
 #include "ElementsExamples/PiCalculator.h"
 
+#include <algorithm>  // for std::min, std::max
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint64_t
+#include <thread>     // for std::thread
+#include <vector>     // for std::vector
+
+#include "ElementsExamples/Summation.h"  // for PairwiseSummation
+
 namespace Elements {
 namespace Examples {
 
+using std::size_t;
+using std::uint64_t;
+
+constexpr uint64_t PiCalculator::chunk_size;
+
+namespace {
+
+/// The number of independent partial sums, enough to fill the vector registers
+constexpr size_t lane_count = 8;
+
+/// The offsets of 4k in the lanes
+constexpr double lane_offsets[lane_count] = {0.0, 4.0, 8.0, 12.0, 16.0, 20.0, 24.0, 28.0};
+
+/**
+ * @brief Sum the pairs of terms 2/((4k+1)(4k+3)) for k in [first, last)
+ */
+double sumPairs(uint64_t first, uint64_t last) {
+
+  // the lanes are independent, so that the additions need not be reordered to be vectorized
+  double   lanes[lane_count] = {};
+  uint64_t k                 = first;
+  for (; k + lane_count <= last; k += lane_count) {
+    const double base = 4.0 * static_cast<double>(k);
+    for (size_t lane = 0; lane < lane_count; ++lane) {
+      const double x = base + lane_offsets[lane];
+      lanes[lane] += 2.0 / ((x + 1.0) * (x + 3.0));
+    }
+  }
+
+  double sum = 0.0;
+  for (size_t lane = 0; lane < lane_count; ++lane) {
+    sum += lanes[lane];
+  }
+  for (; k < last; ++k) {
+    const double x = 4.0 * static_cast<double>(k);
+    sum += 2.0 / ((x + 1.0) * (x + 3.0));
+  }
+
+  return sum;
+}
+
+/**
+ * @brief The asymptotic expansion of pi minus 4 times the sum of the first terms of the series
+ */
+double eulerBooleCorrection(uint64_t terms) {
+  // 2 * sum of E_2m / N^(2m+1), with the Euler numbers E_2m and N = 2 * terms
+  const double inverse = 1.0 / (2.0 * static_cast<double>(terms));
+  const double square  = inverse * inverse;
+  const double tail    = inverse * (1.0 + square * (-1.0 + square * (5.0 + square * (-61.0 + square * 1385.0))));
+  return (terms % 2 == 0 ? 2.0 : -2.0) * tail;
+}
+
+}  // namespace
+
 void PiCalculator::calculate(unsigned int terms) {
 
-  double pi = 0.0;
-  // Leibniz formula for pi
-  double numerator   = -1.0;
-  double denominator = -1.0;
+  m_show_result_callback(compute(terms));
+}
+
+double PiCalculator::compute(uint64_t terms) const {
+
+  const uint64_t pairs        = terms / 2;
+  const uint64_t chunk_number = (pairs + chunk_size - 1) / chunk_size;
 
-  for (unsigned int ii = 0; ii < terms; ++ii) {
-    numerator *= -1;
-    denominator += 2.0;
-    pi += numerator / denominator;
+  std::vector<double> chunk_sums(chunk_number);
+
+  // each thread sums a contiguous range of chunks, [first, last)
+  auto sumChunks = [&chunk_sums, pairs](uint64_t first, uint64_t last) {
+    for (uint64_t chunk = first; chunk < last; ++chunk) {
+      chunk_sums[chunk] = sumPairs(chunk * chunk_size, std::min(pairs, (chunk + 1) * chunk_size));
+    }
+  };
+
+  size_t thread_count = m_thread_count;
+  if (thread_count == 0) {
+    thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  thread_count = static_cast<size_t>(std::min<uint64_t>(thread_count, chunk_number));
+
+  if (thread_count <= 1) {
+    sumChunks(0, chunk_number);
+  } else {
+    std::vector<std::thread> threads;
+    for (size_t worker = 0; worker < thread_count; ++worker) {
+      threads.emplace_back(sumChunks, chunk_number * worker / thread_count,
+                           chunk_number * (worker + 1) / thread_count);
+    }
+    for (auto& worker : threads) {
+      worker.join();
+    }
+  }
+
+  double pi = PairwiseSummation::sum(chunk_sums.data(), chunk_sums.size());
+  if (terms % 2 == 1) {
+    // the last term has an even index, and is positive
+    pi += 1.0 / (2.0 * static_cast<double>(terms - 1) + 1.0);
   }
 
   pi *= 4.0;
 
-  m_show_result_callback(pi);
+  if (m_accelerate and terms > 0) {
+    pi += eulerBooleCorrection(terms);
+  }
+
+  return pi;
+}
+
+void PiCalculator::setThreadCount(size_t thread_count) {
+
+  m_thread_count = thread_count;
+}
+
+void PiCalculator::setAcceleration(bool accelerate) {
+
+  m_accelerate = accelerate;
 }
 
 void PiCalculator::setShowResultCallback(show_result_callback_type f) {
@@ -0,0 +1,90 @@
+/**
+ * @file Summation.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include "ElementsExamples/Summation.h"
+
+#include <cmath>    // for std::abs
+#include <cstddef>  // for std::size_t
+
+namespace Elements {
+namespace Examples {
+
+using std::size_t;
+
+namespace {
+
+/// The number of independent partial sums, enough to fill the vector registers
+constexpr size_t lane_count = 8;
+
+/// The size below which the values are summed linearly
+constexpr size_t pairwise_threshold = 128;
+
+}  // namespace
+
+double NaiveSummation::sum(const double* values, size_t count) {
+  double total = 0.;
+  for (size_t index = 0; index < count; ++index) {
+    total += values[index];
+  }
+  return total;
+}
+
+double KahanSummation::sum(const double* values, size_t count) {
+  double total        = 0.;
+  double compensation = 0.;
+  for (size_t index = 0; index < count; ++index) {
+    const double next = total + values[index];
+    if (std::abs(total) >= std::abs(values[index])) {
+      compensation += (total - next) + values[index];
+    } else {
+      compensation += (values[index] - next) + total;
+    }
+    total = next;
+  }
+  return total + compensation;
+}
+
+double PairwiseSummation::sum(const double* values, size_t count) {
+
+  if (count > pairwise_threshold) {
+    const size_t half = count / 2 / lane_count * lane_count;
+    return sum(values, half) + sum(values + half, count - half);
+  }
+
+  // the lanes are independent, so that the additions need not be reordered to be vectorized
+  double lanes[lane_count] = {};
+  size_t index             = 0;
+  for (; index + lane_count <= count; index += lane_count) {
+    for (size_t lane = 0; lane < lane_count; ++lane) {
+      lanes[lane] += values[index + lane];
+    }
+  }
+
+  double total = 0.;
+  for (size_t lane = 0; lane < lane_count; ++lane) {
+    total += lanes[lane];
+  }
+  for (; index < count; ++index) {
+    total += values[index];
+  }
+
+  return total;
+}
+
+}  // namespace Examples
+}  // namespace Elements
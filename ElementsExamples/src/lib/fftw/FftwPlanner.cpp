@@ -0,0 +1,160 @@
+/**
+ * @file FftwPlanner.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include "ElementsExamples/FftwPlanner.h"
+
+#include <climits>    // for INT_MAX
+#include <cstddef>    // for std::size_t
+#include <mutex>      // for mutex, lock_guard
+#include <new>        // for bad_alloc
+#include <stdexcept>  // for invalid_argument, runtime_error
+#include <string>     // for string, to_string
+
+#include <boost/filesystem/operations.hpp>  // for exists, create_directories
+#include <boost/system/error_code.hpp>       // for error_code
+
+#include <fftw3.h>
+
+#include "ElementsKernel/Configuration.h"  // for getConfigurationPath
+#include "ElementsKernel/Logging.h"        // for Logging
+#include "ElementsKernel/Path.h"           // for Path::Item
+#include "ElementsKernel/System.h"         // for getEnv
+
+namespace Elements {
+namespace Examples {
+
+namespace {
+
+auto log = Logging::getLogger("FftwPlanner");
+
+const std::string WISDOM_FILE{"ElementsExamples/fftw.wisdom"};
+
+bool isAligned(const fftw_complex* array) {
+  return fftw_alignment_of(const_cast<double*>(array[0])) == 0;
+}
+
+}  // namespace
+
+FftwPlanner::FftwPlanner(const Path::Item& wisdom_file, unsigned planning_flags)
+    : m_wisdom_file(wisdom_file), m_planning_flags(planning_flags) {
+  if (m_wisdom_file.empty() or not boost::filesystem::exists(m_wisdom_file)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(planningMutex());
+  if (fftw_import_wisdom_from_filename(m_wisdom_file.c_str()) == 0) {
+    log.warn() << "Unable to import the FFTW wisdom from " << m_wisdom_file;
+  } else {
+    log.debug() << "FFTW wisdom imported from " << m_wisdom_file;
+  }
+}
+
+FftwPlanner::~FftwPlanner() {
+  saveWisdom();
+  std::lock_guard<std::mutex> lock(planningMutex());
+  for (auto& key_plan : m_plans) {
+    fftw_destroy_plan(key_plan.second);
+  }
+}
+
+fftw_plan FftwPlanner::plan(std::size_t size, int direction, const fftw_complex* in, const fftw_complex* out) {
+
+  if (size == 0 or size > static_cast<std::size_t>(INT_MAX)) {
+    throw std::invalid_argument("Unsupported FFT size: " + std::to_string(size));
+  }
+
+  const bool    in_place = in == out;
+  const bool    aligned  = isAligned(in) and isAligned(out);
+  const PlanKey key{size, direction, in_place, aligned};
+
+  std::lock_guard<std::mutex> lock(planningMutex());
+  auto                        found = m_plans.find(key);
+  if (found != m_plans.end()) {
+    return found->second;
+  }
+
+  // FFTW_MEASURE overwrites the arrays: the plan is measured on scratch arrays,
+  // allocated separately so that both are SIMD aligned whatever the size
+  const unsigned flags       = m_planning_flags | (aligned ? 0U : static_cast<unsigned>(FFTW_UNALIGNED));
+  fftw_complex*  scratch_in  = fftw_alloc_complex(size);
+  fftw_complex*  scratch_out = in_place ? scratch_in : fftw_alloc_complex(size);
+  if (scratch_in == nullptr or scratch_out == nullptr) {
+    fftw_free(scratch_in);
+    if (not in_place) {
+      fftw_free(scratch_out);
+    }
+    throw std::bad_alloc();
+  }
+  fftw_plan new_plan = fftw_plan_dft_1d(static_cast<int>(size), scratch_in, scratch_out, direction, flags);
+  if (not in_place) {
+    fftw_free(scratch_out);
+  }
+  fftw_free(scratch_in);
+  if (new_plan == nullptr) {
+    throw std::runtime_error("Unable to plan the FFT of size " + std::to_string(size));
+  }
+  m_plans.emplace(key, new_plan);
+  return new_plan;
+}
+
+void FftwPlanner::execute(std::size_t size, int direction, fftw_complex* in, fftw_complex* out) {
+  fftw_execute_dft(plan(size, direction, in, out), in, out);
+}
+
+bool FftwPlanner::saveWisdom() const {
+  if (m_wisdom_file.empty()) {
+    return false;
+  }
+  boost::system::error_code error;
+  boost::filesystem::create_directories(m_wisdom_file.parent_path(), error);
+  std::lock_guard<std::mutex> lock(planningMutex());
+  if (fftw_export_wisdom_to_filename(m_wisdom_file.c_str()) == 0) {
+    log.warn() << "Unable to export the FFTW wisdom to " << m_wisdom_file;
+    return false;
+  }
+  return true;
+}
+
+std::size_t FftwPlanner::planCount() const {
+  std::lock_guard<std::mutex> lock(planningMutex());
+  return m_plans.size();
+}
+
+Path::Item FftwPlanner::defaultWisdomFile() {
+  const Path::Item configured = getConfigurationPath(WISDOM_FILE, false);
+  if (not configured.empty()) {
+    return configured;
+  }
+  // the wisdom is specific to the machine, like the other cached data of the user
+  const std::string cache_home = System::getEnv("XDG_CACHE_HOME");
+  if (not cache_home.empty()) {
+    return Path::Item(cache_home) / "elements" / WISDOM_FILE;
+  }
+  const std::string home = System::getEnv("HOME");
+  if (not home.empty()) {
+    return Path::Item(home) / ".cache" / "elements" / WISDOM_FILE;
+  }
+  return Path::Item();
+}
+
+std::mutex& FftwPlanner::planningMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+}  // namespace Examples
+}  // namespace Elements
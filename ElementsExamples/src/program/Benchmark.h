@@ -0,0 +1,40 @@
+/**
+ * @file Benchmark.h
+ * @brief helpers shared by the benchmark programs of ElementsExamples
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifndef ELEMENTSEXAMPLES_SRC_PROGRAM_BENCHMARK_H_
+#define ELEMENTSEXAMPLES_SRC_PROGRAM_BENCHMARK_H_
+
+#include <chrono>  // for steady_clock, duration
+
+namespace Elements {
+namespace Examples {
+
+/// run the function and return the elapsed time in seconds
+template <typename Function>
+double timeIt(Function f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+}  // namespace Examples
+}  // namespace Elements
+
+#endif  // ELEMENTSEXAMPLES_SRC_PROGRAM_BENCHMARK_H_
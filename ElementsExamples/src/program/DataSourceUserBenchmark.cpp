@@ -0,0 +1,144 @@
+/**
+ * @file DataSourceUserBenchmark.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include <algorithm>  // for min, copy
+#include <cstddef>    // for size_t, ptrdiff_t
+#include <map>        // for map
+#include <random>     // for mt19937_64, uniform_real_distribution
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include <boost/program_options.hpp>  // for program options from configuration file of command line arguments
+
+#include "ElementsExamples/DataSourceUser.h"  // for DataSourceUser, DataSourceInterface
+#include "ElementsKernel/ProgramHeaders.h"    // for including all Program/related headers
+
+#include "Benchmark.h"  // for timeIt
+
+using std::map;
+using std::size_t;
+using std::string;
+using std::vector;
+
+using boost::program_options::value;
+
+namespace Elements {
+namespace Examples {
+
+namespace {
+
+/**
+ * @brief A DataSource of many records, which repeat a table held in memory
+ */
+class RepeatedDataSource : public DataSourceInterface {
+public:
+  RepeatedDataSource(vector<double> table, size_t records_number)
+      : m_table(std::move(table)), m_records_number(records_number) {}
+
+  size_t countRecords() const override {
+    return m_records_number;
+  }
+
+  double getRecordValue(size_t index) const override {
+    return m_table[index % m_table.size()];
+  }
+
+  void readRecords(size_t offset, double* records, size_t count) const override {
+    while (count > 0) {
+      const size_t start  = offset % m_table.size();
+      const size_t length = std::min(count, m_table.size() - start);
+      std::copy(m_table.begin() + static_cast<std::ptrdiff_t>(start),
+                m_table.begin() + static_cast<std::ptrdiff_t>(start + length), records);
+      offset += length;
+      records += length;
+      count -= length;
+    }
+  }
+
+private:
+  vector<double> m_table;
+  size_t         m_records_number;
+};
+
+}  // namespace
+
+/**
+ * @class DataSourceUserBenchmark
+ * @brief
+ *    Compare the summation of the records one by one with the block summation of DataSourceUser
+ * @details
+ *    The records repeat a table of one million random values, so that the default
+ *    size of 100M records needs little memory.
+ */
+class DataSourceUserBenchmark : public Program {
+
+public:
+  ExitCode mainMethod(map<string, VariableValue>& args) override {
+
+    auto log = Logging::getLogger("DataSourceUserBenchmark");
+
+    const auto size = args["size"].as<size_t>();
+
+    vector<double>                         table(1000000);
+    std::mt19937_64                        generator{0};
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    for (auto& t : table) {
+      t = distribution(generator);
+    }
+    const RepeatedDataSource data_source(table, size);
+
+    double       record_sum  = 0.;
+    const double record_time = timeIt([&data_source, &record_sum, size]() {
+      const DataSourceInterface& source = data_source;
+      for (size_t index = 0; index < size; ++index) {
+        record_sum += source.getRecordValue(index);
+      }
+    });
+
+    DataSourceUser user{};
+    double         block_sum  = 0.;
+    const double   block_time = timeIt([&data_source, &user, &block_sum]() {
+      block_sum = user.sumRecords(data_source);
+    });
+
+    const double mega_records = static_cast<double>(size) / 1.0e6;
+    log.info() << "Summed " << size << " records";
+    log.info() << "one virtual call per record:  " << record_time << " s (" << mega_records / record_time
+               << " Mrecords/s), sum " << record_sum;
+    log.info() << "blocks with sumRecords:       " << block_time << " s (" << mega_records / block_time
+               << " Mrecords/s), sum " << block_sum;
+
+    return ExitCode::OK;
+  }
+
+  OptionsDescription defineSpecificProgramOptions() override {
+    OptionsDescription options{};
+    options.add_options()("size", value<size_t>()->default_value(100000000), "Number of records to sum");
+    return options;
+  }
+};
+
+}  // namespace Examples
+}  // namespace Elements
+
+/**
+ * Implementation of a main using a base class macro
+ * This must be present in all Elements programs
+ */
+MAIN_FOR(Elements::Examples::DataSourceUserBenchmark)
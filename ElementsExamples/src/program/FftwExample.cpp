@@ -21,33 +21,81 @@
 #include <cmath>  // for cos
 #include <cstdio>
 #include <map>     // for map
+#include <memory>  // for unique_ptr
 #include <string>  // for string
 
-#include <boost/format.hpp>  // for format
+#include <boost/format.hpp>           // for format
+#include <boost/program_options.hpp>  // for program options from configuration file of command line arguments
 
 #include <fftw3.h>
 
 #include "ElementsKernel/MathConstants.h"   // for pi
 #include "ElementsKernel/ProgramHeaders.h"  // for including all Program/related headers
-#include "ElementsKernel/Unused.h"          // for ELEMENTS_UNUSED
 
+#include "ElementsExamples/FftwPlanner.h"  // for FftwPlanner
+
+using boost::program_options::value;
 using std::map;
 using std::string;
 
 constexpr std::size_t N = 32;
 
+/// Frees the arrays of fftw_alloc_complex
+struct FftwFree {
+  void operator()(fftw_complex* array) const {
+    fftw_free(array);
+  }
+};
+
+using FftwArray = std::unique_ptr<fftw_complex[], FftwFree>;
+
 namespace Elements {
 namespace Examples {
 
 class FftwExample : public Program {
 
 public:
-  ExitCode mainMethod(ELEMENTS_UNUSED map<string, VariableValue>& args) override {
+  OptionsDescription defineSpecificProgramOptions() override {
+    OptionsDescription options{};
+    options.add_options()("wisdom-file", value<string>()->default_value(""),
+                          "FFTW wisdom file, loaded at start and saved at the end "
+                          "(default: ElementsExamples/fftw.wisdom in the configuration path, or else in the user's cache)");
+    return options;
+  }
+
+  ExitCode mainMethod(map<string, VariableValue>& args) override {
 
     auto log = Logging::getLogger("FftwExample");
 
-    fftw_complex in[N], out[N], in2[N]; /* double [2] */
-    fftw_plan    p, q;
+    Path::Item wisdom_file = args["wisdom-file"].as<string>();
+    if (wisdom_file.empty()) {
+      wisdom_file = FftwPlanner::defaultWisdomFile();
+    }
+    if (wisdom_file.empty()) {
+      log.info() << "No FFTW wisdom file: the plans are measured again";
+    } else {
+      log.info() << "FFTW wisdom file: " << wisdom_file;
+    }
+
+    // the plans are cached and the wisdom saved until the planner is destroyed, before fftw_cleanup
+    transform(wisdom_file);
+
+    fftw_cleanup();
+
+    log.info() << "This is the end of the test";
+
+    return ExitCode::OK;
+  }
+
+private:
+  static void transform(const Path::Item& wisdom_file) {
+
+    auto log = Logging::getLogger("FftwExample");
+
+    FftwPlanner     planner(wisdom_file);
+    const FftwArray in(fftw_alloc_complex(N));
+    const FftwArray out(fftw_alloc_complex(N));
+    const FftwArray in2(fftw_alloc_complex(N));
 
     using std::cos;
 
@@ -58,17 +106,14 @@ public:
     }
 
     /* forward Fourier transform, save the result in 'out' */
-    p = fftw_plan_dft_1d(N, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
-    fftw_execute(p);
+    planner.execute(N, FFTW_FORWARD, in.get(), out.get());
     for (size_t i = 0; i < N; i++) {
       log.info() << boost::format("freq: %3d %+9.5f %+9.5f I") % i % out[i][0] % out[i][1];
     }
-    fftw_destroy_plan(p);
 
     /* backward Fourier transform, save the result in 'in2' */
     printf("\nInverse transform:\n");
-    q = fftw_plan_dft_1d(N, out, in2, FFTW_BACKWARD, FFTW_ESTIMATE);
-    fftw_execute(q);
+    planner.execute(N, FFTW_BACKWARD, out.get(), in2.get());
     /* normalize */
     for (size_t i = 0; i < N; i++) {
       in2[i][0] *= 1. / N;
@@ -78,13 +123,6 @@ public:
       log.info() << boost::format("recover: %3d %+9.5f %+9.5f I vs. %+9.5f %+9.5f I") % i % in[i][0] % in[i][1] %
                         in2[i][0] % in2[i][1];
     }
-    fftw_destroy_plan(q);
-
-    fftw_cleanup();
-
-    log.info() << "This is the end of the test";
-
-    return ExitCode::OK;
   }
 };
 
@@ -0,0 +1,117 @@
+/**
+ * @file NumberCastBenchmark.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <map>      // for map
+#include <random>   // for mt19937_64, uniform_real_distribution
+#include <string>   // for string
+#include <utility>  // for pair, make_pair
+#include <vector>   // for vector
+
+#include <boost/program_options.hpp>  // for program options from configuration file of command line arguments
+
+#include "ElementsKernel/Number.h"          // for numberCast
+#include "ElementsKernel/ProgramHeaders.h"  // for including all Program/related headers
+
+#include "Benchmark.h"  // for timeIt
+
+using std::int32_t;
+using std::map;
+using std::size_t;
+using std::string;
+using std::vector;
+
+using boost::program_options::value;
+
+namespace Elements {
+namespace Examples {
+
+/**
+ * @class NumberCastBenchmark
+ * @brief
+ *    Compare the element-wise numberCast with its bulk versions
+ * @details
+ *    A double array is converted to 32-bit integers. The default size of 100M elements
+ *    needs about 1.2 GB of memory.
+ */
+class NumberCastBenchmark : public Program {
+
+public:
+  ExitCode mainMethod(map<string, VariableValue>& args) override {
+
+    auto log = Logging::getLogger("NumberCastBenchmark");
+
+    const auto size = args["size"].as<size_t>();
+
+    vector<double>  source(size);
+    vector<int32_t> target(size);
+
+    std::mt19937_64                        generator{0};
+    std::uniform_real_distribution<double> distribution(-1.0e6, 1.0e6);
+    for (auto& s : source) {
+      s = distribution(generator);
+    }
+
+    const double scalar_time = timeIt([&source, &target, size]() {
+      for (size_t i = 0; i < size; ++i) {
+        target[i] = numberCast<int32_t>(source[i]);
+      }
+    });
+    const int32_t scalar_check = target[size / 2];
+
+    const double bulk_time = timeIt([&source, &target, size]() {
+      numberCast(source.data(), size, target.data());
+    });
+
+    const double saturate_time = timeIt([&source, &target, size]() {
+      numberCast<int32_t, RangePolicy::Saturate, NanPolicy::Zero>(source.data(), size, target.data());
+    });
+
+    if (target[size / 2] != scalar_check) {
+      log.error() << "The bulk and the scalar conversions differ";
+      return ExitCode::SOFTWARE;
+    }
+
+    const double mega_elements = static_cast<double>(size) / 1.0e6;
+    log.info() << "Converted " << size << " elements from double to int32_t";
+    log.info() << "scalar numberCast:            " << scalar_time << " s (" << mega_elements / scalar_time
+               << " Melements/s)";
+    log.info() << "bulk numberCast:              " << bulk_time << " s (" << mega_elements / bulk_time
+               << " Melements/s)";
+    log.info() << "bulk saturating numberCast:   " << saturate_time << " s (" << mega_elements / saturate_time
+               << " Melements/s)";
+
+    return ExitCode::OK;
+  }
+
+  OptionsDescription defineSpecificProgramOptions() override {
+    OptionsDescription options{};
+    options.add_options()("size", value<size_t>()->default_value(100000000), "Number of elements to convert");
+    return options;
+  }
+};
+
+}  // namespace Examples
+}  // namespace Elements
+
+/**
+ * Implementation of a main using a base class macro
+ * This must be present in all Elements programs
+ */
+MAIN_FOR(Elements::Examples::NumberCastBenchmark)
@@ -18,81 +18,192 @@
  *
  */
 
-#include <complex>  // for complex
-#include <cstdio>   // for size_t
-#include <map>      // for map
-#include <string>   // for string
+#include <algorithm>  // for min
+#include <chrono>     // for steady_clock, duration
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int64_t
+#include <cstdio>     // for putchar, puts
+#include <map>        // for map
+#include <string>     // for string
+#include <vector>     // for vector
 
-#include <boost/current_function.hpp>  // for BOOST_CURRENT_FUNCTION
+#include <boost/program_options.hpp>  // for program options from configuration file of command line arguments
+
+#ifdef _OPENMP
+#include <omp.h>  // for omp_get_max_threads
+#endif
 
 #include "ElementsKernel/ProgramHeaders.h"  // for including all Program/related headers
+#include "ElementsKernel/Unused.h"          // for ELEMENTS_UNUSED
 
 using std::map;
 using std::size_t;
 using std::string;
-using complex = std::complex<double>;
+using std::vector;
+
+using boost::program_options::value;
 
 namespace Elements {
 namespace Examples {
 
 static constexpr char CHARSET[] = ".,c8M@jawrpogOQEPGJ";
 
+/// The number of pixels iterated together, enough to fill the vector registers
+static constexpr size_t LANE_COUNT = 8;
+
+/**
+ * @class OpenMPExample
+ * @brief
+ *    Render the Mandelbrot set with OpenMP and measure its scaling
+ * @details
+ *    The image is split in square tiles, which the threads take dynamically,
+ *    as the cost of the pixels varies a lot. The pixels of a tile row are
+ *    iterated by groups of LANE_COUNT, which the compiler vectorizes. The
+ *    image is rendered once per number of threads (1, 2, 4... up to the
+ *    maximum), then printed.
+ */
 class OpenMPExample : public Program {
 
 public:
-  ExitCode mainMethod(map<string, VariableValue>& /*args*/) override {
+  ExitCode mainMethod(map<string, VariableValue>& args) override {
 
     auto log = Logging::getLogger("ProgramExample");
 
-    const int width = 78, height = 44, num_pixels = width * height;
+    const auto width     = args["width"].as<size_t>();
+    const auto height    = args["height"].as<size_t>();
+    const auto maxiter   = args["maxiter"].as<size_t>();
+    const auto tile_size = std::max(args["tile-size"].as<size_t>(), size_t{1});
 
-    const complex center(-.7, 0), span(2.7, -(4 / 3.0) * 2.7 * height / width);
-    const complex begin   = center - span / 2.0;  //, end = center+span/2.0;
-    const int     maxiter = 100000;
+    const double center_real = -.7, span_real = 2.7;
+    const double span_imag  = -(4 / 3.0) * 2.7 * static_cast<double>(height) / static_cast<double>(width);
+    const double begin_real = center_real - span_real / 2.0;
+    const double begin_imag = -span_imag / 2.0;
+    const double step_real  = span_real / (static_cast<double>(width) + 1.0);
+    const double step_imag  = span_imag / (static_cast<double>(height) + 1.0);
 
-#pragma omp parallel for ordered schedule(dynamic)
-    for (int pix = 0; pix < num_pixels; ++pix) {
+    const double num_pixels = static_cast<double>(width * height);
 
-      const int x = pix % width, y = pix / width;
+    vector<size_t> framebuffer(width * height);
+    double         single_time = 0.0;
+    for (int threads = 1;; threads *= 2) {
+      threads = std::min(threads, maxThreads());
 
-      complex c = begin + complex(x * span.real() / (width + 1.0), y * span.imag() / (height + 1.0));
+      const auto start = std::chrono::steady_clock::now();
+      renderTiles(framebuffer, width, height, tile_size, maxiter, begin_real, begin_imag, step_real, step_imag,
+                  threads);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
 
-      size_t n = mandelbrotCalculate(c, maxiter);
-      if (n == maxiter) {
-        n = 0;
+      if (threads == 1) {
+        single_time = elapsed.count();
       }
+      log.info() << threads << " thread(s): " << elapsed.count() << " s, " << num_pixels / elapsed.count()
+                 << " pixels/s, speedup " << single_time / elapsed.count();
 
-#pragma omp ordered
-      {
-        char c2 = ' ';
-        if (n > 0) {
-          c2 = CHARSET[n % (sizeof(CHARSET) - 1)];
-        }
-        std::putchar(c2);
-        if (x + 1 == width) {
-          std::puts("|");
-        }
+      if (threads == maxThreads()) {
+        break;
       }
     }
 
+    if (args["print"].as<bool>()) {
+      printFramebuffer(framebuffer, width, maxiter);
+    }
+
     log.info() << "done with test program! ";
 
     return ExitCode::OK;
   }
 
+  OptionsDescription defineSpecificProgramOptions() override {
+    OptionsDescription options{};
+    options.add_options()("width", value<size_t>()->default_value(78), "Width of the image in characters")(
+        "height", value<size_t>()->default_value(44), "Height of the image in characters")(
+        "maxiter", value<size_t>()->default_value(100000), "Maximum number of iterations per pixel")(
+        "tile-size", value<size_t>()->default_value(16), "Size of the square tiles distributed to the threads")(
+        "print", value<bool>()->default_value(true), "Print the image at the end");
+    return options;
+  }
+
 private:
-  static size_t mandelbrotCalculate(const complex c, const size_t maxiter) {
-    // iterates z = z + c until |z| >= 2 or maxiter is reached,
-    // returns the number of iterations.
-    complex z = c;
-    size_t  n = 0;
-    for (; n < maxiter; ++n) {
-      if (std::abs(z) >= 2.0) {
+  static int maxThreads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  static void renderTiles(vector<size_t>& framebuffer, size_t width, size_t height, size_t tile_size, size_t maxiter,
+                          double begin_real, double begin_imag, double step_real, double step_imag,
+                          ELEMENTS_UNUSED int threads) {
+
+    const size_t tiles_x   = (width + tile_size - 1) / tile_size;
+    const size_t tiles_y   = (height + tile_size - 1) / tile_size;
+    const long   tile_count = static_cast<long>(tiles_x * tiles_y);
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (long tile = 0; tile < tile_count; ++tile) {
+      const size_t first_x = static_cast<size_t>(tile) % tiles_x * tile_size;
+      const size_t first_y = static_cast<size_t>(tile) / tiles_x * tile_size;
+      const size_t last_x  = std::min(first_x + tile_size, width);
+      const size_t last_y  = std::min(first_y + tile_size, height);
+      for (size_t y = first_y; y < last_y; ++y) {
+        const double c_imag = begin_imag + static_cast<double>(y) * step_imag;
+        for (size_t x = first_x; x < last_x; x += LANE_COUNT) {
+          size_t iterations[LANE_COUNT];
+          mandelbrotCalculate(begin_real, step_real, x, c_imag, maxiter, iterations);
+          std::copy(iterations, iterations + std::min(LANE_COUNT, last_x - x), &framebuffer[y * width + x]);
+        }
+      }
+    }
+  }
+
+  static void printFramebuffer(const vector<size_t>& framebuffer, size_t width, size_t maxiter) {
+    for (size_t pix = 0; pix < framebuffer.size(); ++pix) {
+      const size_t n  = framebuffer[pix] == maxiter ? 0 : framebuffer[pix];
+      char         c2 = ' ';
+      if (n > 0) {
+        c2 = CHARSET[n % (sizeof(CHARSET) - 1)];
+      }
+      std::putchar(c2);
+      if ((pix + 1) % width == 0) {
+        std::puts("|");
+      }
+    }
+  }
+
+  static void mandelbrotCalculate(double begin_real, double step_real, size_t x, double c_imag, size_t maxiter,
+                                  size_t (&iterations)[LANE_COUNT]) {
+    // iterates z = z * z + c until |z| >= 2 or maxiter is reached, for LANE_COUNT
+    // consecutive pixels of a row, and stores their numbers of iterations.
+    // The escaped pixels are frozen, and |z|^2 is compared to 4 to avoid the sqrt.
+    double       c_reals[LANE_COUNT], z_reals[LANE_COUNT], z_imags[LANE_COUNT];
+    std::int64_t counts[LANE_COUNT];
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+      c_reals[lane] = begin_real + static_cast<double>(x + lane) * step_real;
+      z_reals[lane] = c_reals[lane];
+      z_imags[lane] = c_imag;
+      counts[lane]  = 0;
+    }
+    for (size_t n = 0; n < maxiter; ++n) {
+      std::int64_t inside_count = 0;
+      for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+        const double       real2  = z_reals[lane] * z_reals[lane];
+        const double       imag2  = z_imags[lane] * z_imags[lane];
+        const std::int64_t inside = real2 + imag2 < 4.0 ? 1 : 0;
+        const double       real   = real2 - imag2 + c_reals[lane];
+        const double       imag   = 2.0 * z_reals[lane] * z_imags[lane] + c_imag;
+        z_reals[lane]             = inside != 0 ? real : z_reals[lane];
+        z_imags[lane]             = inside != 0 ? imag : z_imags[lane];
+        counts[lane] += inside;
+        inside_count += inside;
+      }
+      if (inside_count == 0) {
         break;
       }
-      z = z * z + c;
     }
-    return n;
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+      iterations[lane] = static_cast<size_t>(counts[lane]);
+    }
   }
 };
 
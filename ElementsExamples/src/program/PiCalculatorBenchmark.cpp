@@ -0,0 +1,136 @@
+/**
+ * @file PiCalculatorBenchmark.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include <algorithm>  // for max
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <cstring>    // for memcmp
+#include <iomanip>    // for setprecision
+#include <map>        // for map
+#include <string>     // for string
+#include <thread>     // for thread
+
+#include <boost/program_options.hpp>  // for program options from configuration file of command line arguments
+
+#include "ElementsExamples/PiCalculator.h"  // for PiCalculator
+#include "ElementsKernel/ProgramHeaders.h"  // for including all Program/related headers
+
+#include "Benchmark.h"  // for timeIt
+
+using std::map;
+using std::size_t;
+using std::string;
+using std::uint64_t;
+
+using boost::program_options::value;
+
+namespace Elements {
+namespace Examples {
+
+namespace {
+
+/// the Leibniz series evaluated one term after the other, as a reference
+double serialLeibniz(uint64_t terms) {
+  double pi          = 0.0;
+  double numerator   = -1.0;
+  double denominator = -1.0;
+  for (uint64_t ii = 0; ii < terms; ++ii) {
+    numerator *= -1;
+    denominator += 2.0;
+    pi += numerator / denominator;
+  }
+  return 4.0 * pi;
+}
+
+}  // namespace
+
+/**
+ * @class PiCalculatorBenchmark
+ * @brief
+ *    Measure the throughput of the PiCalculator, in terms per second and per core
+ * @details
+ *    The serial evaluation of the series is compared with the vectorized one,
+ *    on a single thread and on all the requested threads.
+ */
+class PiCalculatorBenchmark : public Program {
+
+public:
+  ExitCode mainMethod(map<string, VariableValue>& args) override {
+
+    auto log = Logging::getLogger("PiCalculatorBenchmark");
+
+    const auto terms   = args["terms"].as<uint64_t>();
+    auto       threads = args["threads"].as<size_t>();
+    if (threads == 0) {
+      threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    double       serial_pi   = 0.0;
+    const double serial_time = timeIt([&serial_pi, terms]() {
+      serial_pi = serialLeibniz(terms);
+    });
+
+    PiCalculator calculator{};
+    calculator.setThreadCount(1);
+    double       single_pi   = 0.0;
+    const double single_time = timeIt([&calculator, &single_pi, terms]() {
+      single_pi = calculator.compute(terms);
+    });
+
+    calculator.setThreadCount(threads);
+    double       parallel_pi   = 0.0;
+    const double parallel_time = timeIt([&calculator, &parallel_pi, terms]() {
+      parallel_pi = calculator.compute(terms);
+    });
+
+    // the chunks are summed in the same order whatever the threads: the results are bit-identical
+    if (std::memcmp(&parallel_pi, &single_pi, sizeof(double)) != 0) {
+      log.error() << "The result depends on the number of threads";
+      return ExitCode::SOFTWARE;
+    }
+
+    const double mega_terms = static_cast<double>(terms) / 1.0e6;
+    log.info() << "Summed " << terms << " terms of the Leibniz series";
+    log.info() << "serial loop:                  " << serial_time << " s (" << mega_terms / serial_time
+               << " Mterms/s per core), pi = " << std::setprecision(15) << serial_pi;
+    log.info() << "vectorized, 1 thread:         " << single_time << " s (" << mega_terms / single_time
+               << " Mterms/s per core), pi = " << std::setprecision(15) << single_pi;
+    log.info() << "vectorized, " << threads << " thread(s):       " << parallel_time << " s ("
+               << mega_terms / parallel_time << " Mterms/s, "
+               << mega_terms / parallel_time / static_cast<double>(threads)
+               << " Mterms/s per core), pi = " << std::setprecision(15) << parallel_pi;
+
+    return ExitCode::OK;
+  }
+
+  OptionsDescription defineSpecificProgramOptions() override {
+    OptionsDescription options{};
+    options.add_options()("terms", value<uint64_t>()->default_value(1000000000), "Number of terms of the series")(
+        "threads", value<size_t>()->default_value(0), "Number of threads (0 for the number of hardware threads)");
+    return options;
+  }
+};
+
+}  // namespace Examples
+}  // namespace Elements
+
+/**
+ * Implementation of a main using a base class macro
+ * This must be present in all Elements programs
+ */
+MAIN_FOR(Elements::Examples::PiCalculatorBenchmark)
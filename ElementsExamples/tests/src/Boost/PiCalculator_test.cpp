@@ -21,7 +21,11 @@
 
 #include "ElementsExamples/PiCalculator.h"  // Access the objects you want to test
 
+#include <boost/math/constants/constants.hpp>
 #include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 
 using Elements::Examples::PiCalculator;
@@ -43,5 +47,50 @@ BOOST_AUTO_TEST_CASE(Creation_test) {
   pc.calculate(10);
 }
 
+BOOST_AUTO_TEST_CASE(Leibniz_test) {
+
+  using boost::math::double_constants::pi;
+
+  auto pc = PiCalculator();
+
+  // the terms one by one, with the alternating sign
+  for (std::uint64_t terms : {0, 1, 2, 11, 100}) {
+    double sum = 0.0;
+    for (std::uint64_t k = 0; k < terms; ++k) {
+      sum += (k % 2 == 0 ? 1.0 : -1.0) / (2.0 * static_cast<double>(k) + 1.0);
+    }
+    BOOST_CHECK_CLOSE(pc.compute(terms) + 1.0, 4.0 * sum + 1.0, 1e-12);
+  }
+
+  // the error of the partial sum is about 1/n
+  BOOST_CHECK_LT(std::abs(pc.compute(1000001) - pi), 1.1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(Deterministic_test) {
+
+  auto pc = PiCalculator();
+
+  const std::uint64_t terms = 7 * PiCalculator::chunk_size + 12345;
+  pc.setThreadCount(1);
+  const double reference = pc.compute(terms);
+  for (std::size_t thread_count : {2, 3, 8}) {
+    // the results are compared bit for bit
+    pc.setThreadCount(thread_count);
+    BOOST_CHECK_EQUAL(pc.compute(terms), reference);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Acceleration_test) {
+
+  using boost::math::double_constants::pi;
+
+  auto pc = PiCalculator();
+  pc.setAcceleration(true);
+
+  BOOST_CHECK_LT(std::abs(pc.compute(10) - pi), 1e-8);
+  BOOST_CHECK_LT(std::abs(pc.compute(1000) - pi), 1e-14);
+  BOOST_CHECK_LT(std::abs(pc.compute(1001) - pi), 1e-14);
+}
+
 // Ends the test suite
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,61 @@
+/**
+ * @file Summation_test.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include "ElementsExamples/Summation.h"  // Access the objects you want to test
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using Elements::Examples::KahanSummation;
+using Elements::Examples::NaiveSummation;
+using Elements::Examples::PairwiseSummation;
+
+// Starts a test suite and name it.
+BOOST_AUTO_TEST_SUITE(Summation_test_suite)
+
+BOOST_AUTO_TEST_CASE(Exact_test) {
+
+  const std::vector<double> values{1., 2., 3., 4., 5.};
+
+  BOOST_CHECK_EQUAL(NaiveSummation::sum(values.data(), values.size()), 15.);
+  BOOST_CHECK_EQUAL(KahanSummation::sum(values.data(), values.size()), 15.);
+  BOOST_CHECK_EQUAL(PairwiseSummation::sum(values.data(), values.size()), 15.);
+  BOOST_CHECK_EQUAL(PairwiseSummation::sum(values.data(), 0), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(Accuracy_test) {
+
+  // 0.1 is not representable: the naive summation drifts by about 1e-6 over a million values
+  const std::vector<double> values(1000000, 0.1);
+
+  BOOST_CHECK_CLOSE(KahanSummation::sum(values.data(), values.size()), 100000., 1e-12);
+  BOOST_CHECK_CLOSE(PairwiseSummation::sum(values.data(), values.size()), 100000., 1e-12);
+  BOOST_CHECK_CLOSE(NaiveSummation::sum(values.data(), values.size()), 100000., 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(Cancellation_test) {
+
+  // the small value is lost by the naive summation
+  const std::vector<double> values{1., 1e100, 1., -1e100};
+
+  BOOST_CHECK_EQUAL(KahanSummation::sum(values.data(), values.size()), 2.);
+  BOOST_CHECK_EQUAL(NaiveSummation::sum(values.data(), values.size()), 0.);
+}
+
+// Ends the test suite
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+/**
+ * @file FftwPlanner_test.cpp
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#include "ElementsExamples/FftwPlanner.h"  // Access the objects you want to test
+
+#include <cmath>  // for cos, sin
+#include <cstddef>
+#include <stdexcept>  // for invalid_argument
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>  // for exists
+#include <boost/test/unit_test.hpp>
+
+#include <fftw3.h>
+
+#include "ElementsKernel/Environment.h"    // for Environment
+#include "ElementsKernel/MathConstants.h"  // for pi
+#include "ElementsKernel/Temporary.h"      // for TempDir
+
+using Elements::Environment;
+using Elements::TempDir;
+using Elements::Examples::FftwPlanner;
+
+namespace {
+
+constexpr std::size_t N = 64;
+
+/// A SIMD aligned array, as FFTW prefers them
+struct Buffer {
+  explicit Buffer(std::size_t size = N) : data(fftw_alloc_complex(size)) {}
+  ~Buffer() {
+    fftw_free(data);
+  }
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+
+  fftw_complex* data;
+};
+
+void fillCosine(fftw_complex* array) {
+  for (std::size_t i = 0; i < N; ++i) {
+    array[i][0] = std::cos(3.0 * 2.0 * Elements::Units::pi * static_cast<double>(i) / static_cast<double>(N));
+    array[i][1] = 0.0;
+  }
+}
+
+}  // namespace
+
+// Starts a test suite and name it.
+BOOST_AUTO_TEST_SUITE(FftwPlanner_test_suite)
+
+BOOST_AUTO_TEST_CASE(RoundTrip_test) {
+
+  FftwPlanner planner(Elements::Path::Item(), FFTW_ESTIMATE);
+  Buffer      in, out, back;
+
+  fillCosine(in.data);
+  planner.execute(N, FFTW_FORWARD, in.data, out.data);
+  planner.execute(N, FFTW_BACKWARD, out.data, back.data);
+
+  BOOST_CHECK_CLOSE(out.data[3][0], N / 2.0, 1e-9);
+  for (std::size_t i = 0; i < N; ++i) {
+    BOOST_CHECK_SMALL(back.data[i][0] / N - in.data[i][0], 1e-12);
+    BOOST_CHECK_SMALL(back.data[i][1] / N - in.data[i][1], 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(OddSize_test) {
+
+  // the scratch arrays of the measurement are aligned like the arrays of the execution
+  constexpr std::size_t odd = 45;
+  FftwPlanner           planner(Elements::Path::Item(), FFTW_MEASURE);
+  Buffer                in(odd), out(odd);
+
+  for (std::size_t i = 0; i < odd; ++i) {
+    in.data[i][0] = static_cast<double>(i % 7);
+    in.data[i][1] = static_cast<double>(i % 3);
+  }
+  planner.execute(odd, FFTW_FORWARD, in.data, out.data);
+
+  // against the direct DFT
+  for (std::size_t k = 0; k < odd; ++k) {
+    double real = 0.0;
+    double imag = 0.0;
+    for (std::size_t i = 0; i < odd; ++i) {
+      const double angle = -2.0 * Elements::Units::pi * static_cast<double>(i * k) / static_cast<double>(odd);
+      real += in.data[i][0] * std::cos(angle) - in.data[i][1] * std::sin(angle);
+      imag += in.data[i][0] * std::sin(angle) + in.data[i][1] * std::cos(angle);
+    }
+    BOOST_CHECK_SMALL(out.data[k][0] - real, 1e-9);
+    BOOST_CHECK_SMALL(out.data[k][1] - imag, 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PlanCache_test) {
+
+  FftwPlanner   planner(Elements::Path::Item(), FFTW_ESTIMATE);
+  Buffer        in_buffer, out_buffer;
+  fftw_complex* in  = in_buffer.data;
+  fftw_complex* out = out_buffer.data;
+  fillCosine(in);
+
+  const fftw_plan forward = planner.plan(N, FFTW_FORWARD, in, out);
+  BOOST_CHECK_EQUAL(planner.plan(N, FFTW_FORWARD, in, out), forward);
+  BOOST_CHECK_EQUAL(planner.planCount(), 1U);
+
+  // the direction, the in-place-ness and the size are parts of the key
+  BOOST_CHECK_NE(planner.plan(N, FFTW_BACKWARD, in, out), forward);
+  BOOST_CHECK_NE(planner.plan(N, FFTW_FORWARD, in, in), forward);
+  BOOST_CHECK_NE(planner.plan(N / 2, FFTW_FORWARD, in, out), forward);
+  BOOST_CHECK_EQUAL(planner.planCount(), 4U);
+
+  // so is the alignment, the misaligned arrays get an unaligned plan
+  const fftw_complex* misaligned = reinterpret_cast<const fftw_complex*>(out[0] + 1);
+  BOOST_CHECK_NE(planner.plan(N / 2, FFTW_FORWARD, in, misaligned), planner.plan(N / 2, FFTW_FORWARD, in, out));
+
+  BOOST_CHECK_THROW(planner.plan(0, FFTW_FORWARD, in, out), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(Concurrent_test) {
+
+  FftwPlanner planner(Elements::Path::Item(), FFTW_ESTIMATE);
+
+  Buffer                   outputs[4];
+  std::vector<std::thread> threads;
+  for (auto& output : outputs) {
+    threads.emplace_back([&planner, &output]() {
+      Buffer in;
+      fillCosine(in.data);
+      for (int repetition = 0; repetition < 100; ++repetition) {
+        planner.execute(N, FFTW_FORWARD, in.data, output.data);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& output : outputs) {
+    BOOST_CHECK_CLOSE(output.data[3][0], N / 2.0, 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Wisdom_test) {
+
+  TempDir                    dir;
+  const Elements::Path::Item wisdom_file = dir.path() / "fftw.wisdom";
+  Buffer                     in, out;
+
+  {
+    FftwPlanner planner(wisdom_file, FFTW_MEASURE);
+    planner.execute(N, FFTW_FORWARD, in.data, out.data);
+  }
+  BOOST_CHECK(boost::filesystem::exists(wisdom_file));
+  fftw_forget_wisdom();
+
+  // the wisdom is reloaded, and the plan of the same transform is not measured again
+  FftwPlanner planner(wisdom_file, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+  fillCosine(in.data);
+  BOOST_CHECK_NO_THROW(planner.execute(N, FFTW_FORWARD, in.data, out.data));
+  BOOST_CHECK_CLOSE(out.data[3][0], N / 2.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(DefaultWisdom_test) {
+
+  TempDir     dir;
+  Environment env;
+  env["XDG_CACHE_HOME"] = dir.path().string();
+
+  // the wisdom is kept in the user's cache, whose directory is created when it is saved
+  const auto wisdom_file = FftwPlanner::defaultWisdomFile();
+  BOOST_CHECK_EQUAL(wisdom_file, dir.path() / "elements" / "ElementsExamples" / "fftw.wisdom");
+  Buffer in, out;
+  {
+    FftwPlanner planner(wisdom_file, FFTW_ESTIMATE);
+    planner.execute(N, FFTW_FORWARD, in.data, out.data);
+  }
+  BOOST_CHECK(boost::filesystem::exists(wisdom_file));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
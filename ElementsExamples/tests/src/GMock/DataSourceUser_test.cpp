@@ -21,9 +21,12 @@
 
 #include "ElementsExamples/DataSourceUser.h"  // Access the objects you want to test
 
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 #include <cstddef>
 #include <gmock/gmock.h>
+#include <utility>
+#include <vector>
 
 #include "ElementsKernel/EnableGMock.h"  // initialize the gmock framework
 #include "ElementsKernel/Real.h"
@@ -31,8 +34,35 @@
 #include "DataSourceInterfaceMock.h"
 
 using std::size_t;
+using testing::_;
 using testing::Return;
 
+namespace {
+
+/// A DataSource whose records are contiguous in memory
+class VectorDataSource : public Elements::Examples::DataSourceInterface {
+public:
+  explicit VectorDataSource(std::vector<double> records) : m_records(std::move(records)) {}
+
+  size_t countRecords() const override {
+    return m_records.size();
+  }
+
+  double getRecordValue(size_t index) const override {
+    return m_records.at(index);
+  }
+
+  void readRecords(size_t offset, double* records, size_t count) const override {
+    std::copy(m_records.begin() + static_cast<std::ptrdiff_t>(offset),
+              m_records.begin() + static_cast<std::ptrdiff_t>(offset + count), records);
+  }
+
+private:
+  std::vector<double> m_records;
+};
+
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(DataSourceUser_test_suite)
 
 BOOST_AUTO_TEST_CASE(sumRecords_test) {
@@ -53,5 +83,33 @@ BOOST_AUTO_TEST_CASE(sumRecords_test) {
   BOOST_CHECK_MESSAGE(Elements::isEqual(result, 15.), "Expected value :" << 15. << " Actual value :" << result);
 }
 
+BOOST_AUTO_TEST_CASE(sumRecordsByBlocks_test) {
+
+  // Setup mock: the records span several blocks, the last one partial
+  Elements::Examples::DataSourceInterfaceMock data_source_mock;
+
+  const size_t records_number = 2 * Elements::Examples::DataSourceUser::block_size + 3;
+  EXPECT_CALL(data_source_mock, countRecords()).Times(1).WillOnce(Return(records_number));
+  EXPECT_CALL(data_source_mock, getRecordValue(_)).Times(static_cast<int>(records_number)).WillRepeatedly(Return(2.));
+
+  Elements::Examples::DataSourceUser user{};
+  double                             result = user.sumRecords(data_source_mock);
+
+  BOOST_CHECK_MESSAGE(Elements::isEqual(result, 2. * static_cast<double>(records_number)),
+                      "Expected value :" << 2. * static_cast<double>(records_number) << " Actual value :" << result);
+}
+
+BOOST_AUTO_TEST_CASE(sumRecordsAccuracy_test) {
+
+  // 0.1 is not representable: the naive summation drifts by about 1e-6 over a million values
+  const size_t     records_number = 1000000;
+  VectorDataSource data_source(std::vector<double>(records_number, 0.1));
+
+  Elements::Examples::DataSourceUser user{};
+  double                             result = user.sumRecords(data_source);
+
+  BOOST_CHECK_CLOSE(result, 100000., 1e-12);
+}
+
 // Ends the test suite
 BOOST_AUTO_TEST_SUITE_END()
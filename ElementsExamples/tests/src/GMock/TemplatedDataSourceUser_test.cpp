@@ -18,14 +18,52 @@
 
 #include "ElementsExamples/TemplatedDataSourceUser.h"  // Access the objects you want to test
 
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
 #include "ElementsKernel/EnableGMock.h"  // initialize the gmock framework
 #include "ElementsKernel/Real.h"         // isEqual
 
 #include "DataSourceUserTemplatedTypeMock.h"  // Access the needed mock objects.
 
 using Elements::Examples::DataSourceUserTemplatedTypeMock;
+using std::size_t;
 using testing::Return;
 
+namespace {
+
+/// A DataSource holding its records in memory, which fails on a given record
+struct VectorDataSource {
+  std::vector<double> records;
+  size_t              failing_index;
+
+  size_t countRecords() const {
+    return records.size();
+  }
+
+  double getRecordValue(size_t index) const {
+    if (index == failing_index) {
+      throw std::runtime_error("Unreadable record");
+    }
+    return records[index];
+  }
+};
+
+VectorDataSource randomDataSource(size_t records_number) {
+  std::mt19937_64                        generator{0};
+  std::uniform_real_distribution<double> exponent(-10., 10.);
+  VectorDataSource                       data_source{std::vector<double>(records_number), records_number};
+  for (auto& record : data_source.records) {
+    record = std::pow(10., exponent(generator)) * (generator() % 2 == 0 ? 1. : -1.);
+  }
+  return data_source;
+}
+
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(TemplatedDataSourceUser_test_suite)
 
 BOOST_AUTO_TEST_CASE(sumRecords_test) {
@@ -43,5 +81,41 @@ BOOST_AUTO_TEST_CASE(sumRecords_test) {
   BOOST_CHECK_MESSAGE(Elements::isEqual(result, 15.), "Expected value :" << 15 << " Actual value :" << result);
 }
 
+BOOST_AUTO_TEST_CASE(sumRecordsIsDeterministic_test) {
+
+  const auto data_source = randomDataSource(10 * Elements::Examples::TemplatedDataSourceUser::chunk_size + 17);
+
+  Elements::Examples::TemplatedDataSourceUser user{};
+  const double reference = user.sumRecords(data_source, 1);
+  for (size_t thread_count : {2, 3, 8, 64}) {
+    // the results are compared bit for bit
+    BOOST_CHECK_EQUAL(user.sumRecords(data_source, thread_count), reference);
+  }
+  BOOST_CHECK_EQUAL(user.sumRecords(data_source), reference);
+}
+
+BOOST_AUTO_TEST_CASE(sumRecordsPolicies_test) {
+
+  // 0.1 is not representable: the naive summation drifts by about 1e-6 over a million values
+  const VectorDataSource data_source{std::vector<double>(1000000, 0.1), 1000000};
+
+  Elements::Examples::TemplatedDataSourceUser user{};
+  using Elements::Examples::KahanSummation;
+  using Elements::Examples::NaiveSummation;
+  using Elements::Examples::PairwiseSummation;
+  BOOST_CHECK_CLOSE((user.sumRecords<VectorDataSource, PairwiseSummation>(data_source, 4)), 100000., 1e-12);
+  BOOST_CHECK_CLOSE((user.sumRecords<VectorDataSource, KahanSummation>(data_source, 4)), 100000., 1e-12);
+  BOOST_CHECK_CLOSE((user.sumRecords<VectorDataSource, NaiveSummation>(data_source, 4)), 100000., 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(sumRecordsFailure_test) {
+
+  auto data_source          = randomDataSource(10 * Elements::Examples::TemplatedDataSourceUser::chunk_size);
+  data_source.failing_index = 5 * Elements::Examples::TemplatedDataSourceUser::chunk_size + 3;
+
+  Elements::Examples::TemplatedDataSourceUser user{};
+  BOOST_CHECK_THROW(user.sumRecords(data_source, 4), std::runtime_error);
+}
+
 // Ends the test suite
 BOOST_AUTO_TEST_SUITE_END()
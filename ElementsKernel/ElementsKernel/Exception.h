@@ -26,14 +26,12 @@
 #ifndef ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTION_H_
 #define ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTION_H_
 
-#include <cstddef>  // for size_t
-#include <cstdio>
 #include <exception>
-#include <sstream>
 #include <string>
 #include <type_traits>
 #include <utility>
 
+#include "ElementsKernel/ExceptionMessage.h"  // for ExceptionMessage
 #include "ElementsKernel/Exit.h"
 #include "ElementsKernel/Export.h"  // for ELEMENTS_API
 
@@ -73,17 +71,19 @@ public:
 
   /**
    * @brief Constructs a new Exception with a message using format specifiers
+   * @details
+   * The message is formatted in a single pass when it fits in the inline
+   * buffer of an ExceptionMessage, and then copied once to m_error_msg.
    *
    * @param stringFormat The message containing the format specifiers
    * @param args The values to replace the format specifiers with
    */
   template <typename... Args>
-  explicit Exception(const char* stringFormat, Args&&... args) : m_exit_code{ExitCodeHelper<Args...>{args...}.code} {
-    std::size_t len     = snprintf(nullptr, 0, stringFormat, std::forward<Args>(args)...) + 1;
-    char*       message = new char[len];
-    snprintf(message, len, stringFormat, std::forward<Args>(args)...);
-    m_error_msg = std::string(message);
-    delete[] message;
+  explicit Exception(const char* stringFormat, Args&&... args)
+      : m_exit_code{ExitCodeHelper<Args...>{args...}.code} {
+    ExceptionMessage text{};
+    text.appendFormat(stringFormat, args...);
+    m_error_msg.assign(text.c_str(), text.size());
   }
 
   /** Virtual destructor.
@@ -111,14 +111,23 @@ public:
    * @brief Appends in the end of the exception message the parameter
    * @details
    * The passed parameters can be of any type the &lt;&lt; operator of the
-   * std::stringstream can handle.
+   * std::stringstream can handle. The strings and the arithmetic types are
+   * appended in place, without intermediate stream.
    * @param message The message to append
    */
   template <typename T>
   void appendMessage(const T& message) {
-    std::stringstream new_message;
-    new_message << m_error_msg << message;
-    m_error_msg = new_message.str();
+    ExceptionMessage text{};
+    text.append(message);
+    m_error_msg.append(text.c_str(), text.size());
+  }
+
+  void appendMessage(const std::string& message) {
+    m_error_msg.append(message);
+  }
+
+  void appendMessage(const char* message) {
+    m_error_msg.append(message);
   }
 
 protected:
@@ -0,0 +1,104 @@
+/**
+ * @file ElementsKernel/ExceptionMessage.h
+ * @brief defines the message storage of the Elements exceptions
+ *
+ * @copyright 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General
+ * Public License as published by the Free Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with this library; if not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsKernel ElementsKernel
+ * @{
+ */
+
+#ifndef ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTIONMESSAGE_H_
+#define ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTIONMESSAGE_H_
+
+#include <cstddef>      // for size_t
+#include <memory>       // for unique_ptr
+#include <string>       // for string
+#include <type_traits>  // for true_type, false_type
+
+#include "ElementsKernel/Export.h"  // for ELEMENTS_API
+
+namespace Elements {
+
+/**
+ * @class ExceptionMessage
+ * @brief
+ *   Character string with an inline storage for short messages
+ * @details
+ *   The messages up to INLINE_CAPACITY - 1 characters do not allocate. Above,
+ *   the capacity is doubled at each growth and the appends are amortized O(1).
+ *   None of the operations throws: if the memory cannot be allocated, the
+ *   message is truncated.
+ */
+class ELEMENTS_API ExceptionMessage {
+public:
+  static constexpr std::size_t INLINE_CAPACITY = 128;
+
+  ExceptionMessage() noexcept;
+  explicit ExceptionMessage(const char* text) noexcept;
+  explicit ExceptionMessage(const std::string& text) noexcept;
+  ExceptionMessage(const ExceptionMessage& other) noexcept;
+  ExceptionMessage(ExceptionMessage&& other) noexcept;
+  ExceptionMessage& operator=(const ExceptionMessage& other) noexcept;
+  ExceptionMessage& operator=(ExceptionMessage&& other) noexcept;
+  ExceptionMessage& operator=(const std::string& text) noexcept;
+  ExceptionMessage& operator=(const char* text) noexcept;
+  ~ExceptionMessage() = default;
+
+  const char* c_str() const noexcept;
+  std::size_t size() const noexcept;
+  std::size_t capacity() const noexcept;
+  bool        empty() const noexcept;
+  std::string str() const;
+  void        clear() noexcept;
+
+  void append(const char* text, std::size_t length) noexcept;
+  void append(const char* text) noexcept;
+  void append(const std::string& text) noexcept;
+  void append(char c) noexcept;
+
+  /// append the arithmetic values directly, and the other types through a std::ostringstream
+  template <typename T>
+  void append(const T& value);
+
+  /// append the printf-like formatting of the arguments, in a single pass when it fits
+  template <typename... Args>
+  void appendFormat(const char* format, const Args&... args) noexcept;
+
+private:
+  char* data() noexcept;
+  bool  reserve(std::size_t capacity) noexcept;
+
+  template <typename T>
+  void appendValue(const T& value, std::true_type is_arithmetic);
+  template <typename T>
+  void appendValue(const T& value, std::false_type is_arithmetic);
+
+  std::unique_ptr<char[]> m_heap{};
+  std::size_t             m_size{0};
+  std::size_t             m_capacity{INLINE_CAPACITY};
+  char                    m_inline[INLINE_CAPACITY];
+};
+
+}  // namespace Elements
+
+#define ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTIONMESSAGE_IMPL_
+#include "ElementsKernel/_impl/ExceptionMessage.icpp"
+#undef ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTIONMESSAGE_IMPL_
+
+#endif  // ELEMENTSKERNEL_ELEMENTSKERNEL_EXCEPTIONMESSAGE_H_
+
+/**@}*/
@@ -27,7 +27,9 @@
 #define ELEMENTSKERNEL_ELEMENTSKERNEL_NUMBER_H_
 
 #include <cmath>        // for round
+#include <cstddef>      // for size_t
 #include <type_traits>  // for is_floating_point, is_integral
+#include <vector>       // for vector
 
 #include "ElementsKernel/Export.h"  // ELEMENTS_API
 
@@ -60,8 +62,70 @@ ELEMENTS_API TargetType numberCast(const SourceType& s) {
   return t;
 }
 
+/**
+ * @brief
+ *   Treatment of the values that do not fit in the target type of a bulk numberCast
+ * @ingroup ElementsKernel
+ */
+enum class RangePolicy {
+  Unchecked,  ///< same behaviour as the scalar numberCast: the result is undefined
+  Saturate    ///< the value is clamped to the closest limit of the target type
+};
+
+/**
+ * @brief
+ *   Treatment of the NaN values found by a bulk numberCast
+ * @ingroup ElementsKernel
+ */
+enum class NanPolicy {
+  Unchecked,  ///< no check: the result is undefined for an integral target type
+  Zero,       ///< a NaN is converted to 0
+  Throw       ///< an Elements::Exception is thrown before anything is converted
+};
+
+/**
+ * @brief
+ *   bulk version of the number cast. It converts a contiguous array of
+ *   numbers with the same rounding as the scalar numberCast.
+ * @details
+ *   The conversion kernel is selected at compile time from the (TargetType, SourceType)
+ *   pair. The loops are branch-free so that the compiler can turn them into SIMD
+ *   round-and-convert instructions.
+ * @ingroup ElementsKernel
+ * @tparam range_policy
+ *   treatment of the out of range values
+ * @tparam nan_policy
+ *   treatment of the NaN values
+ * @param source
+ *   pointer to the first number to cast
+ * @param size
+ *   number of elements to cast
+ * @param target
+ *   pointer to the first element of the output array. It must hold at least size elements.
+ */
+template <typename TargetType, RangePolicy range_policy = RangePolicy::Unchecked,
+          NanPolicy nan_policy = NanPolicy::Unchecked, typename SourceType>
+ELEMENTS_API void numberCast(const SourceType* source, std::size_t size, TargetType* target);
+
+/**
+ * @brief
+ *   bulk version of the number cast for a whole vector
+ * @ingroup ElementsKernel
+ * @param source
+ *   numbers to cast
+ * @return
+ *   vector of casted numbers
+ */
+template <typename TargetType, RangePolicy range_policy = RangePolicy::Unchecked,
+          NanPolicy nan_policy = NanPolicy::Unchecked, typename SourceType>
+ELEMENTS_API std::vector<TargetType> numberCast(const std::vector<SourceType>& source);
+
 }  // namespace Elements
 
+#define ELEMENTSKERNEL_ELEMENTSKERNEL_NUMBER_IMPL_
+#include "ElementsKernel/_impl/Number.icpp"
+#undef ELEMENTSKERNEL_ELEMENTSKERNEL_NUMBER_IMPL_
+
 #endif  // ELEMENTSKERNEL_ELEMENTSKERNEL_NUMBER_H_
 
 /**@}*/
@@ -22,6 +22,7 @@
 #ifndef ELEMENTSKERNEL_ELEMENTSKERNEL_SLEEP_H_
 #define ELEMENTSKERNEL_ELEMENTSKERNEL_SLEEP_H_
 
+#include <chrono>  // for steady_clock
 #include <cstdint>
 
 #include "ElementsKernel/Export.h"  // ELEMENTS_API
@@ -34,6 +35,64 @@ ELEMENTS_API void normalSleep(int sec);
 /// Small variation on the sleep function for nanoseconds sleep.
 ELEMENTS_API void nanoSleep(std::int64_t nsec);
 
+/**
+ * @brief
+ *   Hybrid sleep for microsecond precision
+ * @details
+ *   The thread sleeps until shortly before the deadline and then spins for
+ *   the remaining time. The spinning margin is the wakeup latency of the
+ *   system, measured once at the first call.
+ */
+ELEMENTS_API void preciseSleep(std::int64_t nsec);
+
+/// Hybrid sleep until an absolute deadline of the steady clock
+ELEMENTS_API void preciseSleepUntil(const std::chrono::steady_clock::time_point& deadline);
+
+/// Wakeup latency of the system sleep in nanoseconds, used as spinning margin by preciseSleep
+ELEMENTS_API std::int64_t sleepLatency();
+
+/**
+ * @class PeriodicTicker
+ * @brief
+ *   Drift-free periodic timer
+ * @details
+ *   The ticks are computed from the start time and not from the previous
+ *   wakeup: the lateness of one tick is not carried over to the next ones.
+ *   The sleeps use absolute deadlines of the monotonic clock.
+ */
+class ELEMENTS_API PeriodicTicker {
+public:
+  /**
+   * @param period_nsec
+   *   the period in nanoseconds
+   * @param precise
+   *   use the hybrid sleep for each tick instead of the sole system sleep
+   * @throw Elements::Exception
+   *   if the period is not positive
+   */
+  explicit PeriodicTicker(std::int64_t period_nsec, bool precise = false);
+
+  /**
+   * @brief
+   *   Wait for the next tick
+   * @return
+   *   the number of ticks that have been missed because the caller was late.
+   *   They are skipped and the ticker keeps its phase.
+   */
+  std::int64_t wait();
+
+  /// number of ticks since the creation, missed ones included
+  std::int64_t ticks() const;
+
+  std::int64_t period() const;
+
+private:
+  const std::int64_t m_period;
+  const bool         m_precise;
+  std::int64_t       m_start;
+  std::int64_t       m_ticks{0};
+};
+
 }  // namespace Elements
 
 #endif  // ELEMENTSKERNEL_ELEMENTSKERNEL_SLEEP_H_
@@ -26,9 +26,11 @@
 #ifndef ELEMENTSKERNEL_ELEMENTSKERNEL_STORAGE_H_
 #define ELEMENTSKERNEL_ELEMENTSKERNEL_STORAGE_H_
 
-#include <cstdint>  // for int64_t
-#include <map>      // for map
-#include <string>   // for string
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int64_t
+#include <map>          // for map
+#include <string>       // for string
+#include <type_traits>  // for enable_if
 
 #include "ElementsKernel/Export.h"
 
@@ -53,6 +55,112 @@ enum class StorageType {
 ELEMENTS_API extern std::map<StorageType, std::string>  StorageShortName;
 ELEMENTS_API extern std::map<StorageType, std::int64_t> StorageFactor;
 
+/**
+ * @brief compile-time version of the StorageFactor map
+ * @param unit
+ *   storage unit
+ * @return
+ *   number of bytes in one unit
+ */
+constexpr std::int64_t storageFactor(StorageType unit);
+
+/**
+ * @brief number of decimal digits needed to express a value in bytes with the given unit
+ * @details
+ *   this is the integral part of the log10 of the storage factor
+ */
+constexpr std::size_t storageDigits(StorageType unit);
+
+/**
+ * @class StorageSize
+ * @brief zero-cost storage quantity with the unit encoded in the type
+ * @details
+ *   The value is an integral number of units held in a std::int64_t. All the
+ *   operations are constexpr and the arithmetic is checked: an overflow throws
+ *   an Elements::Exception at run time and is a compilation error in a constant
+ *   expression. The implicit conversion to a finer unit is exact. The conversion
+ *   to a coarser unit must be explicit with storageCast.
+ * @tparam Unit
+ *   storage unit of the quantity
+ */
+template <StorageType Unit>
+class ELEMENTS_API StorageSize {
+
+public:
+  constexpr StorageSize() = default;
+
+  explicit constexpr StorageSize(std::int64_t value);
+
+  /// implicit and exact conversion from a coarser unit
+  template <StorageType OtherUnit, typename = typename std::enable_if<
+                                       (storageFactor(OtherUnit) % storageFactor(Unit) == 0)>::type>
+  constexpr StorageSize(const StorageSize<OtherUnit>& other);  // NOLINT
+
+  static constexpr StorageType unit();
+
+  /// number of units
+  constexpr std::int64_t value() const;
+
+  /// number of bytes
+  constexpr std::int64_t bytes() const;
+
+  constexpr StorageSize& operator+=(const StorageSize& other);
+  constexpr StorageSize& operator-=(const StorageSize& other);
+  constexpr StorageSize& operator*=(std::int64_t factor);
+  constexpr StorageSize& operator/=(std::int64_t divisor);
+
+private:
+  /// largest number of units which can be expressed in bytes
+  static constexpr std::int64_t maxValue();
+
+  static constexpr std::int64_t checkRange(std::int64_t value);
+
+  std::int64_t m_value{0};
+};
+
+using Bytes           = StorageSize<StorageType::Byte>;
+using KiloBytes       = StorageSize<StorageType::KiloByte>;
+using MegaBytes       = StorageSize<StorageType::MegaByte>;
+using GigaBytes       = StorageSize<StorageType::GigaByte>;
+using TeraBytes       = StorageSize<StorageType::TeraByte>;
+using PetaBytes       = StorageSize<StorageType::PetaByte>;
+using MetricKiloBytes = StorageSize<StorageType::MetricKiloByte>;
+using MetricMegaBytes = StorageSize<StorageType::MetricMegaByte>;
+using MetricGigaBytes = StorageSize<StorageType::MetricGigaByte>;
+using MetricTeraBytes = StorageSize<StorageType::MetricTeraByte>;
+using MetricPetaBytes = StorageSize<StorageType::MetricPetaByte>;
+
+/**
+ * @brief conversion of a storage quantity to any other unit
+ * @details
+ *   the result is rounded to the closest integral number of target units
+ */
+template <StorageType TargetUnit, StorageType SourceUnit>
+constexpr StorageSize<TargetUnit> storageCast(const StorageSize<SourceUnit>& size);
+
+template <StorageType Unit>
+constexpr StorageSize<Unit> operator+(StorageSize<Unit> lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr StorageSize<Unit> operator-(StorageSize<Unit> lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr StorageSize<Unit> operator*(StorageSize<Unit> lhs, std::int64_t factor);
+template <StorageType Unit>
+constexpr StorageSize<Unit> operator*(std::int64_t factor, StorageSize<Unit> rhs);
+template <StorageType Unit>
+constexpr StorageSize<Unit> operator/(StorageSize<Unit> lhs, std::int64_t divisor);
+template <StorageType Unit>
+constexpr bool operator==(const StorageSize<Unit>& lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr bool operator!=(const StorageSize<Unit>& lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr bool operator<(const StorageSize<Unit>& lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr bool operator<=(const StorageSize<Unit>& lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr bool operator>(const StorageSize<Unit>& lhs, const StorageSize<Unit>& rhs);
+template <StorageType Unit>
+constexpr bool operator>=(const StorageSize<Unit>& lhs, const StorageSize<Unit>& rhs);
+
 template <typename T>
 ELEMENTS_API T roundToDigits(const T& value, const std::size_t& max_digits);
 // explicit instantiation:
@@ -26,7 +26,13 @@
 #ifndef ELEMENTSKERNEL_ELEMENTSKERNEL_TEMPORARY_H_
 #define ELEMENTSKERNEL_ELEMENTSKERNEL_TEMPORARY_H_
 
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uintmax_t
+#include <deque>               // for deque
+#include <mutex>               // for mutex
 #include <string>
+#include <thread>  // for thread
 
 #include "ElementsKernel/Environment.h"  // for Environment
 #include "ElementsKernel/Export.h"       // ELEMENTS_API
@@ -38,6 +44,12 @@ namespace Elements {
 const std::string DEFAULT_TMP_KEEP_VAR{"KEEPTEMPDIR"};
 /// The default random creation motif
 const std::string DEFAULT_TMP_MOTIF{"%%%%-%%%%-%%%%-%%%%"};
+/// The default environment variable name of the fast scratch directory
+const std::string DEFAULT_TMP_FAST_VAR{"FASTTEMPDIR"};
+/// The RAM-backed directory used as fast scratch when available
+const std::string DEFAULT_TMP_RAM_DIR{"/dev/shm"};
+
+class TempArea;
 
 class ELEMENTS_API TempPath {
 public:
@@ -46,24 +58,176 @@ public:
   Path::Item  path() const;
   std::string motif() const;
 
+protected:
+  /// Path provided by a temporary area. The area takes care of its removal.
+  TempPath(TempArea& area, const Path::Item& path, const std::string& motif, const std::string& keep_var);
+
 private:
   const std::string m_motif;
   Path::Item        m_path;
   const std::string m_keep_var;
+  TempArea*         m_area{nullptr};
 };
 
 class ELEMENTS_API TempDir : public TempPath {
 public:
   explicit TempDir(const std::string& motif = DEFAULT_TMP_MOTIF, const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
+  /// Directory taken from the pool of the temporary area
+  explicit TempDir(TempArea& area, const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
   virtual ~TempDir();
 };
 
 class ELEMENTS_API TempFile : public TempPath {
 public:
   explicit TempFile(const std::string& motif = DEFAULT_TMP_MOTIF, const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
+  /// File created at the root of the temporary area
+  explicit TempFile(TempArea& area, const std::string& motif = DEFAULT_TMP_MOTIF,
+                    const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
   virtual ~TempFile();
 };
 
+/// Options of the memory mapping of a TempMappedFile
+struct ELEMENTS_API TempMapping {
+  /// pre-fault the whole mapping at creation (MAP_POPULATE)
+  bool populate{false};
+  /// advise the kernel to back the mapping with huge pages (MADV_HUGEPAGE)
+  bool huge_pages{false};
+};
+
+/**
+ * @class TempMappedFile
+ * @brief
+ *   Temporary file of a fixed size, preallocated and mapped in memory
+ * @details
+ *   The whole size is reserved on the filesystem at creation, so that writing
+ *   into the mapping cannot fail later because of a full disk. The mapping is
+ *   shared: with KEEPTEMPDIR set, the content is left in the file.
+ */
+class ELEMENTS_API TempMappedFile : public TempFile {
+public:
+  explicit TempMappedFile(std::size_t size, const TempMapping& mapping = TempMapping{},
+                          const std::string& motif    = DEFAULT_TMP_MOTIF,
+                          const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
+  TempMappedFile(TempArea& area, std::size_t size, const TempMapping& mapping = TempMapping{},
+                 const std::string& motif = DEFAULT_TMP_MOTIF, const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
+  TempMappedFile(const TempMappedFile&) = delete;
+  TempMappedFile& operator=(const TempMappedFile&) = delete;
+  virtual ~TempMappedFile();
+
+  /// size of the file and of the mapping in bytes
+  std::size_t size() const;
+  void*       data();
+  const void* data() const;
+  /// flush the mapping to the file
+  void sync();
+
+private:
+  void map(const TempMapping& mapping);
+
+  std::size_t m_size;
+  int         m_fd{-1};
+  void*       m_data{nullptr};
+};
+
+/**
+ * @class TempArray
+ * @brief
+ *   Typed view of a TempMappedFile holding size elements of type T
+ */
+template <typename T>
+class TempArray : public TempMappedFile {
+public:
+  explicit TempArray(std::size_t size, const TempMapping& mapping = TempMapping{},
+                     const std::string& motif = DEFAULT_TMP_MOTIF, const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
+  TempArray(TempArea& area, std::size_t size, const TempMapping& mapping = TempMapping{},
+            const std::string& motif = DEFAULT_TMP_MOTIF, const std::string& keep_var = DEFAULT_TMP_KEEP_VAR);
+
+  /// number of elements
+  std::size_t size() const;
+  T*          data();
+  const T*    data() const;
+  T*          begin();
+  T*          end();
+  const T*    begin() const;
+  const T*    end() const;
+  T&          operator[](std::size_t index);
+  const T&    operator[](std::size_t index) const;
+};
+
+/// Occupation of a temporary area
+struct ELEMENTS_API TempUsage {
+  /// size of the regular files of the area
+  std::uintmax_t bytes{0};
+  /// number of files and directories of the area
+  std::uintmax_t inodes{0};
+  /// space left on the underlying filesystem for a non-privileged user
+  std::uintmax_t available_bytes{0};
+  /// inodes left on the underlying filesystem for a non-privileged user
+  std::uintmax_t available_inodes{0};
+};
+
+/**
+ * @class TempArea
+ * @brief
+ *   Service managing the temporary paths created under a common root
+ * @details
+ *   The area keeps a pool of pre-created empty directories that are handed out
+ *   to the TempDir built from it. The paths released by the TempDir and TempFile
+ *   objects are first renamed, which makes them disappear at once, and are then
+ *   removed by a reaper thread. The pool is refilled by the same thread.
+ *
+ *   The area must outlive the temporary paths created from it. Its destruction
+ *   waits for the pending removals.
+ */
+class ELEMENTS_API TempArea {
+public:
+  /// area rooted at a private directory of the fastest location, removed with the area, without pool
+  TempArea();
+  explicit TempArea(const Path::Item& root, std::size_t pool_size = 0);
+  TempArea(const TempArea&) = delete;
+  TempArea& operator=(const TempArea&) = delete;
+  ~TempArea();
+
+  /**
+   * @brief
+   *   Select the fastest location for temporary data
+   * @details
+   *   The directory pointed by the fast_var environment variable is tried first,
+   *   then the RAM-backed /dev/shm. The first writable one with at least
+   *   required_size available bytes is returned. The default temporary directory
+   *   is the fallback.
+   */
+  static Path::Item fastRoot(std::uintmax_t required_size = 0, const std::string& fast_var = DEFAULT_TMP_FAST_VAR);
+
+  Path::Item  root() const;
+  std::size_t poolSize() const;
+
+  /// take a directory from the pool, or create one if the pool is empty
+  Path::Item acquireDirectory();
+  /// hand a path over to the reaper thread
+  void release(const Path::Item& path);
+  /// block until the reaper has no pending removal and the pool is full
+  void waitForReaper();
+  /// compute the occupation of the area, including the paths not yet reaped
+  TempUsage usage() const;
+
+private:
+  void       reap();
+  Path::Item createDirectory() const;
+
+  const Path::Item        m_root;
+  std::size_t             m_pool_size;
+  bool                    m_owns_root{false};
+  std::deque<Path::Item>  m_pool;
+  std::deque<Path::Item>  m_trash;
+  bool                    m_busy{false};
+  bool                    m_stop{false};
+  mutable std::mutex      m_mutex;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_idle;
+  std::thread             m_reaper;
+};
+
 using TempEnv = Environment;
 
 /** @example ElementsKernel/tests/src/Configuration_test.cpp
@@ -72,6 +236,10 @@ using TempEnv = Environment;
 
 }  // namespace Elements
 
+#define ELEMENTSKERNEL_ELEMENTSKERNEL_TEMPORARY_IMPL_
+#include "ElementsKernel/_impl/Temporary.icpp"
+#undef ELEMENTSKERNEL_ELEMENTSKERNEL_TEMPORARY_IMPL_
+
 #endif  // ELEMENTSKERNEL_ELEMENTSKERNEL_TEMPORARY_H_
 
 /**@}*/
@@ -18,14 +18,88 @@
 
 #include "ElementsKernel/Sleep.h"
 
-#include <chrono>   // for chrono
-#include <cstdint>  // for int64_t
-#include <thread>   // for this_thread
+#include <time.h>  // for clock_gettime, clock_nanosleep, CLOCK_MONOTONIC, TIMER_ABSTIME
+
+#include <algorithm>  // for nth_element, min, max
+#include <cerrno>     // for EINTR
+#include <chrono>     // for chrono
+#include <cstdint>    // for int64_t
+#include <thread>     // for this_thread
+#include <vector>     // for vector
+
+#include "ElementsKernel/Exception.h"  // for Exception
 
 using std::this_thread::sleep_for;
 
 namespace Elements {
 
+namespace {
+
+constexpr std::int64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+/// bounds of the spinning margin of the hybrid sleep
+constexpr std::int64_t MIN_SLEEP_LATENCY = 10000;
+constexpr std::int64_t MAX_SLEEP_LATENCY = 1000000;
+
+std::int64_t monotonicNow() {
+  timespec now;
+  ::clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<std::int64_t>(now.tv_sec) * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+void sleepUntilMonotonic(std::int64_t deadline) {
+  timespec target;
+  target.tv_sec  = static_cast<time_t>(deadline / NANOSECONDS_PER_SECOND);
+  target.tv_nsec = static_cast<long>(deadline % NANOSECONDS_PER_SECOND);
+  while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+  }
+}
+
+/// hint to the CPU that this is a busy-wait loop
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/// The clock is read through the vDSO: it is a scaled read of the TSC, without system call.
+void spinUntilMonotonic(std::int64_t deadline) {
+  while (monotonicNow() < deadline) {
+    cpuRelax();
+  }
+}
+
+void hybridSleepUntilMonotonic(std::int64_t deadline) {
+  const std::int64_t coarse_deadline = deadline - sleepLatency();
+  if (coarse_deadline > monotonicNow()) {
+    sleepUntilMonotonic(coarse_deadline);
+  }
+  spinUntilMonotonic(deadline);
+}
+
+/// twice the median oversleep of a few short sleeps
+std::int64_t calibrateSleepLatency() {
+
+  constexpr std::size_t  samples = 11;
+  constexpr std::int64_t request = 50000;
+
+  std::vector<std::int64_t> oversleeps(samples);
+  for (auto& oversleep : oversleeps) {
+    const std::int64_t start = monotonicNow();
+    sleepUntilMonotonic(start + request);
+    oversleep = monotonicNow() - start - request;
+  }
+
+  auto median = oversleeps.begin() + samples / 2;
+  std::nth_element(oversleeps.begin(), median, oversleeps.end());
+
+  return std::min(std::max(2 * *median, MIN_SLEEP_LATENCY), MAX_SLEEP_LATENCY);
+}
+
+}  // namespace
+
 /** @brief Small variation on the sleep function for seconds sleep.
  * @author Hubert Degaudenzi
  */
@@ -40,4 +114,58 @@ void nanoSleep(std::int64_t nsec) {
   sleep_for(std::chrono::nanoseconds(nsec));
 }
 
+std::int64_t sleepLatency() {
+  static const std::int64_t latency = calibrateSleepLatency();
+  return latency;
+}
+
+void preciseSleep(std::int64_t nsec) {
+  hybridSleepUntilMonotonic(monotonicNow() + nsec);
+}
+
+void preciseSleepUntil(const std::chrono::steady_clock::time_point& deadline) {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  const auto remaining = duration_cast<nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+  hybridSleepUntilMonotonic(monotonicNow() + static_cast<std::int64_t>(remaining));
+}
+
+PeriodicTicker::PeriodicTicker(std::int64_t period_nsec, bool precise)
+    : m_period(period_nsec), m_precise(precise), m_start(monotonicNow()) {
+  if (m_period <= 0) {
+    throw Exception("The period of a PeriodicTicker must be positive: %lld", static_cast<long long>(period_nsec));
+  }
+}
+
+std::int64_t PeriodicTicker::wait() {
+
+  ++m_ticks;
+
+  const std::int64_t deadline = m_start + m_ticks * m_period;
+  const std::int64_t now      = monotonicNow();
+
+  if (now >= deadline) {
+    // late: return at once and skip the ticks that are entirely past
+    const std::int64_t missed = (now - deadline) / m_period;
+    m_ticks += missed;
+    return missed;
+  }
+
+  if (m_precise) {
+    hybridSleepUntilMonotonic(deadline);
+  } else {
+    sleepUntilMonotonic(deadline);
+  }
+
+  return 0;
+}
+
+std::int64_t PeriodicTicker::ticks() const {
+  return m_ticks;
+}
+
+std::int64_t PeriodicTicker::period() const {
+  return m_period;
+}
+
 }  // namespace Elements
@@ -20,7 +20,6 @@
 
 #include "ElementsKernel/Storage.h"
 
-#include <cmath>    // for pow, round, log10
 #include <cstddef>  // for size_t
 #include <cstdint>  // for int64_t
 #include <map>      // for map
@@ -28,7 +27,6 @@
 
 using std::int64_t;
 using std::map;
-using std::pow;
 using std::size_t;
 
 namespace Elements {
@@ -47,17 +45,17 @@ map<StorageType, std::string> StorageShortName{{StorageType::Byte, "B"},
                                                {StorageType::MetricTeraByte, "TB"},
                                                {StorageType::MetricPetaByte, "PB"}};
 
-map<StorageType, int64_t> StorageFactor{{StorageType::Byte, 1},
-                                        {StorageType::KiloByte, pow(2, 10)},
-                                        {StorageType::MegaByte, pow(2, 20)},
-                                        {StorageType::GigaByte, pow(2, 30)},
-                                        {StorageType::TeraByte, pow(2, 40)},
-                                        {StorageType::PetaByte, pow(2, 50)},
-                                        {StorageType::MetricKiloByte, pow(10, 3)},
-                                        {StorageType::MetricMegaByte, pow(10, 6)},
-                                        {StorageType::MetricGigaByte, pow(10, 9)},
-                                        {StorageType::MetricTeraByte, pow(10, 12)},
-                                        {StorageType::MetricPetaByte, pow(10, 15)}};
+map<StorageType, int64_t> StorageFactor{{StorageType::Byte, storageFactor(StorageType::Byte)},
+                                        {StorageType::KiloByte, storageFactor(StorageType::KiloByte)},
+                                        {StorageType::MegaByte, storageFactor(StorageType::MegaByte)},
+                                        {StorageType::GigaByte, storageFactor(StorageType::GigaByte)},
+                                        {StorageType::TeraByte, storageFactor(StorageType::TeraByte)},
+                                        {StorageType::PetaByte, storageFactor(StorageType::PetaByte)},
+                                        {StorageType::MetricKiloByte, storageFactor(StorageType::MetricKiloByte)},
+                                        {StorageType::MetricMegaByte, storageFactor(StorageType::MetricMegaByte)},
+                                        {StorageType::MetricGigaByte, storageFactor(StorageType::MetricGigaByte)},
+                                        {StorageType::MetricTeraByte, storageFactor(StorageType::MetricTeraByte)},
+                                        {StorageType::MetricPetaByte, storageFactor(StorageType::MetricPetaByte)}};
 
 // explicit instantiation: without the template<>. Otherwise this is a template specialization
 template double roundToDigits<double>(const double& value, const size_t& max_digits);
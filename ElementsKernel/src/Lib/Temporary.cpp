@@ -21,54 +21,86 @@
 
 #include "ElementsKernel/Temporary.h"
 
+#include <fcntl.h>        // for open, posix_fallocate, O_RDWR
+#include <sys/mman.h>     // for mmap, munmap, msync, madvise
+#include <sys/statvfs.h>  // for statvfs
+#include <unistd.h>       // for access, close, ftruncate, W_OK
+
+#include <cerrno>   // for EINVAL, EOPNOTSUPP
+#include <cstddef>  // for size_t
+#include <cstring>  // for strerror
+#include <cstdint>  // for uintmax_t
 #include <iostream>
+#include <mutex>  // for unique_lock, lock_guard
 #include <string>
+#include <vector>  // for vector
 
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/system/error_code.hpp>  // for error_code
 
 #include "ElementsKernel/Environment.h"
+#include "ElementsKernel/Exception.h"
 #include "ElementsKernel/Logging.h"
 #include "ElementsKernel/Path.h"
 
 using boost::filesystem::temp_directory_path;
+using boost::system::error_code;
 using std::string;
 
 namespace Elements {
 
 namespace {
 auto log = Logging::getLogger();
-}
 
-TempPath::TempPath(const string& arg_motif, const string& keep_var)
-    : m_motif(arg_motif), m_path(temp_directory_path()), m_keep_var(keep_var) {
+/// The motif of the paths waiting for the reaper thread
+const string TMP_TRASH_MOTIF{".trash-%%%%-%%%%-%%%%-%%%%"};
+
+/// The motif of the private root of a default area, in the shared fast location
+const string TMP_AREA_MOTIF{"elements-area-%%%%-%%%%-%%%%-%%%%"};
+
+Path::Item uniqueName(const string& motif) {
 
   using boost::filesystem::unique_path;
 
-  if (m_motif.find('%') == string::npos) {
-    log.error() << "The '" << m_motif << "' motif is not random";
+  if (motif.find('%') == string::npos) {
+    log.error() << "The '" << motif << "' motif is not random";
   }
 
-  auto pattern = m_motif;
+  auto pattern = motif;
 
   if (pattern.empty()) {
     log.warn() << "The motif has been replaced by \"" << DEFAULT_TMP_MOTIF << "\"";
     pattern = DEFAULT_TMP_MOTIF;
   }
 
-  m_path /= unique_path(pattern);
+  return unique_path(pattern);
 }
 
+}  // namespace
+
+TempPath::TempPath(const string& arg_motif, const string& keep_var)
+    : m_motif(arg_motif), m_path(temp_directory_path()), m_keep_var(keep_var) {
+
+  m_path /= uniqueName(m_motif);
+}
+
+TempPath::TempPath(TempArea& area, const Path::Item& arg_path, const string& arg_motif, const string& keep_var)
+    : m_motif(arg_motif), m_path(arg_path), m_keep_var(keep_var), m_area(&area) {}
+
 TempPath::~TempPath() {
 
   Environment current;
 
-  if (not current.hasKey(m_keep_var)) {
+  if (current.hasKey(m_keep_var)) {
+    log.info() << m_keep_var << " set: I do not remove the " << m_path.string() << " temporary path";
+  } else if (m_area != nullptr) {
+    log.debug() << "Background destruction of the " << path() << " temporary path";
+    m_area->release(m_path);
+  } else {
     log.debug() << "Automatic destruction of the " << path() << " temporary path";
     const auto file_number = boost::filesystem::remove_all(m_path);
     log.debug() << "Number of files removed: " << file_number;
-  } else {
-    log.info() << m_keep_var << " set: I do not remove the " << m_path.string() << " temporary path";
   }
 }
 
@@ -87,6 +119,12 @@ TempDir::TempDir(const string& arg_motif, const string& keep_var) : TempPath(arg
   boost::filesystem::create_directory(path());
 }
 
+TempDir::TempDir(TempArea& area, const string& keep_var)
+    : TempPath(area, area.acquireDirectory(), DEFAULT_TMP_MOTIF, keep_var) {
+
+  log.debug() << "Acquisition of the " << path() << " temporary directory";
+}
+
 TempDir::~TempDir() {}
 
 TempFile::TempFile(const string& arg_motif, const string& keep_var) : TempPath(arg_motif, keep_var) {
@@ -97,6 +135,300 @@ TempFile::TempFile(const string& arg_motif, const string& keep_var) : TempPath(a
   ofs.close();
 }
 
+TempFile::TempFile(TempArea& area, const string& arg_motif, const string& keep_var)
+    : TempPath(area, area.root() / uniqueName(arg_motif), arg_motif, keep_var) {
+
+  log.debug() << "Creation of the " << path() << " temporary file";
+
+  boost::filesystem::ofstream ofs(path());
+  ofs.close();
+}
+
 TempFile::~TempFile() {}
 
+TempMappedFile::TempMappedFile(std::size_t size, const TempMapping& mapping, const string& arg_motif,
+                               const string& keep_var)
+    : TempFile(arg_motif, keep_var), m_size(size) {
+  map(mapping);
+}
+
+TempMappedFile::TempMappedFile(TempArea& area, std::size_t size, const TempMapping& mapping, const string& arg_motif,
+                               const string& keep_var)
+    : TempFile(area, arg_motif, keep_var), m_size(size) {
+  map(mapping);
+}
+
+void TempMappedFile::map(const TempMapping& mapping) {
+
+  m_fd = ::open(path().c_str(), O_RDWR);
+  if (m_fd < 0) {
+    throw Exception("Cannot open the %s temporary file: %s", path().c_str(), std::strerror(errno));
+  }
+
+  // the reservation of the blocks is not supported by every filesystem. The
+  // file is then only extended and its blocks are allocated on first write.
+  const auto length = static_cast<off_t>(m_size);
+  const int  status = ::posix_fallocate(m_fd, 0, length);
+  if (status == EINVAL or status == EOPNOTSUPP) {
+    if (::ftruncate(m_fd, length) != 0) {
+      const int error = errno;
+      ::close(m_fd);
+      throw Exception("Cannot resize the %s temporary file: %s", path().c_str(), std::strerror(error));
+    }
+  } else if (status != 0) {
+    ::close(m_fd);
+    throw Exception("Cannot allocate %zu bytes for the %s temporary file: %s", m_size, path().c_str(),
+                    std::strerror(status));
+  }
+
+  if (m_size == 0) {
+    return;
+  }
+
+  int flags = MAP_SHARED;
+  if (mapping.populate) {
+    flags |= MAP_POPULATE;
+  }
+
+  m_data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, flags, m_fd, 0);
+  if (m_data == MAP_FAILED) {
+    const int error = errno;
+    m_data          = nullptr;
+    ::close(m_fd);
+    throw Exception("Cannot map the %s temporary file: %s", path().c_str(), std::strerror(error));
+  }
+
+  // MAP_HUGETLB is reserved to hugetlbfs: for the other filesystems the huge
+  // pages are only a hint and they are silently ignored where not enabled.
+  if (mapping.huge_pages and ::madvise(m_data, m_size, MADV_HUGEPAGE) != 0) {
+    log.debug() << "No huge pages for the " << path() << " temporary file: " << std::strerror(errno);
+  }
+
+  log.debug() << "Mapping of " << m_size << " bytes of the " << path() << " temporary file";
+}
+
+TempMappedFile::~TempMappedFile() {
+  if (m_data != nullptr) {
+    ::munmap(m_data, m_size);
+  }
+  ::close(m_fd);
+}
+
+std::size_t TempMappedFile::size() const {
+  return m_size;
+}
+
+void* TempMappedFile::data() {
+  return m_data;
+}
+
+const void* TempMappedFile::data() const {
+  return m_data;
+}
+
+void TempMappedFile::sync() {
+  if (m_data != nullptr and ::msync(m_data, m_size, MS_SYNC) != 0) {
+    throw Exception("Cannot synchronize the %s temporary file: %s", path().c_str(), std::strerror(errno));
+  }
+}
+
+TempArea::TempArea() : TempArea(fastRoot() / uniqueName(TMP_AREA_MOTIF)) {
+  m_owns_root = true;
+}
+
+TempArea::TempArea(const Path::Item& root, std::size_t pool_size) : m_root(root), m_pool_size(pool_size) {
+
+  boost::filesystem::create_directories(m_root);
+
+  for (std::size_t i = 0; i < m_pool_size; ++i) {
+    m_pool.push_back(createDirectory());
+  }
+
+  log.debug() << "Creation of the " << m_root << " temporary area with " << m_pool_size << " pooled directories";
+
+  m_reaper = std::thread(&TempArea::reap, this);
+}
+
+TempArea::~TempArea() {
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wakeup.notify_all();
+  m_reaper.join();
+
+  for (const auto& dir : m_pool) {
+    error_code error;
+    boost::filesystem::remove_all(dir, error);
+  }
+
+  // the paths kept on request are in the private root: it is kept with them
+  if (m_owns_root and Environment().hasKey(DEFAULT_TMP_KEEP_VAR)) {
+    log.info() << DEFAULT_TMP_KEEP_VAR << " set: I do not remove the " << m_root << " temporary area";
+  } else if (m_owns_root) {
+    error_code error;
+    boost::filesystem::remove_all(m_root, error);
+    if (error) {
+      log.warn() << "Cannot remove the " << m_root << " temporary area: " << error.message();
+    }
+  }
+}
+
+Path::Item TempArea::fastRoot(std::uintmax_t required_size, const string& fast_var) {
+
+  Environment             current;
+  std::vector<Path::Item> candidates;
+
+  if (current.hasKey(fast_var)) {
+    candidates.emplace_back(current[fast_var].value());
+  }
+  candidates.emplace_back(DEFAULT_TMP_RAM_DIR);
+
+  for (const auto& candidate : candidates) {
+    error_code error;
+    if (boost::filesystem::is_directory(candidate, error) and ::access(candidate.c_str(), W_OK) == 0) {
+      const auto info = boost::filesystem::space(candidate, error);
+      if (not error and info.available >= required_size) {
+        return candidate;
+      }
+    }
+  }
+
+  return temp_directory_path();
+}
+
+Path::Item TempArea::root() const {
+  return m_root;
+}
+
+std::size_t TempArea::poolSize() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pool_size;
+}
+
+Path::Item TempArea::createDirectory() const {
+  const Path::Item dir = m_root / uniqueName(DEFAULT_TMP_MOTIF);
+  boost::filesystem::create_directory(dir);
+  return dir;
+}
+
+Path::Item TempArea::acquireDirectory() {
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (not m_pool.empty()) {
+      const auto dir = m_pool.front();
+      m_pool.pop_front();
+      m_wakeup.notify_one();
+      return dir;
+    }
+  }
+
+  return createDirectory();
+}
+
+void TempArea::release(const Path::Item& path) {
+
+  // the renaming is atomic: the path is gone for the user even if its content
+  // is still waiting for the reaper. It fails if the path is not on the same
+  // filesystem as the area and the path is then removed in place.
+  Path::Item trash = m_root / uniqueName(TMP_TRASH_MOTIF);
+  error_code error;
+  boost::filesystem::rename(path, trash, error);
+  if (error) {
+    trash = path;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_trash.push_back(trash);
+  }
+  m_wakeup.notify_one();
+}
+
+void TempArea::waitForReaper() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle.wait(lock, [this] {
+    return not m_busy and m_trash.empty() and m_pool.size() >= m_pool_size;
+  });
+}
+
+void TempArea::reap() {
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  while (true) {
+
+    m_wakeup.wait(lock, [this] {
+      return m_stop or not m_trash.empty() or m_pool.size() < m_pool_size;
+    });
+
+    // the removals are completed before stopping. The pool is not refilled anymore.
+    if (not m_trash.empty()) {
+      const auto trash = m_trash.front();
+      m_trash.pop_front();
+      m_busy = true;
+      lock.unlock();
+      error_code error;
+      const auto file_number = boost::filesystem::remove_all(trash, error);
+      if (error) {
+        log.warn() << "Cannot remove the " << trash << " temporary path: " << error.message();
+      }
+      log.debug() << "Number of files removed by the reaper: " << file_number;
+      lock.lock();
+      m_busy = false;
+    } else if (not m_stop and m_pool.size() < m_pool_size) {
+      m_busy = true;
+      lock.unlock();
+      error_code error;
+      const Path::Item dir = m_root / uniqueName(DEFAULT_TMP_MOTIF);
+      boost::filesystem::create_directory(dir, error);
+      lock.lock();
+      m_busy = false;
+      if (error) {
+        log.warn() << "Cannot refill the pool of the " << m_root << " temporary area: " << error.message();
+        m_pool_size = m_pool.size();
+      } else {
+        m_pool.push_back(dir);
+      }
+    } else if (m_stop) {
+      break;
+    }
+
+    if (not m_busy and m_trash.empty() and m_pool.size() >= m_pool_size) {
+      m_idle.notify_all();
+    }
+  }
+
+  m_idle.notify_all();
+}
+
+TempUsage TempArea::usage() const {
+
+  using boost::filesystem::recursive_directory_iterator;
+
+  TempUsage result;
+
+  error_code error;
+  for (recursive_directory_iterator it(m_root, error), end; not error and it != end; it.increment(error)) {
+    ++result.inodes;
+    error_code size_error;
+    if (boost::filesystem::is_regular_file(it->symlink_status(size_error))) {
+      const auto size = boost::filesystem::file_size(it->path(), size_error);
+      if (not size_error) {
+        result.bytes += size;
+      }
+    }
+  }
+
+  struct statvfs info;
+  if (::statvfs(m_root.c_str(), &info) == 0) {
+    result.available_bytes  = static_cast<std::uintmax_t>(info.f_bavail) * info.f_frsize;
+    result.available_inodes = static_cast<std::uintmax_t>(info.f_favail);
+  }
+
+  return result;
+}
+
 }  // namespace Elements
@@ -23,7 +23,9 @@
 
 #include "ElementsKernel/Exception.h"
 
+#include <cstddef>  // for size_t
 #include <string>
+#include <utility>  // for move
 
 #include <boost/test/unit_test.hpp>  // for boost unit test macros
 
@@ -116,6 +118,109 @@ BOOST_AUTO_TEST_CASE(SubclassStreamOperator_test) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE(FormatConstructor_test) {
+
+  // the C string arguments do not need to outlive the exception
+  Exception ex{"Cannot open the %s file at line %d (%.2f)", string("data.txt").c_str(), 42, 0.5};
+  Exception copy{ex};
+
+  BOOST_CHECK_EQUAL(ex.what(), "Cannot open the data.txt file at line 42 (0.50)");
+  BOOST_CHECK_EQUAL(copy.what(), ex.what());
+  BOOST_CHECK(ex.exitCode() == ExitCode::NOT_OK);
+
+  Exception usage_ex{"Wrong option %s", "--toto", ExitCode::USAGE};
+  BOOST_CHECK(usage_ex.exitCode() == ExitCode::USAGE);
+  BOOST_CHECK_EQUAL(usage_ex.what(), "Wrong option --toto");
+
+  // an append after a formatted message
+  copy << " at " << 3 << '/' << 4u << ' ' << 1.5;
+  BOOST_CHECK_EQUAL(copy.what(), "Cannot open the data.txt file at line 42 (0.50) at 3/4 1.5");
+  BOOST_CHECK_EQUAL(ex.what(), "Cannot open the data.txt file at line 42 (0.50)");
+}
+
+BOOST_AUTO_TEST_CASE(DerivedMessage_test) {
+
+  // the derived classes still own the std::string message
+  class DerivedException : public Exception {
+  public:
+    DerivedException(const char* name, int line) : Exception("Cannot parse %s at line %d", name, line) {
+      m_error_msg = "Parsing error";
+      m_error_msg += " in " + std::string(name);
+    }
+  };
+
+  DerivedException ex{"data.txt", 42};
+  BOOST_CHECK_EQUAL(ex.what(), "Parsing error in data.txt");
+  ex << " (line " << 42 << ')';
+  BOOST_CHECK_EQUAL(ex.what(), "Parsing error in data.txt (line 42)");
+}
+
+BOOST_AUTO_TEST_CASE(DerivedPrefix_test) {
+
+  // the derived classes can read the formatted message in their constructor
+  class PrefixedException : public Exception {
+  public:
+    PrefixedException(const char* name, int line) : Exception("Cannot parse %s at line %d", name, line) {
+      m_error_msg = "[Parser] " + m_error_msg;
+      m_error_msg += " (skipped)";
+    }
+  };
+
+  PrefixedException ex{"data.txt", 42};
+  BOOST_CHECK_EQUAL(ex.what(), "[Parser] Cannot parse data.txt at line 42 (skipped)");
+  ex << ", " << 3 << " errors";
+  BOOST_CHECK_EQUAL(ex.what(), "[Parser] Cannot parse data.txt at line 42 (skipped), 3 errors");
+}
+
+BOOST_AUTO_TEST_CASE(LongMessage_test) {
+
+  const string long_part(3 * ExceptionMessage::INLINE_CAPACITY, 'x');
+
+  Exception ex{"%s-%s", long_part.c_str(), long_part.c_str()};
+  BOOST_CHECK_EQUAL(ex.what(), long_part + "-" + long_part);
+
+  Exception appended{};
+  string    expected{};
+  for (int i = 0; i < 1000; ++i) {
+    appended << "part " << i << ", ";
+    expected += "part " + std::to_string(i) + ", ";
+  }
+  BOOST_CHECK_EQUAL(appended.what(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionMessage_test) {
+
+  ExceptionMessage message{"short"};
+  BOOST_CHECK_EQUAL(message.size(), 5);
+  BOOST_CHECK_EQUAL(message.capacity(), ExceptionMessage::INLINE_CAPACITY);
+
+  // the capacity doubles: the number of growths is logarithmic
+  std::size_t growths       = 0;
+  std::size_t last_capacity = message.capacity();
+  for (int i = 0; i < 10000; ++i) {
+    message.append(" more text");
+    if (message.capacity() != last_capacity) {
+      ++growths;
+      last_capacity = message.capacity();
+    }
+  }
+  BOOST_CHECK_EQUAL(message.size(), 5 + 10000 * 10);
+  BOOST_CHECK_LE(growths, 10);
+
+  ExceptionMessage moved{std::move(message)};
+  BOOST_CHECK_EQUAL(moved.size(), 5 + 10000 * 10);
+  BOOST_CHECK(message.empty());
+
+  message = "reused";
+  BOOST_CHECK_EQUAL(message.str(), "reused");
+
+  ExceptionMessage characters{};
+  characters.append(static_cast<unsigned char>('a'));
+  characters.append(true);
+  characters.append(-12L);
+  BOOST_CHECK_EQUAL(characters.c_str(), "a1-12");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace Elements
@@ -21,8 +21,18 @@
 
 #include "ElementsKernel/Number.h"
 
+#include <cmath>    // for round
+#include <cstdint>  // for int16_t, int32_t, uint8_t, uint64_t
+#include <limits>   // for numeric_limits
+#include <vector>   // for vector
+
 #include <boost/test/unit_test.hpp>
 
+#include "ElementsKernel/Exception.h"  // for Exception
+
+using std::numeric_limits;
+using std::vector;
+
 namespace Elements {
 
 //-----------------------------------------------------------------------------
@@ -43,6 +53,73 @@ BOOST_AUTO_TEST_CASE(NumberCast_test) {
   BOOST_CHECK_EQUAL(numberCast<int>(3.2), static_cast<int>(3.2));
 }
 
+BOOST_AUTO_TEST_CASE(BulkNumberCast_test) {
+
+  vector<double> source;
+  for (int i = -2000; i < 2000; ++i) {
+    source.push_back(i * 0.25);
+  }
+  source.push_back(0.49999999999999994);
+  source.push_back(-0.49999999999999994);
+  source.push_back(4503599627370495.5);
+
+  const auto target = numberCast<long long>(source);
+  BOOST_REQUIRE_EQUAL(target.size(), source.size());
+  for (std::size_t i = 0; i < source.size(); ++i) {
+    BOOST_CHECK_EQUAL(target[i], numberCast<long long>(source[i]));
+    BOOST_CHECK_EQUAL(target[i], static_cast<long long>(std::round(source[i])));
+  }
+
+  const vector<float> float_source{-2.5F, -1.5F, -0.5F, 0.5F, 1.5F, 2.5F, 0.49999997F};
+  vector<std::int16_t> float_target(float_source.size());
+  numberCast(float_source.data(), float_source.size(), float_target.data());
+  BOOST_CHECK((float_target == vector<std::int16_t>{-3, -2, -1, 1, 2, 3, 0}));
+
+  const auto widened = numberCast<double>(vector<int>{-1, 0, 3});
+  BOOST_CHECK((widened == vector<double>{-1.0, 0.0, 3.0}));
+}
+
+BOOST_AUTO_TEST_CASE(SaturateNumberCast_test) {
+
+  using std::int32_t;
+  using std::uint64_t;
+  using std::uint8_t;
+
+  const vector<double> source{1e300, -1e300, 2147483647.6, -2147483648.4, -2147483648.6, 12.5};
+  const auto           target = numberCast<int32_t, RangePolicy::Saturate>(source);
+  BOOST_CHECK((target == vector<int32_t>{numeric_limits<int32_t>::max(), numeric_limits<int32_t>::min(),
+                                         numeric_limits<int32_t>::max(), numeric_limits<int32_t>::min(),
+                                         numeric_limits<int32_t>::min(), 13}));
+
+  const auto unsigned_target = numberCast<uint64_t, RangePolicy::Saturate>(vector<double>{1e30, -3.0, -0.4});
+  BOOST_CHECK((unsigned_target == vector<uint64_t>{numeric_limits<uint64_t>::max(), 0, 0}));
+
+  const auto byte_target = numberCast<uint8_t, RangePolicy::Saturate>(vector<int>{-5, 300, 7});
+  BOOST_CHECK((byte_target == vector<uint8_t>{0, 255, 7}));
+
+  const auto float_target = numberCast<float, RangePolicy::Saturate>(
+      vector<double>{1e300, -1e300, numeric_limits<double>::infinity()});
+  BOOST_CHECK_EQUAL(float_target[0], numeric_limits<float>::max());
+  BOOST_CHECK_EQUAL(float_target[1], numeric_limits<float>::lowest());
+  BOOST_CHECK_EQUAL(float_target[2], numeric_limits<float>::infinity());
+}
+
+BOOST_AUTO_TEST_CASE(NanNumberCast_test) {
+
+  const vector<double> source{1.6, numeric_limits<double>::quiet_NaN(), -1.6};
+
+  const auto target = numberCast<int, RangePolicy::Saturate, NanPolicy::Zero>(source);
+  BOOST_CHECK((target == vector<int>{2, 0, -2}));
+
+  auto throwing = [&source]() {
+    return numberCast<int, RangePolicy::Unchecked, NanPolicy::Throw>(source);
+  };
+  BOOST_CHECK_THROW(throwing(), Exception);
+
+  const auto no_nan = numberCast<int, RangePolicy::Unchecked, NanPolicy::Throw>(vector<double>{0.4, 0.6});
+  BOOST_CHECK((no_nan == vector<int>{0, 1}));
+}
+
 //-----------------------------------------------------------------------------
 // End of the Boost tests
 BOOST_AUTO_TEST_SUITE_END()
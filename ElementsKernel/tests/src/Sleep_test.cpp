@@ -21,8 +21,17 @@
 
 #include "ElementsKernel/Sleep.h"
 
+#include <algorithm>  // for sort
+#include <chrono>     // for steady_clock, nanoseconds
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int64_t
+#include <string>     // for string
+#include <vector>     // for vector
+
 #include <boost/test/unit_test.hpp>
 
+#include "ElementsKernel/Exception.h"  // for Exception
+
 namespace Elements {
 
 //-----------------------------------------------------------------------------
@@ -40,6 +49,117 @@ BOOST_AUTO_TEST_CASE(SleepCall_test) {
   nanoSleep(10);
 }
 
+namespace {
+
+/// oversleeps in nanoseconds of repeated sleeps of the given duration
+template <typename Sleeper>
+std::vector<std::int64_t> oversleeps(std::int64_t request, std::size_t samples, Sleeper sleeper) {
+
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+
+  std::vector<std::int64_t> result(samples);
+  for (auto& oversleep : result) {
+    const auto start = steady_clock::now();
+    sleeper(request);
+    oversleep = duration_cast<nanoseconds>(steady_clock::now() - start).count() - request;
+  }
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+void reportJitter(const std::string& name, const std::vector<std::int64_t>& sorted) {
+  const auto percentile = [&sorted](std::size_t p) {
+    return sorted[(sorted.size() - 1) * p / 100];
+  };
+  BOOST_TEST_MESSAGE(name << " oversleep (ns): p50=" << percentile(50) << " p90=" << percentile(90)
+                          << " p99=" << percentile(99) << " max=" << sorted.back());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(PreciseSleepJitter_test) {
+
+  constexpr std::int64_t request = 200000;
+  constexpr std::size_t  samples = 200;
+
+  BOOST_TEST_MESSAGE("Sleep latency (ns): " << sleepLatency());
+
+  const auto system_jitter  = oversleeps(request, samples, nanoSleep);
+  const auto precise_jitter = oversleeps(request, samples, preciseSleep);
+
+  reportJitter("nanoSleep", system_jitter);
+  reportJitter("preciseSleep", precise_jitter);
+
+  // never wakes up too early
+  BOOST_CHECK_GE(precise_jitter.front(), 0);
+  // the absolute values depend on the load of the machine: only the comparison is checked
+  BOOST_CHECK_LE(precise_jitter[samples / 2], system_jitter[samples / 2]);
+}
+
+BOOST_AUTO_TEST_CASE(PreciseSleepUntil_test) {
+
+  using std::chrono::steady_clock;
+
+  const auto deadline = steady_clock::now() + std::chrono::microseconds(500);
+  preciseSleepUntil(deadline);
+  BOOST_CHECK(steady_clock::now() >= deadline);
+
+  // a past deadline returns at once
+  preciseSleepUntil(deadline);
+}
+
+BOOST_AUTO_TEST_CASE(PeriodicTicker_test) {
+
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::steady_clock;
+
+  constexpr std::int64_t period = 1000000;
+  constexpr std::int64_t ticks  = 1000;
+  // a single late wakeup on a loaded machine, well below the drift of 1000 relative sleeps
+  constexpr std::int64_t margin = 20 * period;
+
+  PeriodicTicker ticker(period, true);
+  BOOST_CHECK_EQUAL(ticker.period(), period);
+
+  const auto   start  = steady_clock::now();
+  std::int64_t missed = 0;
+  while (ticker.ticks() < ticks) {
+    missed += ticker.wait();
+  }
+  const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+  BOOST_TEST_MESSAGE("PeriodicTicker: " << ticker.ticks() << " ticks in " << elapsed << " ns, " << missed
+                                        << " missed");
+
+  // the ticks are aligned on the start time: the lateness does not accumulate
+  BOOST_CHECK_GE(elapsed, (ticker.ticks() - 1) * period);
+  BOOST_CHECK_LT(elapsed, ticker.ticks() * period + margin);
+}
+
+BOOST_AUTO_TEST_CASE(PeriodicTickerLate_test) {
+
+  // long enough for the oversleep of a loaded machine to stay below half a period
+  constexpr std::int64_t period = 10000000;
+
+  PeriodicTicker ticker(period);
+  nanoSleep(5 * period + period / 2);
+
+  // the first tick is late by 4.5 periods: 4 of them are skipped
+  BOOST_CHECK_EQUAL(ticker.wait(), 4);
+  BOOST_CHECK_EQUAL(ticker.ticks(), 5);
+  BOOST_CHECK_EQUAL(ticker.wait(), 0);
+  BOOST_CHECK_EQUAL(ticker.ticks(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(PeriodicTickerPeriod_test) {
+  BOOST_CHECK_THROW(PeriodicTicker(0), Exception);
+  BOOST_CHECK_THROW(PeriodicTicker(-1000), Exception);
+}
+
 //-----------------------------------------------------------------------------
 // End of the Boost tests
 BOOST_AUTO_TEST_SUITE_END()
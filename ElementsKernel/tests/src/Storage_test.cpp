@@ -23,7 +23,9 @@
 
 #include <boost/test/unit_test.hpp>
 #include <cstdint>
+#include <limits>
 
+#include "ElementsKernel/Exception.h"      // For Exception
 #include "ElementsKernel/MathConstants.h"  // For pi
 #include "ElementsKernel/Real.h"           // For isEqual
 
@@ -159,6 +161,65 @@ BOOST_AUTO_TEST_CASE(StorageConvertMetric_test) {
   BOOST_CHECK_EQUAL(storageConvert<9>(size, StorageType::MetricMegaByte, StorageType::MetricKiloByte), 1000);
 }
 
+BOOST_AUTO_TEST_CASE(StorageFactorConstexpr_test) {
+
+  using Kernel::Units::storageDigits;
+  using Kernel::Units::StorageFactor;
+  using Kernel::Units::storageFactor;
+
+  static_assert(storageFactor(StorageType::MegaByte) == 1048576, "compile-time storage factor");
+  static_assert(storageDigits(StorageType::KiloByte) == 3, "compile-time storage digits");
+
+  for (const auto& item : StorageFactor) {
+    BOOST_CHECK_EQUAL(storageFactor(item.first), item.second);
+  }
+
+  BOOST_CHECK_EQUAL(storageDigits(StorageType::Byte), 0);
+  BOOST_CHECK_EQUAL(storageDigits(StorageType::PetaByte), 15);
+  BOOST_CHECK_EQUAL(storageDigits(StorageType::MetricTeraByte), 12);
+}
+
+BOOST_AUTO_TEST_CASE(StorageSize_test) {
+
+  using Kernel::Units::Bytes;
+  using Kernel::Units::KiloBytes;
+  using Kernel::Units::MegaBytes;
+  using Kernel::Units::storageCast;
+
+  // everything is folded at compile time
+  constexpr MegaBytes buffer{4};
+  constexpr KiloBytes chunk{buffer};
+  constexpr Bytes     total = Bytes{buffer} + Bytes{12};
+  static_assert(chunk.value() == 4096, "exact conversion to a finer unit");
+  static_assert(total.bytes() == 4194316, "mixed unit arithmetic");
+  static_assert(buffer / 4 * 3 == MegaBytes{3}, "scalar arithmetic");
+  static_assert(storageCast<StorageType::MetricKiloByte>(KiloBytes{1}).value() == 1, "rounded conversion");
+
+  BOOST_CHECK_EQUAL(storageCast<KiloBytes::unit()>(Bytes{1536}).value(), 2);
+  BOOST_CHECK_EQUAL(storageCast<StorageType::KiloByte>(Bytes{1535}).value(), 1);
+  BOOST_CHECK_EQUAL(storageCast<StorageType::KiloByte>(Bytes{-1536}).value(), -2);
+  BOOST_CHECK_EQUAL(storageCast<StorageType::MetricKiloByte>(MegaBytes{1}).value(), 1049);
+
+  BOOST_CHECK(KiloBytes{1} < KiloBytes{2});
+  BOOST_CHECK(KiloBytes{3} - KiloBytes{5} == KiloBytes{-2});
+}
+
+BOOST_AUTO_TEST_CASE(StorageSizeOverflow_test) {
+
+  using Kernel::Units::Bytes;
+  using Kernel::Units::PetaBytes;
+
+  const std::int64_t max_petabytes = std::numeric_limits<std::int64_t>::max() / (std::int64_t{1} << 50);
+
+  BOOST_CHECK_NO_THROW(PetaBytes{max_petabytes});
+  BOOST_CHECK_THROW(PetaBytes{max_petabytes + 1}, Exception);
+  BOOST_CHECK_THROW(PetaBytes{max_petabytes} + PetaBytes{1}, Exception);
+  BOOST_CHECK_THROW(PetaBytes{max_petabytes / 2 + 1} * 2, Exception);
+  BOOST_CHECK_THROW(Bytes{std::numeric_limits<std::int64_t>::max()} + Bytes{1}, Exception);
+  BOOST_CHECK_THROW(Bytes{-std::numeric_limits<std::int64_t>::max()} - Bytes{1}, Exception);
+  BOOST_CHECK_THROW(Bytes{1} / 0, Exception);
+}
+
 //-----------------------------------------------------------------------------
 // End of the Boost tests
 BOOST_AUTO_TEST_SUITE_END()
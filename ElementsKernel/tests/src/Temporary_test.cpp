@@ -21,8 +21,12 @@
 
 #include "ElementsKernel/Temporary.h"  // for TempDir
 
+#include <algorithm>  // for fill
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uintmax_t
 #include <cstdlib>
 #include <iostream>
+#include <limits>  // for numeric_limits
 #include <string>  // for string
 #include <vector>
 
@@ -216,6 +220,173 @@ BOOST_AUTO_TEST_CASE(Fake_test) {
   TempPath p2(motif1);
 }
 
+BOOST_FIXTURE_TEST_CASE(TempAreaPool_test, Temporary_Fixture) {
+
+  const Path::Item area_root = m_top_dir.path() / "area";
+  Path::Item       dir_path;
+  Path::Item       file_path;
+
+  {
+    TempArea area(area_root, 2);
+    BOOST_CHECK(exists(area_root));
+    BOOST_CHECK_EQUAL(area.poolSize(), 2);
+    // the 2 pooled directories
+    BOOST_CHECK_EQUAL(area.usage().inodes, 2);
+
+    {
+      TempDir one(area);
+      dir_path = one.path();
+      BOOST_CHECK(exists(dir_path));
+      BOOST_CHECK(dir_path.parent_path() == area_root);
+
+      boost::filesystem::ofstream ofs(dir_path / "toto.txt");
+      ofs << "0123456789";
+      ofs.close();
+
+      TempFile two(area, "toto-%%%%");
+      file_path = two.path();
+      BOOST_CHECK(exists(file_path));
+      BOOST_CHECK(file_path.parent_path() == area_root);
+
+      area.waitForReaper();
+      const auto usage = area.usage();
+      // 2 pooled directories, the acquired one, its file and the temporary file
+      BOOST_CHECK_EQUAL(usage.inodes, 5);
+      BOOST_CHECK_EQUAL(usage.bytes, 10);
+      BOOST_CHECK(usage.available_bytes > 0);
+    }
+
+    // the paths disappear at once even if they are removed in the background
+    BOOST_CHECK(not exists(dir_path));
+    BOOST_CHECK(not exists(file_path));
+
+    area.waitForReaper();
+    BOOST_CHECK_EQUAL(area.usage().inodes, 2);
+  }
+
+  BOOST_CHECK(exists(area_root));
+  BOOST_CHECK(boost::filesystem::is_empty(area_root));
+}
+
+BOOST_FIXTURE_TEST_CASE(TempAreaKeep_test, Temporary_Fixture) {
+
+  const Path::Item area_root = m_top_dir.path() / "area";
+  Path::Item       that_path;
+
+  {
+    TempArea area(area_root);
+    m_env["KEEPTEMPDIR"] = "1";
+    {
+      TempDir that(area);
+      that_path = that.path();
+    }
+    m_env.unSet("KEEPTEMPDIR");
+  }
+
+  BOOST_CHECK(exists(that_path));
+}
+
+BOOST_FIXTURE_TEST_CASE(FastRoot_test, Temporary_Fixture) {
+
+  const Path::Item fast_dir = m_top_dir.path() / "fast";
+  create_directory(fast_dir);
+
+  m_env[DEFAULT_TMP_FAST_VAR] = fast_dir.string();
+  BOOST_CHECK(TempArea::fastRoot() == fast_dir);
+
+  // no location has enough room
+  const auto huge = std::numeric_limits<std::uintmax_t>::max();
+  BOOST_CHECK(TempArea::fastRoot(huge) == boost::filesystem::temp_directory_path());
+
+  m_env.unSet(DEFAULT_TMP_FAST_VAR);
+  BOOST_CHECK(TempArea::fastRoot() != fast_dir);
+}
+
+BOOST_FIXTURE_TEST_CASE(DefaultTempArea_test, Temporary_Fixture) {
+
+  const Path::Item fast_dir = m_top_dir.path() / "fast";
+  create_directory(fast_dir);
+  m_env[DEFAULT_TMP_FAST_VAR] = fast_dir.string();
+
+  Path::Item area_root;
+  {
+    TempArea area;
+    area_root = area.root();
+
+    // the area does not share the fast location with the other processes
+    BOOST_CHECK(area_root.parent_path() == fast_dir);
+    BOOST_CHECK(boost::filesystem::is_directory(area_root));
+
+    TempDir dir(area);
+    BOOST_CHECK(dir.path().parent_path() == area_root);
+    BOOST_CHECK_EQUAL(area.usage().inodes, 1);
+  }
+
+  BOOST_CHECK(not exists(area_root));
+  BOOST_CHECK(boost::filesystem::is_empty(fast_dir));
+}
+
+BOOST_FIXTURE_TEST_CASE(TempArray_test, Temporary_Fixture) {
+
+  using boost::filesystem::file_size;
+
+  TempArea   area(m_top_dir.path() / "area");
+  Path::Item array_path;
+
+  {
+    TempMapping mapping;
+    mapping.populate   = true;
+    mapping.huge_pages = true;
+
+    TempArray<double> values(area, 1000, mapping);
+    array_path = values.path();
+
+    BOOST_CHECK_EQUAL(values.size(), 1000);
+    BOOST_CHECK_EQUAL(file_size(array_path), 1000 * sizeof(double));
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<double>(i) / 2.0;
+    }
+    values.sync();
+
+    // the content is in the file
+    std::vector<double>         read_back(1000);
+    boost::filesystem::ifstream ifs(array_path, std::ios::binary);
+    ifs.read(reinterpret_cast<char*>(read_back.data()), static_cast<std::streamsize>(1000 * sizeof(double)));
+    BOOST_CHECK_EQUAL_COLLECTIONS(read_back.begin(), read_back.end(), values.begin(), values.end());
+  }
+
+  BOOST_CHECK(not exists(array_path));
+}
+
+BOOST_AUTO_TEST_CASE(TempMappedFileKeep_test) {
+
+  Environment current;
+  current["KEEPTEMPDIR"] = "1";
+  Path::Item that_path;
+
+  {
+    TempArray<int> that(16);
+    that_path = that.path();
+    std::fill(that.begin(), that.end(), 42);
+  }
+  BOOST_CHECK(exists(that_path));
+
+  int                         first = 0;
+  boost::filesystem::ifstream ifs(that_path, std::ios::binary);
+  ifs.read(reinterpret_cast<char*>(&first), sizeof(int));
+  BOOST_CHECK_EQUAL(first, 42);
+
+  boost::filesystem::remove_all(that_path);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyTempMappedFile_test) {
+  TempMappedFile empty(0);
+  BOOST_CHECK_EQUAL(empty.size(), 0);
+  BOOST_CHECK(empty.data() == nullptr);
+  BOOST_CHECK(exists(empty.path()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 //-----------------------------------------------------------------------------
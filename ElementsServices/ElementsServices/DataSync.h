@@ -24,11 +24,14 @@
 #ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_H_
 #define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_H_
 
+#include <memory>
+
 #include "ElementsKernel/Export.h"
 
 #include "ElementsServices/DataSync/ConnectionConfiguration.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 #include "ElementsServices/DataSync/DependencyConfiguration.h"
+#include "ElementsServices/DataSync/LazyDownloader.h"
 
 namespace ElementsServices {
 namespace DataSync {
@@ -66,11 +69,37 @@ public:
    * @brief Download the test data and provide a fallback host
    * in case the primary host fails.
    *
+   * @details The fallback is per file: only the files which the primary host
+   * fails to provide after the retries are downloaded from the fallback host;
+   * all the remaining files are once the primary host is detected as degraded.
+   * If the client of the fallback host is not available, a warning is logged
+   * and the primary host is used alone.
+   *
    * @param connectionFile Path to the connection configuration file
    * of the fallback host relative to the configuration directory.
    */
   void downloadWithFallback(path connectionFile);
 
+  /**
+   * @brief Download the test data on demand: each file is downloaded
+   * at its first access through absolutePath().
+   *
+   * @details Unless disabled, the files which were not accessed yet are
+   * prefetched in the background, in the order of the dependency file,
+   * by as many threads as parallel transfers.
+   * The remaining downloads are stopped when the DataSync object is destroyed.
+   *
+   * @param prefetch Prefetch the files before their access.
+   */
+  void downloadLazily(bool prefetch = true);
+
+  /**
+   * @brief Wait for all the test data in lazy mode.
+   *
+   * @throw DownloadFailed listing all the files which could not be downloaded.
+   */
+  void waitForDownloads();
+
   /**
    * @brief Get the absolute path to a local test file
    * which has been downloaded.
@@ -84,16 +113,22 @@ public:
    * On CODEEN, it is the job workspace which the user do not know.
    * It can be set by the user through the $WORKSPACE environment variable.
    *
+   * In lazy mode, the file is downloaded if it was not yet.
+   *
    * @warning This function must be used to access any data
    * downloaded by the DataSync tool.
+   *
+   * @throw DownloadFailed in lazy mode, if the file could not be downloaded.
    */
   path absolutePath(path relativePath);
 
 private:
-  ConnectionConfiguration m_connectionConfig;
-  path                    m_distantRoot;
-  path                    m_localRoot;
-  DependencyConfiguration m_dependencyConfig;
+  ConnectionConfiguration         m_connectionConfig;
+  path                            m_distantRoot;
+  path                            m_localRoot;
+  path                            m_dependencyFile;
+  DependencyConfiguration         m_dependencyConfig;
+  std::shared_ptr<LazyDownloader> m_lazyDownloader;
 };
 
 }  // namespace DataSync
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_CHUNKJOURNAL_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_CHUNKJOURNAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief A contiguous range of bytes of a file.
+ */
+struct ELEMENTS_API ByteRange {
+  std::uint64_t offset;
+  std::uint64_t length;
+};
+
+/**
+ * @brief Write a buffer at a given offset of an open file, with pwrite.
+ * @details
+ * The concurrent writes to disjoint ranges of the same file are safe.
+ */
+ELEMENTS_API void writeAt(int descriptor, std::uint64_t offset, const char* data, std::size_t size);
+
+/**
+ * @class ChunkJournal
+ * @ingroup ElementsServices
+ * @brief The progress of a file downloaded in chunks, for resuming interrupted downloads.
+ * @details
+ * The chunks are written in place in a partial file, next to the local file,
+ * which is allocated to the size of the distant file.
+ * The journal lists the completed chunks, once their data are on disk.
+ * When a download is interrupted, the next one resumes with the pending chunks,
+ * unless the distant file or the chunk size changed: it then starts over.
+ * The partial file is renamed to the local file when all the chunks are done.
+ */
+class ELEMENTS_API ChunkJournal {
+
+public:
+  /**
+   * @brief Open the partial file, and load the journal of a previous download of the same version.
+   */
+  ChunkJournal(path localFile, const RemoteMetadata& remote, std::uint64_t chunkSize);
+
+  ChunkJournal(const ChunkJournal&) = delete;
+  ChunkJournal& operator=(const ChunkJournal&) = delete;
+
+  ~ChunkJournal();
+
+  /**
+   * @brief The file in which the chunks are written.
+   */
+  static path partialFile(path localFile);
+
+  /**
+   * @brief The list of the completed chunks.
+   */
+  static path journalFile(path localFile);
+
+  std::size_t chunkCount() const;
+
+  ByteRange chunk(std::size_t index) const;
+
+  /**
+   * @brief The indices of the chunks which remain to be downloaded.
+   */
+  std::vector<std::size_t> pendingChunks() const;
+
+  /**
+   * @brief The descriptor of the partial file, open for writing.
+   */
+  int descriptor() const;
+
+  /**
+   * @brief Record a chunk as completed, after flushing its data to disk.
+   */
+  void complete(std::size_t index);
+
+  /**
+   * @brief Move the partial file to the local file, and remove the journal.
+   * @throw std::runtime_error if some chunks are pending.
+   */
+  void commit();
+
+private:
+  bool load(const std::string& header);
+
+  void restart(const std::string& header);
+
+  path               m_localFile;
+  std::uint64_t      m_size;
+  std::uint64_t      m_chunkSize;
+  std::vector<bool>  m_done;
+  int                m_descriptor;
+  std::ofstream      m_journal;
+  mutable std::mutex m_mutex;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_CHUNKJOURNAL_H_
+
+/**@}*/
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_COMMANDRUNNER_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_COMMANDRUNNER_H_
+
+#include <sys/types.h>  // for pid_t
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief The time limits of a command; a zero duration means no limit.
+ */
+struct ELEMENTS_API CommandLimits {
+  /// maximum duration of the command
+  std::chrono::milliseconds wallTimeout{0};
+  /// maximum duration without any output
+  std::chrono::milliseconds idleTimeout{0};
+};
+
+/**
+ * @brief The outputs, status and resource usage of a command.
+ */
+struct ELEMENTS_API CommandResult {
+  std::string               out{};
+  std::string               err{};
+  /// the exit code, or -1 if the command was terminated by a signal
+  int                       exitCode{-1};
+  /// the terminating signal, or 0
+  int                       signal{0};
+  bool                      timedOut{false};
+  std::chrono::milliseconds wallTime{0};
+  /// CPU times in seconds, of the command and its waited-for children
+  double                    userTime{0};
+  double                    systemTime{0};
+  /// maximum resident set size in kB
+  long                      maxResidentKb{0};
+
+  /**
+   * @brief Check whether the command ran to completion with a zero exit code.
+   */
+  bool succeeded() const;
+
+  /**
+   * @brief A short description of the failure, e.g. "exit code 2: <last line of the standard error>".
+   */
+  std::string failure() const;
+};
+
+/**
+ * @brief Run a shell command and capture its standard output and error.
+ * @ingroup ElementsServices
+ * @details
+ * The command runs in its own process group with /bin/sh, without standard input.
+ * Both pipes are drained as the data arrive, so that a verbose command never blocks.
+ * When a limit is exceeded, the whole process group is killed.
+ * The function can be called concurrently: the pipes are not inherited by the other children.
+ * @param outputDescriptor If not negative, the descriptor to which the standard output is written
+ * instead of being captured; the idle timeout then only watches the standard error.
+ * @throw std::runtime_error if the command cannot be started.
+ */
+ELEMENTS_API CommandResult runCommand(const std::string& command, const CommandLimits& limits = CommandLimits(),
+                                      int outputDescriptor = -1);
+
+/**
+ * @class PipedCommand
+ * @ingroup ElementsServices
+ * @brief A shell command run in the background, which reads its standard input from the caller
+ * and writes its standard output to a file.
+ * @details
+ * The input is a bounded socket buffer: the writes block while the command is busy,
+ * so that both sides work concurrently with a bounded memory.
+ * The input can also be given to another command with runCommand(),
+ * to pipe the output of the latter into the former.
+ * The command is killed if it is not finished when the object is destroyed.
+ */
+class ELEMENTS_API PipedCommand {
+
+public:
+  /**
+   * @throw std::runtime_error if the command cannot be started or the file cannot be written.
+   */
+  PipedCommand(const std::string& command, const std::string& outputFile);
+
+  PipedCommand(const PipedCommand&) = delete;
+  PipedCommand& operator=(const PipedCommand&) = delete;
+
+  ~PipedCommand();
+
+  /**
+   * @brief The descriptor of the standard input of the command.
+   */
+  int input() const;
+
+  /**
+   * @brief Write to the standard input, blocking while its buffer is full.
+   * @throw std::runtime_error if the command does not read its input anymore.
+   */
+  void write(const char* data, std::size_t size);
+
+  /**
+   * @brief Close the standard input, and wait for the end of the command.
+   * @return The result, with the standard error.
+   */
+  CommandResult finish();
+
+private:
+  int         m_input;
+  int         m_error;
+  pid_t       m_pid;
+  std::string m_command;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_COMMANDRUNNER_H_
+
+/**@}*/
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_COMPRESSION_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_COMPRESSION_H_
+
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief The compression of a distant file, which is decompressed at download.
+ */
+enum class Compression {
+  NONE,
+  GZIP,
+  ZSTD,
+};
+
+/**
+ * @brief Get the compression from its name in the dependency file: gzip (or gz), zstd (or zst).
+ * @ingroup ElementsServices
+ * @throw std::runtime_error if the compression is unknown.
+ */
+ELEMENTS_API Compression compressionFromName(const std::string& name);
+
+/**
+ * @brief The shell command which decompresses its standard input to its standard output.
+ * @ingroup ElementsServices
+ */
+ELEMENTS_API std::string decompressionCommand(Compression compression);
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_COMPRESSION_H_
+
+/**@}*/
@@ -24,11 +24,15 @@
 #ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_CONNECTIONCONFIGURATION_H_
 #define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_CONNECTIONCONFIGURATION_H_
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 #include "ElementsKernel/Export.h"
 
+#include "ElementsServices/DataSync/CommandRunner.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
+#include "ElementsServices/DataSync/IoPolicy.h"
 
 namespace ElementsServices {
 namespace DataSync {
@@ -40,6 +44,7 @@ namespace DataSync {
 enum DataHost {
   IRODS,
   WEBDAV,
+  HTTP,
 };
 
 /**
@@ -69,7 +74,13 @@ public:
  * @brief The connection configuration mainly holds:
  * * the host type and URL,
  * * the user name and password,
- * * the overwriting policy.
+ * * the overwriting and incremental policies,
+ * * the object cache,
+ * * the download tries, concurrency, batching and time limits,
+ * * the retry and circuit breaking policies,
+ * * the chunking of the large files,
+ * * the bandwidth limits and the I/O priority,
+ * * the progress logs and the transfer metrics.
  */
 class ELEMENTS_API ConnectionConfiguration {
 
@@ -86,6 +97,21 @@ public:
    */
   bool overwritingAllowed() const;
 
+  /**
+   * @brief Check whether the unchanged files are skipped according to the manifest.
+   */
+  bool incrementalSyncEnabled() const;
+
+  /**
+   * @brief Check whether the files are shared with the other workspaces through the object cache.
+   */
+  bool objectCacheEnabled() const;
+
+  /**
+   * @brief Check whether the large files are downloaded in resumable chunks, if the host supports it.
+   */
+  bool chunkedTransfersEnabled() const;
+
 protected:
   void parseConfigurationFile(const path& filename);
 
@@ -93,15 +119,42 @@ protected:
 
   void parseOverwritingPolicy(const std::string& policy);
 
+  void parseIncrementalPolicy(const std::string& policy);
+
+  void parseObjectCache(const std::string& policy, const std::string& directory, int capacityMb);
+
+  void parseIoPriority(const std::string& priority);
+
 public:
-  DataHost          host;
-  std::string       hostUrl;
-  std::string       user;
-  std::string       password;
-  OverwritingPolicy overwritingPolicy;
-  size_t            tries;
-  path              distantRoot;
-  path              localRoot;
+  DataHost                  host;
+  std::string               hostUrl;
+  std::string               user;
+  std::string               password;
+  OverwritingPolicy         overwritingPolicy;
+  size_t                    tries;
+  size_t                    parallelTransfers;
+  size_t                    transfersPerHost;
+  size_t                    batchSize;
+  std::uint64_t             chunkSize;
+  size_t                    parallelChunks;
+  CommandLimits             commandLimits;
+  std::chrono::milliseconds retryDelay;
+  std::chrono::milliseconds retryMaxDelay;
+  size_t                    breakerThreshold;
+  std::chrono::milliseconds breakerCooldown;
+  std::uint64_t             bandwidth;
+  std::uint64_t             nodeBandwidth;
+  IoPriority                ioPriority;
+  bool                      dropCache;
+  std::chrono::milliseconds progressPeriod;
+  path                      metricsFile;
+  bool                      checkCertificate;
+  bool                      incremental;
+  bool                      useObjectCache;
+  path                      cacheRoot;
+  std::uintmax_t            cacheCapacity;
+  path                      distantRoot;
+  path                      localRoot;
 };
 
 }  // namespace DataSync
@@ -33,6 +33,8 @@
 #include "ElementsKernel/Export.h"
 #include "ElementsKernel/Path.h"
 
+#include "ElementsServices/DataSync/CommandRunner.h"
+
 namespace ElementsServices {
 namespace DataSync {
 
@@ -42,7 +44,13 @@ ELEMENTS_API path confFilePath(path filename);
 
 ELEMENTS_API bool checkCall(std::string command);
 
-ELEMENTS_API std::pair<std::string, std::string> runCommandAndCaptureOutErr(std::string command);
+/**
+ * @brief Run a command and get its standard output and error, whatever its exit status.
+ * @ingroup ElementsServices
+ * @see runCommand for the status and the resource usage.
+ */
+ELEMENTS_API std::pair<std::string, std::string> runCommandAndCaptureOutErr(std::string command,
+                                                                            const CommandLimits& limits = {});
 
 ELEMENTS_API bool localDirExists(path localDir);
 
@@ -25,14 +25,25 @@
 #define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_DATASYNCHRONIZER_H_
 
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ElementsKernel/Export.h"
 
+#include "ElementsServices/DataSync/ChunkJournal.h"
+#include "ElementsServices/DataSync/Compression.h"
 #include "ElementsServices/DataSync/ConnectionConfiguration.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 #include "ElementsServices/DataSync/DependencyConfiguration.h"
+#include "ElementsServices/DataSync/DownloadScheduler.h"
+#include "ElementsServices/DataSync/ObjectCache.h"
+#include "ElementsServices/DataSync/RateLimiter.h"
+#include "ElementsServices/DataSync/RetryPolicy.h"
+#include "ElementsServices/DataSync/SyncManifest.h"
+#include "ElementsServices/DataSync/TransferMetrics.h"
 
 namespace ElementsServices {
 namespace DataSync {
@@ -45,9 +56,39 @@ namespace DataSync {
 class ELEMENTS_API DownloadFailed : public std::runtime_error {
 public:
   virtual ~DownloadFailed() = default;
-  DownloadFailed(path distantFile, path localFile)
+  DownloadFailed(path distantFile, path localFile, const std::string& reason = "", bool retryable = true)
       : std::runtime_error("Unable to download file: '" + distantFile.string() + "' as: '" + localFile.string() +
-                           "'.") {}
+                           "'." + (reason.empty() ? "" : " " + reason))
+      , m_retryable(retryable) {}
+  explicit DownloadFailed(const std::vector<DownloadFailure>& failures)
+      : std::runtime_error(failureListMessage(failures)), m_retryable(false) {}
+
+  /**
+   * @brief Check whether trying again may succeed, e.g. after a network error, but not after a missing file.
+   */
+  bool retryable() const {
+    return m_retryable;
+  }
+
+private:
+  static std::string failureListMessage(const std::vector<DownloadFailure>& failures);
+
+  bool m_retryable;
+};
+
+/**
+ * @brief Files downloaded by a single command, as pairs of distant and local files.
+ */
+using FileBatch = std::vector<std::pair<path, path>>;
+
+/**
+ * @brief The state shared by the downloads of a synchronization.
+ */
+struct ELEMENTS_API SyncSession {
+  explicit SyncSession(path manifestFile) : manifest(manifestFile), cache() {}
+
+  SyncManifest                 manifest;
+  std::unique_ptr<ObjectCache> cache;  ///< nullptr without object cache
 };
 
 /**
@@ -64,22 +105,243 @@ public:
 
   DataSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency);
 
+  /**
+   * @brief Download the files which should be written.
+   * @details
+   * The downloads are run concurrently according to the connection
+   * configuration. All the files are tried before reporting the failures.
+   * In incremental mode, the files which are up to date according to the
+   * manifest are skipped, the others are downloaded whatever the overwriting
+   * policy, verified and recorded in the manifest.
+   * With the object cache, the local files are links to the shared objects,
+   * which are downloaded only if no other workspace did it before.
+   * If the host supports it, the files larger than the chunk size are
+   * downloaded in chunks, which are resumed after an interruption;
+   * outside the incremental mode and the object cache, the files are
+   * downloaded in batches, and the files which a batch misses one by one.
+   * The compressed files are decompressed as they are downloaded.
+   * The transient failures are retried with an exponential backoff.
+   * The files which still fail are downloaded from the fallback host, if any;
+   * so are all the files once the host failed repeatedly.
+   * The throughput is limited by the process and node bandwidths,
+   * and the disk writes follow the configured I/O priority.
+   * The files are written under a temporary name and renamed into place.
+   * Each file is locked while it is downloaded, so that the processes which
+   * share the workspace download it once, the others waiting for it.
+   * The transfers are measured, see metrics().
+   * @throw DownloadFailed listing all the files which could not be downloaded.
+   */
   void downloadAllFiles() const;
 
+  /**
+   * @brief The measures of the current or last synchronization.
+   * @details
+   * The progress is logged periodically, and the summary at the end of the synchronization;
+   * the summary is also written as JSON if a metrics file is configured.
+   */
+  const TransferMetrics& metrics() const;
+
+  /**
+   * @brief Set the synchronizer of the fallback host, used for the files which the primary host fails to provide.
+   * @details
+   * The fallback should be configured with the same local workspace.
+   */
+  void setFallback(std::shared_ptr<const DataSynchronizer> fallback);
+
+  /**
+   * @brief Start a synchronization whose files are downloaded one by one with synchronizeDependency().
+   */
+  std::unique_ptr<SyncSession> openSession() const;
+
+  /**
+   * @brief Check whether a dependency should be synchronized, according to the overwriting and incremental policies.
+   */
+  bool dependencyShouldBeSynchronized(path localFile) const;
+
+  /**
+   * @brief Download a dependency like downloadAllFiles() does, if it should be synchronized.
+   * @details
+   * The concurrent calls must download different files.
+   * @throw DownloadFailed if the file is not a dependency or could not be downloaded.
+   */
+  void synchronizeDependency(SyncSession& session, path localFile) const;
+
+  /**
+   * @brief Save the manifest, evict the object cache, and report the metrics.
+   */
+  void closeSession(SyncSession& session) const;
+
 protected:
+  /**
+   * @brief The name of the host, used to limit the concurrent downloads per host.
+   */
+  virtual std::string hostName() const;
+
+  /**
+   * @brief The metadata of a distant file, used by the incremental mode and the object cache.
+   * @details
+   * The default implementation returns unknown metadata:
+   * the files are then always downloaded, and not cached.
+   */
+  virtual RemoteMetadata remoteMetadata(path distantFile) const;
+
+  /**
+   * @brief The manifest of the synchronized files, at the local root.
+   */
+  path manifestFile() const;
+
+  /**
+   * @brief The directory of the download locks, at the local root.
+   */
+  path lockDirectory() const;
+
+  /**
+   * @brief Download a file if it is not up to date, then verify and record it.
+   * @details
+   * If the host fails, the file is downloaded from the fallback host, and not recorded.
+   * @param cache The object cache, or nullptr to download directly into the workspace.
+   */
+  void synchronizeOneFile(SyncManifest& manifest, const ObjectCache* cache, path distantFile, path localFile) const;
+
+  /**
+   * @brief Synchronize a file from this host only, without fallback.
+   * @return Whether the file was transferred, false if it was up to date or already in the cache.
+   */
+  bool synchronizeFromHost(SyncManifest& manifest, const ObjectCache* cache, path distantFile, path localFile) const;
+
   bool fileShouldBeWritten(path localFile) const;
 
   bool fileAlreadyExists(path localFile) const;
 
-  void downloadOneFile(path distantFile, path localFile) const;
+  /**
+   * @brief Download a file, by default by running the download command.
+   * @throw DownloadFailed if the file could not be downloaded.
+   */
+  virtual void downloadOneFile(path distantFile, path localFile) const;
 
   bool hasBeenDownloaded(path distantFile, path localFile) const;
 
+  /**
+   * @brief Group the files to download in batches, each downloaded by a single command.
+   * @details
+   * By default, each file is alone in its batch.
+   */
+  virtual std::vector<FileBatch> groupInBatches(const FileBatch& files) const;
+
+  /**
+   * @brief Create the command which downloads a batch of several files.
+   * @details
+   * The local files of the batch are in a staging directory, with their final names.
+   */
+  virtual std::string createBatchDownloadCommand(const FileBatch& batch) const;
+
+  /**
+   * @brief Download a batch of files with a single command.
+   * @details
+   * The files are downloaded to a staging directory, then renamed into place.
+   * The files which another process is downloading are skipped.
+   * If the command fails, the staged files whose size matches the remote metadata are kept.
+   * @return The local files which were downloaded; the others should be downloaded one by one.
+   */
+  std::vector<path> downloadBatch(const FileBatch& batch) const;
+
+  /**
+   * @brief Check whether a file staged by a failed batch is complete, according to the remote metadata.
+   * @details
+   * A file is never considered complete if the host does not provide its metadata.
+   */
+  bool stagedFileIsComplete(path distantFile, path stagedFile) const;
+
+  /**
+   * @brief Check whether the host can download ranges of files, with downloadRange().
+   */
+  virtual bool supportsRanges() const;
+
+  /**
+   * @brief Download a range of a distant file at the same offset of an open local file.
+   * @details
+   * The download fails if the distant file is not the expected version anymore.
+   * The concurrent calls write disjoint ranges.
+   * @throw std::runtime_error if the range could not be downloaded.
+   */
+  virtual void downloadRange(path distantFile, const RemoteMetadata& remote, ByteRange range, int descriptor) const;
+
+  /**
+   * @brief Download a file in chunks, concurrently, and resume a previous interrupted download.
+   * @throw DownloadFailed if some chunks could not be downloaded; the others are kept.
+   */
+  void downloadInChunks(path distantFile, path localFile, const RemoteMetadata& remote) const;
+
+  /**
+   * @brief Download a compressed file, and decompress it as the bytes arrive.
+   * @details
+   * By default, the output of the streaming download command is piped into the decompressor.
+   * If the host has no such command, the compressed file is downloaded first, then decompressed.
+   * @throw DownloadFailed if the file could not be downloaded or decompressed.
+   */
+  virtual void downloadDecompressed(path distantFile, path localFile, Compression compression) const;
+
+  /**
+   * @brief The command which writes a distant file to its standard output, or an empty string if there is none.
+   */
+  virtual std::string createStreamingDownloadCommand(path distantFile) const;
+
+  /**
+   * @brief The compression of a dependency which is decompressed at download.
+   */
+  Compression compressionOf(path localFile) const;
+
+  /**
+   * @brief Download a file in chunks if it is large enough, at once otherwise.
+   * @details
+   * A compressed file is always downloaded at once, through the decompressor.
+   */
+  void fetchOneFile(path distantFile, path localFile, const RemoteMetadata& remote,
+                    Compression compression = Compression::NONE) const;
+
+  /**
+   * @brief Fetch a file, and retry the transient failures according to the connection configuration.
+   * @details
+   * The attempts are recorded by the circuit breaker of the host.
+   */
+  void fetchWithRetries(path distantFile, path localFile, const RemoteMetadata& remote,
+                        Compression compression = Compression::NONE) const;
+
+  /**
+   * @brief Fetch a file of the primary host from this fallback host.
+   */
+  void fetchAsFallback(path localFile) const;
+
+  /**
+   * @brief Wait until some bytes can be received without exceeding the process and node bandwidths.
+   * @details
+   * The native clients call it before writing each received buffer,
+   * which also accounts the bytes to the file measured by the thread.
+   */
+  void throttle(std::uint64_t bytes) const;
+
+  /**
+   * @brief Check whether a failed download command is worth retrying.
+   * @details
+   * By default, all the failures are considered transient.
+   */
+  virtual bool failureIsRetryable(const CommandResult& result) const;
+
+  /**
+   * @brief Check whether an error raised by a download is worth retrying.
+   */
+  static bool errorIsRetryable(const std::exception& error);
+
   virtual std::string createDownloadCommand(path distantFile, path localFile) const = 0;
 
 protected:
-  ConnectionConfiguration m_connection;
-  std::map<path, path>    m_fileMap;
+  ConnectionConfiguration                 m_connection;
+  DependencyConfiguration                 m_dependencies;
+  std::shared_ptr<CircuitBreaker>         m_breaker;
+  std::shared_ptr<const DataSynchronizer> m_fallback;
+  std::shared_ptr<RateLimiter>            m_processLimiter;
+  std::shared_ptr<RateLimiter>            m_nodeLimiter;
+  std::shared_ptr<TransferMetrics>        m_metrics;
 };
 
 }  // namespace DataSync
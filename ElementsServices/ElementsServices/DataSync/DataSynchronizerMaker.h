@@ -31,12 +31,18 @@
 
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 #include "ElementsServices/DataSync/DataSynchronizer.h"
+#include "ElementsServices/DataSync/HttpSynchronizer.h"
 #include "ElementsServices/DataSync/IrodsSynchronizer.h"
 #include "ElementsServices/DataSync/WebdavSynchronizer.h"
 
 namespace ElementsServices {
 namespace DataSync {
 
+/**
+ * @brief Create the synchronizer of the configured host.
+ * @details
+ * The WebDAV hosts are served by the native HTTP client if it is available for their URL, and by wget otherwise.
+ */
 ELEMENTS_API std::shared_ptr<DataSynchronizer> createSynchronizer(ConnectionConfiguration connection,
                                                                   DependencyConfiguration dependency);
 
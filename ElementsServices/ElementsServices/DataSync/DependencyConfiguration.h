@@ -24,10 +24,16 @@
 #ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_DEPENDENCYCONFIGURATION_H_
 #define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_DEPENDENCYCONFIGURATION_H_
 
+#include <cstddef>
 #include <map>
 #include <string>
 #include <vector>
 
+#include <boost/utility/string_ref.hpp>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/Compression.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 
 namespace ElementsServices {
@@ -39,7 +45,17 @@ namespace DataSync {
  * @brief The dependency configurations holds,
  * for each test file to be retrieved:
  * * the distant source path,
- * * the local destination path.
+ * * the local destination path,
+ * * the compression of the distant file, if it is decompressed at download.
+ * @details
+ * Each line holds a distant path, optionally followed by a tab and
+ * the local path (the alias), then by a tab and the compression:
+ * @code
+ * data/catalog.fits.gz	data/catalog.fits	gzip
+ * @endcode
+ * The file is mapped in memory and parsed in place; the names are stored
+ * in a single buffer, and the dependencies in a vector sorted by local path,
+ * so that configurations of millions of files are read quickly.
  */
 class ELEMENTS_API DependencyConfiguration {
 
@@ -48,34 +64,102 @@ public:
 
   DependencyConfiguration(path distantRoot, path localRoot, path configFile);
 
+  /**
+   * @brief The distant paths by local path.
+   * @details
+   * The map is built at each call: prefer the indexed accessors for large configurations.
+   */
   std::map<path, path> fileMap() const;
 
+  /**
+   * @throw std::out_of_range if the file is not a dependency.
+   */
   path distantPathOf(path localFile) const;
 
   size_t dependencyCount() const;
 
+  /**
+   * @brief The index of a dependency in the sorted dependencies, or dependencyCount() if it is not a dependency.
+   */
+  size_t indexOf(const path& localFile) const;
+
+  path localPathAt(size_t index) const;
+
+  path distantPathAt(size_t index) const;
+
+  Compression compressionAt(size_t index) const;
+
   std::vector<path> distantPaths() const;
 
   std::vector<path> localPaths() const;
 
+  /**
+   * @brief The local paths in the order of the dependency file, without duplicates.
+   */
+  std::vector<path> localPathsInFileOrder() const;
+
+  /**
+   * @brief The compressions of the files which are decompressed at download, by local path.
+   */
+  std::map<path, Compression> compressions() const;
+
+  Compression compressionOf(path localFile) const;
+
 protected:
   void parseConfigurationFile(path filename);
 
-  void parseConfigurationLine(std::string line);
+  void parseConfigurationLine(boost::string_ref line);
 
   char aliasSeparator() const;
 
-  bool lineHasAlias(std::string line) const;
+  bool lineHasAlias(boost::string_ref line) const;
+
+  void parseLineWithAlias(boost::string_ref line);
+
+  void parseLineWithoutAlias(boost::string_ref line);
 
-  void parseLineWithAlias(std::string line);
+  /**
+   * @brief Append a dependency, given by its names relative to the roots, which is looked up after sortDependencies().
+   */
+  void addDependency(boost::string_ref localName, boost::string_ref distantName,
+                     Compression compression = Compression::NONE);
 
-  void parseLineWithoutAlias(std::string line);
+  /**
+   * @brief Sort the dependencies added since the last call, and merge the duplicates.
+   * @details
+   * The last line wins, at the position of the first one.
+   */
+  void sortDependencies();
 
 private:
-  char                 m_aliasSeparator;
-  path                 m_distantRoot;
-  path                 m_localRoot;
-  std::map<path, path> m_fileMap;
+  /**
+   * @brief A dependency, whose names are slices of the name buffer.
+   */
+  struct Entry {
+    size_t      localOffset;
+    size_t      localSize;
+    size_t      distantOffset;
+    size_t      distantSize;
+    size_t      order;
+    Compression compression;
+  };
+
+  void appendLine(boost::string_ref line);
+
+  void appendLineWithAlias(boost::string_ref line);
+
+  boost::string_ref localNameOf(const Entry& entry) const;
+
+  boost::string_ref distantNameOf(const Entry& entry) const;
+
+  char               m_aliasSeparator;
+  path               m_distantRoot;
+  path               m_localRoot;
+  std::string        m_localPrefix;
+  std::string        m_names;
+  std::vector<Entry> m_entries;
+  size_t             m_sortedCount;
+  size_t             m_addedCount;
 };
 
 }  // namespace DataSync
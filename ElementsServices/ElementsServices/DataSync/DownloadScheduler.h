@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_DOWNLOADSCHEDULER_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_DOWNLOADSCHEDULER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief The description of a failed download.
+ */
+struct ELEMENTS_API DownloadFailure {
+  path        distantFile;
+  path        localFile;
+  std::string reason;
+};
+
+/**
+ * @class DownloadScheduler
+ * @ingroup ElementsServices
+ * @brief Run download tasks concurrently on a pool of worker threads.
+ * @details
+ * At most workerCount tasks run at the same time, and at most hostLimit
+ * of them for a given host. The submission blocks while queueCapacity tasks
+ * are waiting, so that the queue does not grow with the number of files.
+ * The failing tasks do not stop the others: their errors are collected.
+ */
+class ELEMENTS_API DownloadScheduler {
+
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @param workerCount Number of worker threads (at least 1).
+   * @param hostLimit Maximum number of concurrent tasks per host; 0 means no limit.
+   * @param queueCapacity Maximum number of waiting tasks; 0 means twice the number of workers.
+   */
+  DownloadScheduler(std::size_t workerCount, std::size_t hostLimit = 0, std::size_t queueCapacity = 0);
+
+  DownloadScheduler(const DownloadScheduler&) = delete;
+  DownloadScheduler& operator=(const DownloadScheduler&) = delete;
+
+  /**
+   * @brief Wait for the remaining tasks and stop the workers.
+   */
+  ~DownloadScheduler();
+
+  /**
+   * @brief Queue the download of a file, blocking while the queue is full.
+   */
+  void submit(const std::string& host, path distantFile, path localFile, Task task);
+
+  /**
+   * @brief Wait for all the submitted tasks.
+   * @return The failures since the previous call.
+   */
+  std::vector<DownloadFailure> wait();
+
+  std::size_t workerCount() const;
+
+private:
+  struct Job {
+    std::string host;
+    path        distantFile;
+    path        localFile;
+    Task        task;
+  };
+
+  void work();
+
+  bool hasRunnableJob() const;
+
+  std::deque<Job>::iterator nextRunnableJob();
+
+  const std::size_t                  m_hostLimit;
+  const std::size_t                  m_queueCapacity;
+  std::deque<Job>                    m_queue;
+  std::map<std::string, std::size_t> m_activePerHost;
+  std::size_t                        m_activeCount;
+  std::vector<DownloadFailure>       m_failures;
+  bool                               m_stopping;
+  mutable std::mutex                 m_mutex;
+  std::condition_variable            m_jobAvailable;
+  std::condition_variable            m_slotAvailable;
+  std::condition_variable            m_allDone;
+  std::vector<std::thread>           m_workers;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_DOWNLOADSCHEDULER_H_
+
+/**@}*/
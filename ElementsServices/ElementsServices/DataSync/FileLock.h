@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_FILELOCK_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_FILELOCK_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief A unique path next to a file, where it can be written before being renamed into place.
+ * @details
+ * The path is unique among the threads and the processes of a node.
+ */
+ELEMENTS_API path uniquePartialPath(path file);
+
+/**
+ * @brief Check whether a path was made by uniquePartialPath().
+ */
+ELEMENTS_API bool isPartialPath(path file);
+
+/**
+ * @class FileLock
+ * @ingroup ElementsServices
+ * @brief Lock of a file, effective between the processes and between the threads.
+ * @details
+ * The operation is the one of flock: LOCK_SH or LOCK_EX, possibly with LOCK_NB.
+ * The lock file is created if needed, and the lock is released by the system if the process dies.
+ * The lock file may be removed by the holder of an exclusive lock: the lock which was obtained
+ * on a removed or replaced file is taken again on the file at the same path.
+ */
+class ELEMENTS_API FileLock {
+
+public:
+  /**
+   * @throw std::runtime_error if the lock file cannot be opened.
+   */
+  FileLock(path file, int operation);
+
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+
+  /**
+   * @brief Close the file, which releases the lock.
+   */
+  ~FileLock();
+
+  /**
+   * @brief Change the lock.
+   * @return Whether the lock is held, which is false if a non-blocking operation would block.
+   * @throw std::runtime_error if the lock file was removed and cannot be created again.
+   */
+  bool lock(int operation);
+
+  bool locked() const;
+
+  int descriptor() const;
+
+private:
+  /// whether the file at the lock path is not the one which is locked anymore
+  bool fileWasReplaced() const;
+
+  void reopen();
+
+  const path m_file;
+  int        m_fd;
+  bool       m_locked;
+};
+
+/**
+ * @class DownloadLock
+ * @ingroup ElementsServices
+ * @brief The exclusive right to download a local file, among the processes which share the workspace.
+ * @details
+ * Each local file has its own lock file in the lock directory.
+ * The lock cannot be stale: it is released by the system if its holder dies.
+ * Once the lock is held, the partial files left by a dead holder are removed.
+ * The holder stamps the lock file after the download, so that the processes
+ * which waited for it can skip the file instead of downloading it again.
+ */
+class ELEMENTS_API DownloadLock {
+
+public:
+  /**
+   * @brief Wait for the lock.
+   */
+  DownloadLock(path lockDirectory, path localFile);
+
+  /**
+   * @brief Get the lock if it is available.
+   * @return The lock, or nullptr if another process or thread holds it.
+   */
+  static std::unique_ptr<DownloadLock> tryLock(path lockDirectory, path localFile);
+
+  /**
+   * @brief Check whether another process or thread downloaded the file while this one was waiting for the lock.
+   */
+  bool downloadedMeanwhile() const;
+
+  /**
+   * @brief Stamp the lock file once the file is downloaded.
+   */
+  void markDownloaded() const;
+
+  /**
+   * @brief The lock file of a local file.
+   */
+  static path lockFileOf(path lockDirectory, path localFile);
+
+private:
+  DownloadLock(path lockDirectory, path localFile, bool blocking);
+
+  void removePartialFiles() const;
+
+  path         m_localFile;
+  FileLock     m_lock;
+  std::int64_t m_waitStart;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_FILELOCK_H_
+
+/**@}*/
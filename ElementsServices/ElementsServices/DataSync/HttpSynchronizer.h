@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_HTTPSYNCHRONIZER_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_HTTPSYNCHRONIZER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSynchronizer.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief Check whether the native HTTP client is available.
+ * @ingroup ElementsServices
+ * @details
+ * It requires Boost.Beast, and OpenSSL for the HTTPS hosts.
+ */
+ELEMENTS_API bool httpIsAvailable(bool secure = false);
+
+/**
+ * @brief The value of the Authorization header for the HTTP basic authentication.
+ * @ingroup ElementsServices
+ */
+ELEMENTS_API std::string basicAuthorization(const std::string& user, const std::string& password);
+
+class HttpConnectionPool;
+class PipedCommand;
+
+/**
+ * @class HttpSynchronizer
+ * @ingroup ElementsServices
+ * @brief A data synchronizer for HTTP(S) and WebDAV hosts, without subprocess.
+ * @details
+ * The connections are kept alive and reused by the next downloads:
+ * the TCP connection and the TLS handshake are paid once per download worker
+ * instead of once per file. The response bodies are streamed to the local files.
+ * The credentials are sent in the Authorization header, never on a command line.
+ * The redirections are followed.
+ * The large files are downloaded in chunks with Range requests.
+ * The compressed files are streamed to the decompressor as the body is received.
+ */
+class ELEMENTS_API HttpSynchronizer : public DataSynchronizer {
+
+public:
+  virtual ~HttpSynchronizer() = default;
+
+  HttpSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency);
+
+  /**
+   * @brief A description of the request, for the logs; no command is run.
+   */
+  std::string createDownloadCommand(path distantFile, path localFile) const override;
+
+  /**
+   * @brief The metadata from a HEAD request.
+   */
+  RemoteMetadata remoteMetadata(path distantFile) const override;
+
+  /**
+   * @brief The number of connections opened so far.
+   */
+  std::size_t openedConnections() const;
+
+protected:
+  void downloadOneFile(path distantFile, path localFile) const override;
+
+  void downloadDecompressed(path distantFile, path localFile, Compression compression) const override;
+
+  bool supportsRanges() const override;
+
+  /**
+   * @brief Download a range with a Range request, conditioned by an If-Range on the ETag.
+   */
+  void downloadRange(path distantFile, const RemoteMetadata& remote, ByteRange range, int descriptor) const override;
+
+private:
+  std::string distantUrl(path distantFile) const;
+
+  /**
+   * @brief Download a whole file, to the local file or to a decompressor which writes it.
+   */
+  void downloadBody(path distantFile, path localFile, PipedCommand* decompressor) const;
+
+  std::shared_ptr<HttpConnectionPool> m_pool;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_HTTPSYNCHRONIZER_H_
+
+/**@}*/
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_IOPOLICY_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_IOPOLICY_H_
+
+#include <cstdint>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief The disk I/O priority of the downloads, relative to the other processes of the node.
+ */
+enum class IoPriority {
+  NORMAL,  ///< The priority of the process is kept
+  LOW,     ///< The lowest best-effort priority
+  IDLE,    ///< Served only when the disk is not used by anybody else
+};
+
+/**
+ * @brief Set the I/O priority of the calling thread and of the commands it will spawn.
+ * @details
+ * Only implemented on Linux, with the ioprio_set system call.
+ * @return false if the priority could not be set.
+ */
+ELEMENTS_API bool setThreadIoPriority(IoPriority priority);
+
+/**
+ * @brief Flush a written range of a file and drop it from the page cache,
+ * so that the synchronized data does not evict the pages of the running jobs.
+ * @param length The length of the range; 0 means up to the end of the file.
+ */
+ELEMENTS_API void releasePageCache(int descriptor, std::uint64_t offset = 0, std::uint64_t length = 0);
+
+/**
+ * @brief Flush a written file and drop it from the page cache.
+ */
+ELEMENTS_API void releasePageCache(const path& file);
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_IOPOLICY_H_
+
+/**@}*/
@@ -39,10 +39,21 @@ namespace DataSync {
  */
 ELEMENTS_API bool irodsIsInstalled();
 
+/**
+ * @brief Read the metadata of a distant file from the long listing of ils.
+ * @ingroup ElementsServices
+ * @details
+ * The first good replica (marked with '&') is used; the version is its modification date.
+ */
+ELEMENTS_API RemoteMetadata irodsMetadataFromListing(const std::string& listing);
+
 /**
  * @class IrodsSynchronizer
  * @ingroup ElementsServices
  * @brief A data synchronizer for iRODS hosts.
+ * @details
+ * The files which keep their name are downloaded in batches per local directory,
+ * by a single iget session; the renamed files are synchronized one by one with irsync.
  */
 class ELEMENTS_API IrodsSynchronizer : public DataSynchronizer {
 
@@ -52,6 +63,20 @@ public:
   IrodsSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency);
 
   std::string createDownloadCommand(path distantFile, path localFile) const override;
+
+  std::string createStreamingDownloadCommand(path distantFile) const override;
+
+  RemoteMetadata remoteMetadata(path distantFile) const override;
+
+  std::vector<FileBatch> groupInBatches(const FileBatch& files) const override;
+
+  std::string createBatchDownloadCommand(const FileBatch& batch) const override;
+
+protected:
+  /**
+   * @brief Classify the failures according to the iRODS error names.
+   */
+  bool failureIsRetryable(const CommandResult& result) const override;
 };
 
 }  // namespace DataSync
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_LAZYDOWNLOADER_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_LAZYDOWNLOADER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+#include "ElementsServices/DataSync/DataSynchronizer.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @class LazyDownloader
+ * @ingroup ElementsServices
+ * @brief Download the dependencies on demand, and prefetch the others in the background.
+ * @details
+ * A required file is downloaded by the calling thread, unless a prefetcher is
+ * already downloading it, in which case the call waits for it.
+ * The prefetchers download the files which were not required yet,
+ * in the order of the dependency file.
+ * Each file is downloaded at most once; a failure is reported to all the
+ * requests of the file.
+ */
+class ELEMENTS_API LazyDownloader {
+
+public:
+  /**
+   * @param synchronizer The synchronizer of the host, with its fallback if any.
+   * @param localFiles The dependencies, in prefetching order.
+   * @param prefetcherCount The number of prefetching threads; 0 to download the required files only.
+   */
+  LazyDownloader(std::shared_ptr<const DataSynchronizer> synchronizer, std::vector<path> localFiles,
+                 std::size_t prefetcherCount);
+
+  LazyDownloader(const LazyDownloader&) = delete;
+  LazyDownloader& operator=(const LazyDownloader&) = delete;
+
+  /**
+   * @brief Stop the prefetchers after their current download, and close the session.
+   */
+  ~LazyDownloader();
+
+  /**
+   * @brief Return once a dependency is downloaded, downloading it if needed.
+   * @details
+   * The files which are not dependencies are ignored.
+   * @throw DownloadFailed if the file could not be downloaded.
+   */
+  void require(path localFile);
+
+  /**
+   * @brief Download all the remaining dependencies.
+   * @throw DownloadFailed listing all the files which could not be downloaded.
+   */
+  void requireAll();
+
+private:
+  enum class State {
+    PENDING,
+    RUNNING,
+    DONE,
+    FAILED,
+  };
+
+  struct Dependency {
+    State              state;
+    std::exception_ptr error;
+  };
+
+  /// download a file in the calling thread, then wake up the waiting threads
+  void fetch(std::unique_lock<std::mutex>& lock, path localFile, Dependency& dependency);
+
+  void prefetch();
+
+  std::shared_ptr<const DataSynchronizer> m_synchronizer;
+  std::unique_ptr<SyncSession>            m_session;
+  std::vector<path>                       m_order;
+  std::map<path, Dependency>              m_dependencies;
+  std::size_t                             m_next;
+  bool                                    m_stopping;
+  std::mutex                              m_mutex;
+  std::condition_variable                 m_changed;
+  std::vector<std::thread>                m_prefetchers;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_LAZYDOWNLOADER_H_
+
+/**@}*/
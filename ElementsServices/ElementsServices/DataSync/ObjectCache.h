@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_OBJECTCACHE_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_OBJECTCACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief How a local file is made from a cached object.
+ */
+enum class CacheLink {
+  HARDLINK,
+  REFLINK,
+  SYMLINK,
+  COPY,
+};
+
+/**
+ * @class ObjectCache
+ * @ingroup ElementsServices
+ * @brief Node-wide store of the downloaded files, shared by the workspaces.
+ * @details
+ * The objects are stored read-only under root/objects, and addressed by
+ * the identity of the distant file: host, path, size and version.
+ * The local files are hard links to the objects when possible, then
+ * reflinks, then symbolic links, and copies as a last resort.
+ * An object is downloaded by a single process or thread at a time, the others
+ * wait for it through a file lock, so that concurrent synchronizations of
+ * the same file download it once.
+ * The least recently used objects are evicted when the total size exceeds
+ * the capacity. The hard links, reflinks and copies survive the eviction;
+ * the symbolic links are restored at the next synchronization.
+ */
+class ELEMENTS_API ObjectCache {
+
+public:
+  using Fetch = std::function<void(path)>;
+
+  /**
+   * @param root The cache directory.
+   * @param capacity The maximum size of the objects, in bytes; 0 means no limit.
+   */
+  explicit ObjectCache(path root, std::uintmax_t capacity = 0);
+
+  /**
+   * @brief The default cache directory: $XDG_CACHE_HOME/elements-datasync or ~/.cache/elements-datasync.
+   */
+  static path defaultRoot();
+
+  /**
+   * @brief The key of a version of a distant file.
+   */
+  static std::string objectKey(const std::string& host, path distantFile, const RemoteMetadata& remote);
+
+  path root() const;
+
+  std::uintmax_t capacity() const;
+
+  path objectPath(const std::string& key) const;
+
+  /**
+   * @brief Create the local file from the object, which is fetched first if needed.
+   * @param fetch The function which downloads the object into a given path.
+   * @return The kind of link which was created.
+   */
+  CacheLink provide(const std::string& key, path localFile, const Fetch& fetch) const;
+
+  /**
+   * @brief The total size of the objects, in bytes.
+   * @details
+   * The objects which other processes evict during the walk are skipped.
+   */
+  std::uintmax_t usage() const;
+
+  /**
+   * @brief Remove the least recently used objects until the usage fits the capacity.
+   * @details
+   * The objects being fetched are kept. The concurrent evictions by other processes are tolerated.
+   * @return The number of evicted objects.
+   */
+  std::size_t evict() const;
+
+private:
+  path lockPath(const std::string& key) const;
+
+  void touch(const std::string& key) const;
+
+  const path           m_root;
+  const std::uintmax_t m_capacity;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_OBJECTCACHE_H_
+
+/**@}*/
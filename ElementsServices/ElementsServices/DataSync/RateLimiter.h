@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_RATELIMITER_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_RATELIMITER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @class RateLimiter
+ * @ingroup ElementsServices
+ * @brief A token bucket which limits the throughput of the transfers sharing it.
+ * @details
+ * The bucket is implemented as a generic cell rate algorithm: its whole state
+ * is the time at which the bucket will be full again, updated atomically.
+ * This is why it can be shared by the threads of a process, and by the processes
+ * of a node through shared memory, without any lock.
+ * The bytes are acquired before being written; a burst of up to 1/4 s of
+ * transfer, and at least 64 kB, is allowed. The wait for a reservation is
+ * bounded to a few bursts beyond its own transfer time.
+ */
+class ELEMENTS_API RateLimiter {
+
+public:
+  /**
+   * @brief A limiter for its users only.
+   * @param bytesPerSecond The maximum throughput; 0 means no limit.
+   */
+  explicit RateLimiter(std::uint64_t bytesPerSecond);
+
+  /**
+   * @brief A limiter shared by all the processes of the user which use the same name on the node.
+   * @param sharedName The name of the POSIX shared memory object, created readable by its owner only.
+   * @throw std::runtime_error if the shared memory cannot be mapped.
+   */
+  RateLimiter(std::uint64_t bytesPerSecond, const std::string& sharedName);
+
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  ~RateLimiter();
+
+  /**
+   * @brief The limiter shared by all the transfers of the process with the same limit.
+   */
+  static std::shared_ptr<RateLimiter> processWide(std::uint64_t bytesPerSecond);
+
+  /**
+   * @brief The limiter shared by all the DataSync processes of the user on the node.
+   */
+  static std::shared_ptr<RateLimiter> nodeWide(std::uint64_t bytesPerSecond);
+
+  std::uint64_t bytesPerSecond() const;
+
+  /**
+   * @brief Wait until some bytes can be transferred.
+   */
+  void acquire(std::uint64_t bytes);
+
+private:
+  const std::uint64_t        m_rate;
+  std::atomic<std::int64_t>  m_ownSchedule;
+  std::atomic<std::int64_t>* m_schedule;
+  void*                      m_mapping;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_RATELIMITER_H_
+
+/**@}*/
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_RETRYPOLICY_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_RETRYPOLICY_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @class CircuitBreaker
+ * @ingroup ElementsServices
+ * @brief Stop sending requests to a host which failed repeatedly.
+ * @details
+ * After threshold consecutive failures, the circuit opens: the host is not
+ * tried anymore during the cooldown. Then a single trial is allowed; its
+ * success closes the circuit, its failure opens it again for another cooldown.
+ * A threshold of 0 disables the breaker.
+ */
+class ELEMENTS_API CircuitBreaker {
+
+public:
+  CircuitBreaker(std::size_t threshold, std::chrono::milliseconds cooldown);
+
+  /**
+   * @brief Check whether a request can be sent, and register it as the trial if the cooldown is over.
+   */
+  bool allows();
+
+  void recordSuccess();
+
+  void recordFailure();
+
+  bool isOpen() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  const std::size_t               m_threshold;
+  const std::chrono::milliseconds m_cooldown;
+  std::size_t                     m_failures;
+  bool                            m_open;
+  bool                            m_trialRunning;
+  Clock::time_point               m_openedAt;
+  mutable std::mutex              m_mutex;
+};
+
+/**
+ * @class RetryPolicy
+ * @ingroup ElementsServices
+ * @brief Retry a task with an exponential backoff and a full jitter.
+ * @details
+ * The delay before the n-th retry is drawn uniformly between 0 and
+ * min(maxDelay, initialDelay * 2^(n-1)), so that the workers which failed
+ * together do not retry together.
+ */
+class ELEMENTS_API RetryPolicy {
+
+public:
+  /// tell whether an error is worth retrying
+  using Classifier = std::function<bool(const std::exception&)>;
+
+  RetryPolicy(std::size_t tries, std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay);
+
+  std::size_t tries() const;
+
+  /**
+   * @brief The upper bound of the delay before a retry, starting from 1.
+   */
+  std::chrono::milliseconds maxDelayBefore(std::size_t retry) const;
+
+  /**
+   * @brief A random delay before a retry, starting from 1.
+   */
+  std::chrono::milliseconds delayBefore(std::size_t retry) const;
+
+  /**
+   * @brief Run a task until it succeeds, it fails with a fatal error, or the tries are exhausted.
+   * @details
+   * The attempts are recorded by the breaker, if any; when it is open, the task is not run,
+   * and the last error is rethrown, or a CircuitOpen exception if there is none.
+   * @throw The last error of the task.
+   */
+  void run(const std::function<void()>& task, const Classifier& retryable, CircuitBreaker* breaker = nullptr) const;
+
+private:
+  const std::size_t               m_tries;
+  const std::chrono::milliseconds m_initialDelay;
+  const std::chrono::milliseconds m_maxDelay;
+};
+
+/**
+ * @class CircuitOpen
+ * @ingroup ElementsServices
+ * @brief An exception raised when a host is not tried because its circuit breaker is open.
+ */
+class ELEMENTS_API CircuitOpen : public std::runtime_error {
+public:
+  virtual ~CircuitOpen() = default;
+  CircuitOpen() : std::runtime_error("The host failed repeatedly: it is not tried for a while") {}
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_RETRYPOLICY_H_
+
+/**@}*/
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_SYNCMANIFEST_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_SYNCMANIFEST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/Compression.h"
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief The metadata of a distant file, as reported by the host.
+ * @details
+ * The version is any string which changes when the file is modified,
+ * e.g. an ETag or a modification date.
+ * When the host cannot provide them, known is false.
+ */
+struct ELEMENTS_API RemoteMetadata {
+  bool           known{false};
+  std::uintmax_t size{0};
+  std::string    version{};
+};
+
+/**
+ * @brief The state of a synchronized file, as recorded in the manifest.
+ * @details
+ * The size is the one of the local file, and the remote size the one reported
+ * by the host: they differ for the files decompressed after the download.
+ */
+struct ELEMENTS_API ManifestEntry {
+  path           distantFile;
+  std::uintmax_t size;
+  std::uintmax_t remoteSize;
+  std::string    version;
+  std::uint64_t  hash;
+  std::int64_t   localTime;
+};
+
+/**
+ * @brief Fast non-cryptographic 64-bit hash of the content of a file.
+ */
+ELEMENTS_API std::uint64_t contentHash(path file);
+
+/**
+ * @brief The same hash for a character string, with a seed to get independent hashes.
+ */
+ELEMENTS_API std::uint64_t textHash(const std::string& text, std::uint64_t seed = 0);
+
+/**
+ * @brief Modification time of a local file, in nanoseconds since the epoch.
+ */
+ELEMENTS_API std::int64_t localModificationTime(path file);
+
+/**
+ * @class ManifestMismatch
+ * @brief A downloaded file does not match its recorded checksum.
+ */
+class ELEMENTS_API ManifestMismatch : public std::runtime_error {
+public:
+  virtual ~ManifestMismatch() = default;
+  ManifestMismatch(path distantFile, const std::string& reason)
+      : std::runtime_error("Verification of '" + distantFile.string() + "' failed: " + reason) {}
+};
+
+/**
+ * @class SyncManifest
+ * @ingroup ElementsServices
+ * @brief Sidecar database of the synchronized files.
+ * @details
+ * For each local file, the manifest records the distant file, its size,
+ * its version and the hash of its content at the time of the download,
+ * as well as the local modification time.
+ * A file is up to date when neither the distant file nor the local copy
+ * changed since then, which is checked without reading the file.
+ * The methods can be called concurrently by the download workers.
+ */
+class ELEMENTS_API SyncManifest {
+
+public:
+  /**
+   * @brief Load the manifest file if it exists.
+   */
+  explicit SyncManifest(path file);
+
+  SyncManifest(const SyncManifest&) = delete;
+  SyncManifest& operator=(const SyncManifest&) = delete;
+
+  path file() const;
+
+  std::size_t size() const;
+
+  /**
+   * @brief Check whether the local file is the current version of the distant file.
+   * @details
+   * False if the distant metadata are unknown.
+   */
+  bool isUpToDate(path distantFile, path localFile, const RemoteMetadata& remote) const;
+
+  /**
+   * @brief Hash a freshly downloaded file, verify it and record it.
+   * @details
+   * The size is checked against the distant metadata, unless the local file
+   * was decompressed, and the hash against the previous record of the same
+   * version, if any.
+   * @throw ManifestMismatch if the verification fails; the file is then forgotten.
+   */
+  void record(path distantFile, path localFile, const RemoteMetadata& remote,
+              Compression compression = Compression::NONE);
+
+  /**
+   * @brief Check whether the local file content still matches its record.
+   */
+  bool verify(path localFile) const;
+
+  void forget(path localFile);
+
+  /**
+   * @brief Write the manifest file, atomically.
+   */
+  void save() const;
+
+private:
+  void load();
+
+  const path                           m_file;
+  std::map<std::string, ManifestEntry> m_entries;
+  mutable std::mutex                   m_mutex;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_SYNCMANIFEST_H_
+
+/**@}*/
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @addtogroup ElementsServices ElementsServices
+ * @{
+ */
+
+#ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_TRANSFERMETRICS_H_
+#define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_TRANSFERMETRICS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ElementsKernel/Export.h"
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+/**
+ * @brief The measures of the synchronization of a file.
+ */
+struct ELEMENTS_API FileMetrics {
+
+  path distantFile;
+
+  path localFile;
+
+  /** The received bytes, or the size of the transferred file if the client does not report them */
+  std::uint64_t bytes{0};
+
+  /** The duration in seconds, retries included */
+  double seconds{0};
+
+  /** The time to first byte in seconds, negative if the client does not report it */
+  double firstByteSeconds{-1};
+
+  /** The number of download tries, 0 if the file was up to date or in the cache */
+  std::size_t tries{0};
+
+  bool succeeded{false};
+
+  /** Whether the file was not transferred: up to date, downloaded by another process or linked from the cache */
+  bool skipped{false};
+
+  /**
+   * @brief The throughput in bytes per second, 0 if unknown.
+   */
+  double throughput() const;
+};
+
+/**
+ * @brief The aggregate measures of a synchronization.
+ */
+struct ELEMENTS_API MetricsSummary {
+
+  /** The files which were submitted, including the ones which are not started yet */
+  std::size_t submitted{0};
+
+  std::size_t active{0};
+
+  std::size_t succeeded{0};
+
+  /** The succeeded files which were not transferred */
+  std::size_t skipped{0};
+
+  std::size_t failed{0};
+
+  std::uint64_t bytes{0};
+
+  /** The tries beyond the first one of each file */
+  std::size_t retries{0};
+
+  /** The duration in seconds since the beginning of the synchronization */
+  double seconds{0};
+
+  /**
+   * @brief The number of submitted files which are not started yet.
+   */
+  std::size_t queued() const;
+
+  /**
+   * @brief The throughput in bytes per second, 0 if unknown.
+   */
+  double throughput() const;
+};
+
+/**
+ * @class TransferMetrics
+ * @ingroup ElementsServices
+ * @brief The instrumentation of the transfers of a synchronizer.
+ * @details
+ * The transfers are measured by the threads which run them, and identified by the index returned by startFile().
+ * The progress is logged periodically as the bytes are received and the files are finished,
+ * so that a slow host can be told from a slow disk while the synchronization runs.
+ * The summary is logged and can be written as JSON at the end.
+ */
+class ELEMENTS_API TransferMetrics {
+
+public:
+  /**
+   * @param host The name of the host, written in the summary.
+   * @param progressPeriod The minimum duration between two progress logs; 0 means no progress log.
+   */
+  explicit TransferMetrics(const std::string& host,
+                           std::chrono::milliseconds progressPeriod = std::chrono::milliseconds(30000));
+
+  /**
+   * @brief Start a synchronization, and forget the previous one.
+   */
+  void begin();
+
+  /**
+   * @brief Declare files which will be synchronized, for the queue depth.
+   */
+  void submit(std::size_t count);
+
+  /**
+   * @brief Start measuring the synchronization of a file.
+   * @return The index of the file, for the other methods.
+   */
+  std::size_t startFile(path distantFile, path localFile);
+
+  /**
+   * @brief Record a download try of a file.
+   */
+  void recordTry(std::size_t file);
+
+  /**
+   * @brief Record received bytes of a file.
+   */
+  void recordBytes(std::size_t file, std::uint64_t bytes);
+
+  /**
+   * @brief Stop measuring the synchronization of a file.
+   * @param size The size of the file, if no bytes were recorded.
+   */
+  void finishFile(std::size_t file, bool succeeded, std::uint64_t size);
+
+  /**
+   * @brief Stop measuring the synchronization of a file which needed no transfer.
+   * @details
+   * The file succeeded, with no bytes.
+   */
+  void skipFile(std::size_t file);
+
+  /**
+   * @brief Record a file which was measured as a whole, e.g. as part of a batch.
+   */
+  void recordFile(const FileMetrics& metrics);
+
+  /**
+   * @brief End a synchronization, and log its summary.
+   */
+  void end() const;
+
+  MetricsSummary summary() const;
+
+  std::vector<FileMetrics> files() const;
+
+  /**
+   * @brief A one-line description of the progress.
+   */
+  std::string progressMessage() const;
+
+  /**
+   * @brief The summary and the measures of each file, as a JSON object.
+   */
+  std::string jsonSummary() const;
+
+  /**
+   * @brief Write the JSON summary to a file.
+   * @throw std::runtime_error if the file cannot be written.
+   */
+  void writeSummary(path file) const;
+
+private:
+  double elapsedSeconds(std::chrono::steady_clock::time_point since) const;
+
+  MetricsSummary summaryUnlocked() const;
+
+  std::string progressMessageUnlocked() const;
+
+  /**
+   * @brief Log the progress if the period is elapsed.
+   */
+  void logProgressIfDue();
+
+  mutable std::mutex                                 m_mutex;
+  std::string                                        m_host;
+  std::chrono::milliseconds                          m_progressPeriod;
+  std::chrono::steady_clock::time_point              m_begin;
+  std::chrono::steady_clock::time_point              m_nextProgress;
+  std::size_t                                        m_submitted;
+  std::vector<FileMetrics>                           m_files;
+  std::vector<std::chrono::steady_clock::time_point> m_starts;
+  std::vector<bool>                                  m_finished;
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+#endif  // ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_TRANSFERMETRICS_H_
+
+/**@}*/
@@ -24,9 +24,11 @@
 #ifndef ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_WEBDAVSYNCHRONIZER_H_
 #define ELEMENTSSERVICES_ELEMENTSSERVICES_DATASYNC_WEBDAVSYNCHRONIZER_H_
 
+#include <memory>
 #include <string>
 
 #include "ElementsKernel/Export.h"
+#include "ElementsKernel/Temporary.h"
 
 #include "ElementsServices/DataSync/DataSynchronizer.h"
 
@@ -39,11 +41,23 @@ namespace DataSync {
  */
 ELEMENTS_API bool webdavIsInstalled();
 
+/**
+ * @brief Read the metadata of a distant file from the HTTP headers printed by wget.
+ * @ingroup ElementsServices
+ * @details
+ * The last response is used, so that the redirections are followed.
+ * The version is the ETag, or the Last-Modified date if there is no ETag.
+ */
+ELEMENTS_API RemoteMetadata webdavMetadataFromHeaders(const std::string& headers);
+
 /**
  * @class WebdavSynchronizer
  * @ingroup ElementsServices
- * @brief A data synchronizer for WebDAV hosts.
- *
+ * @brief A data synchronizer for WebDAV hosts, through wget.
+ * @details
+ * The credentials are passed to wget through a private configuration file,
+ * not on the command line where the other users could read them.
+ * See createSynchronizer(), which prefers the native HTTP client when it is available.
  */
 class ELEMENTS_API WebdavSynchronizer : public DataSynchronizer {
 
@@ -53,6 +67,30 @@ public:
   WebdavSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency);
 
   std::string createDownloadCommand(path distantFile, path localFile) const override;
+
+  std::string createStreamingDownloadCommand(path distantFile) const override;
+
+  RemoteMetadata remoteMetadata(path distantFile) const override;
+
+protected:
+  /**
+   * @brief Classify the failures according to the exit status of wget.
+   */
+  bool failureIsRetryable(const CommandResult& result) const override;
+
+private:
+  /**
+   * @brief The wget command which writes a distant file to an output file, or to "-" for the standard output.
+   */
+  std::string createWgetCommand(path distantFile, const std::string& output) const;
+
+  /**
+   * @brief The wget invocation, with the private configuration file.
+   */
+  std::string wget() const;
+
+  /// wgetrc file with the credentials, readable by the owner only
+  std::shared_ptr<Elements::TempFile> m_wgetrc;
 };
 
 }  // namespace DataSync
@@ -16,18 +16,41 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+
+#include "ElementsKernel/Logging.h"
+
 #include "ElementsServices/DataSync.h"
 #include "ElementsServices/DataSync/DataSynchronizer.h"
 #include "ElementsServices/DataSync/DataSynchronizerMaker.h"
+#include "ElementsServices/DataSync/LazyDownloader.h"
 
 namespace ElementsServices {
 namespace DataSync {
 
+namespace {
+
+auto log = Elements::Logging::getLogger("DataSync");
+
+std::shared_ptr<DataSynchronizer> createFallbackSynchronizer(const ConnectionConfiguration& fallbackConfig,
+                                                             path localRoot, path dependencyFile) {
+  // the files of the fallback host are written in the same local workspace
+  const DependencyConfiguration fallbackDependencies(fallbackConfig.distantRoot, localRoot, dependencyFile);
+  return createSynchronizer(fallbackConfig, fallbackDependencies);
+}
+
+}  // namespace
+
 DataSync::DataSync(path connectionFile, path dependencyFile)
     : m_connectionConfig(connectionFile)
     , m_distantRoot(m_connectionConfig.distantRoot)
     , m_localRoot(m_connectionConfig.localRoot)
-    , m_dependencyConfig(m_distantRoot, m_localRoot, dependencyFile) {}
+    , m_dependencyFile(dependencyFile)
+    , m_dependencyConfig(m_distantRoot, m_localRoot, dependencyFile)
+    , m_lazyDownloader() {}
 
 void DataSync::download() {
   const auto& synchronizer = createSynchronizer(m_connectionConfig, m_dependencyConfig);
@@ -35,16 +58,45 @@ void DataSync::download() {
 }
 
 void DataSync::downloadWithFallback(path connectionFile) {
+  std::shared_ptr<DataSynchronizer> primary;
   try {
-    download();
+    primary = createSynchronizer(m_connectionConfig, m_dependencyConfig);
   } catch (std::exception& e) {
+    // e.g. the client of the primary host is not installed
     m_connectionConfig = ConnectionConfiguration(connectionFile);
-    download();
+    createFallbackSynchronizer(m_connectionConfig, m_localRoot, m_dependencyFile)->downloadAllFiles();
+    return;
+  }
+  try {
+    primary->setFallback(createFallbackSynchronizer(ConnectionConfiguration(connectionFile), m_localRoot,
+                                                    m_dependencyFile));
+  } catch (std::exception& e) {
+    // the primary host may provide all the files without it
+    log.warn("The fallback host is not available: " + std::string(e.what()));
+  }
+  primary->downloadAllFiles();
+}
+
+void DataSync::downloadLazily(bool prefetch) {
+  // the previous downloader, if any, is stopped first
+  m_lazyDownloader.reset();
+  const std::size_t prefetcherCount = prefetch ? m_connectionConfig.parallelTransfers : 0;
+  m_lazyDownloader = std::make_shared<LazyDownloader>(createSynchronizer(m_connectionConfig, m_dependencyConfig),
+                                                      m_dependencyConfig.localPathsInFileOrder(), prefetcherCount);
+}
+
+void DataSync::waitForDownloads() {
+  if (m_lazyDownloader) {
+    m_lazyDownloader->requireAll();
   }
 }
 
 path DataSync::absolutePath(path relativePath) {
-  return m_localRoot / relativePath;
+  const path localFile = m_localRoot / relativePath;
+  if (m_lazyDownloader) {
+    m_lazyDownloader->require(localFile);
+  }
+  return localFile;
 }
 
 }  // namespace DataSync
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>   // for open
+#include <unistd.h>  // for pwrite, ftruncate, fsync, close
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ElementsServices/DataSync/ChunkJournal.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+const std::string journalTag = "# elements-datasync chunks 1";
+
+std::runtime_error systemError(const std::string& message, path file) {
+  return std::runtime_error(message + ": " + file.string() + " (" + std::strerror(errno) + ")");
+}
+
+void flushData(int descriptor) {
+#ifdef __APPLE__
+  ::fsync(descriptor);
+#else
+  ::fdatasync(descriptor);
+#endif
+}
+
+}  // namespace
+
+void writeAt(int descriptor, std::uint64_t offset, const char* data, std::size_t size) {
+  while (size > 0) {
+    const auto written = ::pwrite(descriptor, data, size, static_cast<off_t>(offset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("Unable to write a chunk: ") + std::strerror(errno));
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+    offset += static_cast<std::uint64_t>(written);
+  }
+}
+
+ChunkJournal::ChunkJournal(path localFile, const RemoteMetadata& remote, std::uint64_t chunkSize)
+    : m_localFile(localFile)
+    , m_size(remote.size)
+    , m_chunkSize(std::max<std::uint64_t>(chunkSize, 1))
+    , m_done((m_size + m_chunkSize - 1) / m_chunkSize, false)
+    , m_descriptor(-1)
+    , m_journal()
+    , m_mutex() {
+  createLocalDirOf(localFile);
+  // a journal is only valid for the same version of the distant file, cut the same way
+  const std::string header =
+      journalTag + "\t" + std::to_string(m_size) + "\t" + std::to_string(m_chunkSize) + "\t" + remote.version;
+  if (not load(header)) {
+    restart(header);
+  }
+  m_journal.open(journalFile(m_localFile).c_str(), std::ios::app);
+  if (not m_journal) {
+    const auto error = systemError("Unable to open the chunk journal", journalFile(m_localFile));
+    ::close(m_descriptor);
+    throw error;
+  }
+}
+
+ChunkJournal::~ChunkJournal() {
+  if (m_descriptor >= 0) {
+    ::close(m_descriptor);
+  }
+}
+
+path ChunkJournal::partialFile(path localFile) {
+  return localFile.string() + ".part";
+}
+
+path ChunkJournal::journalFile(path localFile) {
+  return localFile.string() + ".part.journal";
+}
+
+std::size_t ChunkJournal::chunkCount() const {
+  return m_done.size();
+}
+
+ByteRange ChunkJournal::chunk(std::size_t index) const {
+  const std::uint64_t offset = index * m_chunkSize;
+  return {offset, std::min(m_chunkSize, m_size - offset)};
+}
+
+std::vector<std::size_t> ChunkJournal::pendingChunks() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<std::size_t>    pending;
+  for (std::size_t i = 0; i < m_done.size(); ++i) {
+    if (not m_done[i]) {
+      pending.push_back(i);
+    }
+  }
+  return pending;
+}
+
+int ChunkJournal::descriptor() const {
+  return m_descriptor;
+}
+
+void ChunkJournal::complete(std::size_t index) {
+  // the chunk is journaled only once its data cannot be lost
+  flushData(m_descriptor);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_done.at(index) = true;
+  m_journal << index << std::endl;
+}
+
+void ChunkJournal::commit() {
+  if (not pendingChunks().empty()) {
+    throw std::runtime_error("Unable to commit the partial file: some chunks are missing: " +
+                             partialFile(m_localFile).string());
+  }
+  ::fsync(m_descriptor);
+  ::close(m_descriptor);
+  m_descriptor = -1;
+  m_journal.close();
+  boost::filesystem::rename(partialFile(m_localFile), m_localFile);
+  boost::filesystem::remove(journalFile(m_localFile));
+}
+
+bool ChunkJournal::load(const std::string& header) {
+  const path    partial = partialFile(m_localFile);
+  std::ifstream journal(journalFile(m_localFile).c_str());
+  std::string   line;
+  if (not std::getline(journal, line) or line != header or not boost::filesystem::is_regular_file(partial) or
+      boost::filesystem::file_size(partial) != m_size) {
+    return false;
+  }
+  m_descriptor = ::open(partial.c_str(), O_RDWR);
+  if (m_descriptor < 0) {
+    return false;
+  }
+  // a line torn by an interruption is ignored: the chunk is downloaded again
+  while (std::getline(journal, line)) {
+    if (line.empty() or line.find_first_not_of("0123456789") != std::string::npos or line.size() > 18) {
+      continue;
+    }
+    const auto index = std::stoull(line);
+    if (index < m_done.size()) {
+      m_done[index] = true;
+    }
+  }
+  return true;
+}
+
+void ChunkJournal::restart(const std::string& header) {
+  // the journal is reset before the data, so that it never lists chunks which were not written
+  {
+    std::ofstream journal(journalFile(m_localFile).c_str(), std::ios::trunc);
+    journal << header << std::endl;
+    if (not journal) {
+      throw systemError("Unable to write the chunk journal", journalFile(m_localFile));
+    }
+  }
+  const path partial = partialFile(m_localFile);
+  m_descriptor       = ::open(partial.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_descriptor < 0) {
+    throw systemError("Unable to create the partial file", partial);
+  }
+  if (::ftruncate(m_descriptor, static_cast<off_t>(m_size)) != 0) {
+    const auto error = systemError("Unable to allocate the partial file", partial);
+    ::close(m_descriptor);
+    throw error;
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
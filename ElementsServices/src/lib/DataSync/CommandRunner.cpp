@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>         // for fcntl, O_CLOEXEC
+#include <poll.h>          // for poll
+#include <signal.h>        // for kill, sigset_t
+#include <spawn.h>         // for posix_spawn
+#include <sys/resource.h>  // for rusage
+#include <sys/socket.h>    // for socketpair, send
+#include <sys/wait.h>      // for wait4
+#include <unistd.h>        // for pipe, read, close
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ElementsServices/DataSync/CommandRunner.h"
+
+extern char** environ;
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A pipe which is closed at the execution of any child, except the one it was duplicated for.
+ * @details
+ * Otherwise, a child spawned concurrently by another thread would keep the write end open,
+ * and the end of the outputs would never be seen.
+ */
+class Pipe {
+
+public:
+  Pipe() {
+#ifdef __linux__
+    const int status = ::pipe2(m_ends, O_CLOEXEC);
+#else
+    // not atomic: the descriptors may leak to a child spawned meanwhile, which only delays the end of file
+    const int status = ::pipe(m_ends);
+    if (status == 0) {
+      ::fcntl(m_ends[0], F_SETFD, FD_CLOEXEC);
+      ::fcntl(m_ends[1], F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (status != 0) {
+      throw std::runtime_error(std::string("Unable to create a pipe: ") + std::strerror(errno));
+    }
+  }
+
+  Pipe(const Pipe&) = delete;
+  Pipe& operator=(const Pipe&) = delete;
+
+  ~Pipe() {
+    closeEnd(0);
+    closeEnd(1);
+  }
+
+  int readEnd() const {
+    return m_ends[0];
+  }
+
+  int writeEnd() const {
+    return m_ends[1];
+  }
+
+  void closeEnd(int end) {
+    if (m_ends[end] >= 0) {
+      ::close(m_ends[end]);
+      m_ends[end] = -1;
+    }
+  }
+
+private:
+  int m_ends[2] = {-1, -1};
+};
+
+/**
+ * @brief Spawn a shell command in its own process group.
+ * @param input The descriptor of the standard input, or -1 for /dev/null.
+ * @param outputFile If not empty, the file to which the standard output is written instead of the output descriptor.
+ */
+pid_t spawnShell(const std::string& command, int input, int output, int error, const std::string& outputFile = "") {
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (input >= 0) {
+    posix_spawn_file_actions_adddup2(&actions, input, 0);
+  } else {
+    posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+  }
+  if (outputFile.empty()) {
+    posix_spawn_file_actions_adddup2(&actions, output, 1);
+  } else {
+    posix_spawn_file_actions_addopen(&actions, 1, outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  }
+  posix_spawn_file_actions_adddup2(&actions, error, 2);
+
+  // a process group of its own, to kill the grandchildren too; and the default SIGPIPE behavior
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  sigset_t defaultSignals;
+  sigemptyset(&defaultSignals);
+  sigaddset(&defaultSignals, SIGPIPE);
+  posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+  posix_spawnattr_setpgroup(&attributes, 0);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF);
+
+  // posix_spawn does not modify the arguments, but takes them as non-const
+  char* const arguments[] = {const_cast<char*>("sh"), const_cast<char*>("-c"), const_cast<char*>(command.c_str()),
+                             nullptr};
+  pid_t       pid;
+  const int   status = ::posix_spawn(&pid, "/bin/sh", &actions, &attributes, arguments, environ);
+
+  posix_spawnattr_destroy(&attributes);
+  posix_spawn_file_actions_destroy(&actions);
+  if (status != 0) {
+    throw std::runtime_error("Unable to run command: " + command + " (" + std::strerror(status) + ")");
+  }
+  return pid;
+}
+
+/// the earliest deadline of the limits, or the maximum time point if there is no limit
+Clock::time_point deadlineOf(const CommandLimits& limits, Clock::time_point start, Clock::time_point lastOutput) {
+  auto deadline = Clock::time_point::max();
+  if (limits.wallTimeout.count() > 0) {
+    deadline = std::min(deadline, start + limits.wallTimeout);
+  }
+  if (limits.idleTimeout.count() > 0) {
+    deadline = std::min(deadline, lastOutput + limits.idleTimeout);
+  }
+  return deadline;
+}
+
+int millisecondsUntil(Clock::time_point deadline, Clock::time_point now) {
+  if (deadline == Clock::time_point::max()) {
+    return -1;
+  }
+  const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+  return static_cast<int>(std::min<decltype(remaining)>(remaining, std::numeric_limits<int>::max()));
+}
+
+/// wait for the end of the child, or kill its group at the deadline
+void reap(pid_t pid, Clock::time_point deadline, CommandResult& result, rusage& usage) {
+  int   status = 0;
+  pid_t reaped = 0;
+  if (not result.timedOut and deadline != Clock::time_point::max()) {
+    // the child may keep running after closing its outputs
+    for (;;) {
+      reaped = ::wait4(pid, &status, WNOHANG, &usage);
+      if (reaped > 0 or (reaped < 0 and errno != EINTR)) {
+        break;
+      }
+      if (Clock::now() >= deadline) {
+        result.timedOut = true;
+        ::kill(-pid, SIGKILL);
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  if (reaped <= 0) {
+    while (::wait4(pid, &status, 0, &usage) < 0 and errno == EINTR) {
+    }
+  }
+  if (WIFEXITED(status)) {
+    result.exitCode = WEXITSTATUS(status);
+  } else if (WIFSIGNALED(status)) {
+    result.signal = WTERMSIG(status);
+  }
+}
+
+double seconds(const timeval& time) {
+  return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) * 1e-6;
+}
+
+}  // namespace
+
+bool CommandResult::succeeded() const {
+  return not timedOut and signal == 0 and exitCode == 0;
+}
+
+std::string CommandResult::failure() const {
+  std::string description;
+  if (timedOut) {
+    description = "timed out after " + std::to_string(wallTime.count()) + " ms";
+  } else if (signal != 0) {
+    description = "killed by signal " + std::to_string(signal);
+  } else {
+    description = "exit code " + std::to_string(exitCode);
+  }
+  const auto end = err.find_last_not_of("\r\n");
+  if (end != std::string::npos) {
+    const auto begin = err.find_last_of('\n', end);
+    description += ": " + err.substr(begin == std::string::npos ? 0 : begin + 1, end - begin);
+  }
+  return description;
+}
+
+CommandResult runCommand(const std::string& command, const CommandLimits& limits, int outputDescriptor) {
+
+  Pipe        out;
+  Pipe        err;
+  const pid_t pid =
+      spawnShell(command, -1, outputDescriptor >= 0 ? outputDescriptor : out.writeEnd(), err.writeEnd());
+  out.closeEnd(1);
+  err.closeEnd(1);
+
+  CommandResult                     result;
+  const auto                        start      = Clock::now();
+  auto                              lastOutput = start;
+  std::array<pollfd, 2>             fds{{{out.readEnd(), POLLIN, 0}, {err.readEnd(), POLLIN, 0}}};
+  const std::array<Pipe*, 2>        pipes{{&out, &err}};
+  const std::array<std::string*, 2> sinks{{&result.out, &result.err}};
+  std::vector<char>                 buffer(64 * 1024);
+
+  // drain both outputs until their end, or until a deadline
+  int openCount = 2;
+  if (outputDescriptor >= 0) {
+    out.closeEnd(0);
+    fds[0].fd = -1;
+    --openCount;
+  }
+  while (openCount > 0) {
+    const auto now      = Clock::now();
+    const auto deadline = deadlineOf(limits, start, lastOutput);
+    if (now >= deadline) {
+      result.timedOut = true;
+      break;
+    }
+    if (::poll(fds.data(), fds.size(), millisecondsUntil(deadline, now)) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      result.timedOut = true;
+      break;
+    }
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+      if (fds[i].fd < 0 or fds[i].revents == 0) {
+        continue;
+      }
+      const auto size = ::read(fds[i].fd, buffer.data(), buffer.size());
+      if (size > 0) {
+        sinks[i]->append(buffer.data(), static_cast<std::size_t>(size));
+        lastOutput = Clock::now();
+      } else if (size == 0 or (errno != EINTR and errno != EAGAIN)) {
+        pipes[i]->closeEnd(0);
+        fds[i].fd = -1;
+        --openCount;
+      }
+    }
+  }
+
+  if (result.timedOut) {
+    ::kill(-pid, SIGKILL);
+  }
+  rusage usage{};
+  reap(pid, limits.wallTimeout.count() > 0 ? start + limits.wallTimeout : Clock::time_point::max(), result, usage);
+  result.wallTime      = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+  result.userTime      = seconds(usage.ru_utime);
+  result.systemTime    = seconds(usage.ru_stime);
+  result.maxResidentKb = usage.ru_maxrss;
+#ifdef __APPLE__
+  result.maxResidentKb /= 1024;  // in bytes
+#endif
+  return result;
+}
+
+PipedCommand::PipedCommand(const std::string& command, const std::string& outputFile)
+    : m_input(-1), m_error(-1), m_pid(-1), m_command(command) {
+
+  // a socket rather than a pipe: the writes fail with EPIPE instead of raising SIGPIPE if the command dies
+  int ends[2];
+#ifdef __linux__
+  const int status = ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, ends);
+#else
+  const int status = ::socketpair(AF_UNIX, SOCK_STREAM, 0, ends);
+  if (status == 0) {
+    ::fcntl(ends[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(ends[1], F_SETFD, FD_CLOEXEC);
+  }
+#endif
+  if (status != 0) {
+    throw std::runtime_error(std::string("Unable to create a socket pair: ") + std::strerror(errno));
+  }
+  // the command only reads, the caller only writes
+  ::shutdown(ends[0], SHUT_WR);
+  ::shutdown(ends[1], SHUT_RD);
+#ifdef SO_NOSIGPIPE
+  const int enabled = 1;
+  ::setsockopt(ends[1], SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+  Pipe err;
+  try {
+    m_pid = spawnShell(command, ends[0], -1, err.writeEnd(), outputFile);
+  } catch (...) {
+    ::close(ends[0]);
+    ::close(ends[1]);
+    throw;
+  }
+  ::close(ends[0]);
+  err.closeEnd(1);
+  m_input = ends[1];
+  m_error = ::fcntl(err.readEnd(), F_DUPFD_CLOEXEC, 0);
+}
+
+PipedCommand::~PipedCommand() {
+  if (m_pid > 0) {
+    ::kill(-m_pid, SIGKILL);
+    finish();
+  }
+}
+
+int PipedCommand::input() const {
+  return m_input;
+}
+
+void PipedCommand::write(const char* data, std::size_t size) {
+  while (size > 0) {
+#ifdef MSG_NOSIGNAL
+    const auto written = ::send(m_input, data, size, MSG_NOSIGNAL);
+#else
+    const auto written = ::send(m_input, data, size, 0);
+#endif
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Unable to write to the command: " + m_command + " (" + std::strerror(errno) + ")");
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+CommandResult PipedCommand::finish() {
+  CommandResult result;
+  if (m_input >= 0) {
+    ::close(m_input);
+    m_input = -1;
+  }
+  if (m_pid > 0) {
+    std::vector<char> buffer(4096);
+    for (;;) {
+      const auto size = ::read(m_error, buffer.data(), buffer.size());
+      if (size > 0) {
+        result.err.append(buffer.data(), static_cast<std::size_t>(size));
+      } else if (size == 0 or errno != EINTR) {
+        break;
+      }
+    }
+    rusage usage{};
+    reap(m_pid, Clock::time_point::max(), result, usage);
+    m_pid = -1;
+  }
+  if (m_error >= 0) {
+    ::close(m_error);
+    m_error = -1;
+  }
+  return result;
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
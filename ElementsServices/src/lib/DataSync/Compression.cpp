@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdexcept>
+#include <string>
+
+#include "ElementsServices/DataSync/Compression.h"
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+Compression compressionFromName(const std::string& name) {
+  const std::string uncased = lower(name);
+  if (uncased == "gzip" or uncased == "gz") {
+    return Compression::GZIP;
+  }
+  if (uncased == "zstd" or uncased == "zst") {
+    return Compression::ZSTD;
+  }
+  throw std::runtime_error("I don't know this compression: " + name);
+}
+
+std::string decompressionCommand(Compression compression) {
+  switch (compression) {
+  case Compression::GZIP:
+    return "gzip -dc";
+  case Compression::ZSTD:
+    return "zstd -dcq";
+  default:
+    return "cat";
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
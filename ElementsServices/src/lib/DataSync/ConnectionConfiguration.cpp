@@ -16,18 +16,43 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <boost/program_options.hpp>
 #include <string>
 #include <vector>
 
 #include "ElementsServices/DataSync/ConnectionConfiguration.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
+#include "ElementsServices/DataSync/ObjectCache.h"
 
 namespace ElementsServices {
 namespace DataSync {
 
 using std::string;
 
+namespace {
+
+bool parseFlag(const string& name, const string& value) {
+
+  using std::vector;
+
+  const vector<string> enabledOptions  = {"true", "yes", "y"};
+  const vector<string> disabledOptions = {"false", "no", "n"};
+
+  string uncased = lower(value);
+  if (valueIsListed(uncased, enabledOptions)) {
+    return true;
+  }
+  if (valueIsListed(uncased, disabledOptions)) {
+    return false;
+  }
+  throw std::runtime_error("I don't know this " + name + " policy: " + value);
+}
+
+}  // namespace
+
 ConnectionConfiguration::ConnectionConfiguration(const path& filename) {
   parseConfigurationFile(filename);
 }
@@ -36,6 +61,18 @@ bool ConnectionConfiguration::overwritingAllowed() const {
   return overwritingPolicy == OverwritingPolicy::OVERWRITE;
 }
 
+bool ConnectionConfiguration::incrementalSyncEnabled() const {
+  return incremental;
+}
+
+bool ConnectionConfiguration::objectCacheEnabled() const {
+  return useObjectCache;
+}
+
+bool ConnectionConfiguration::chunkedTransfersEnabled() const {
+  return chunkSize > 0;
+}
+
 void ConnectionConfiguration::parseConfigurationFile(const path& filename) {
   // @TODO clean function
 
@@ -43,14 +80,56 @@ void ConnectionConfiguration::parseConfigurationFile(const path& filename) {
 
   /* Declare options */
   po::options_description options{};
-  options.add_options()("host", po::value<string>(), "Hosting solution: iRODS or WebDAV (case insensitive)")(
+  options.add_options()("host", po::value<string>(), "Hosting solution: iRODS, WebDAV or HTTP (case insensitive)")(
       "host-url", po::value<string>()->default_value(""),
       "Host URL if needed")("user", po::value<string>()->default_value(""), "User name if needed")(
       "password", po::value<string>()->default_value(""), "Password if needed")(
       "overwrite", po::value<string>()->default_value("no"), "Allow overwriting local files if they already exist")(
       "distant-workspace", po::value<string>(), "Path to distant repository workspace")(
       "local-workspace", po::value<string>(),
-      "Path to local repository workspace")("tries", po::value<int>()->default_value(4), "Number of download tries");
+      "Path to local repository workspace")("tries", po::value<int>()->default_value(4), "Number of download tries")(
+      "retry-delay", po::value<int>()->default_value(500),
+      "Maximum delay in ms before the first retry, doubled at each retry (the actual delay is random)")(
+      "retry-max-delay", po::value<int>()->default_value(30000), "Maximum delay in ms between two tries")(
+      "breaker-threshold", po::value<int>()->default_value(5),
+      "Number of consecutive failures after which the host is considered degraded (0 to always try it)")(
+      "breaker-cooldown", po::value<int>()->default_value(60),
+      "Duration in seconds during which a degraded host is not tried")(
+      "parallel-transfers", po::value<int>()->default_value(1), "Number of concurrent downloads")(
+      "transfers-per-host", po::value<int>()->default_value(0),
+      "Maximum number of concurrent downloads from one host (0 for no limit)")(
+      "batch-size", po::value<int>()->default_value(100),
+      "Maximum number of files downloaded by a single command, for the hosts which support it (1 for no batching)")(
+      "timeout", po::value<int>()->default_value(0),
+      "Maximum duration in seconds of a download command, which is killed beyond (0 for no limit)")(
+      "idle-timeout", po::value<int>()->default_value(0),
+      "Maximum duration in seconds of a download command without any output (0 for no limit)")(
+      "chunk-size", po::value<int>()->default_value(64),
+      "Size in MB of the chunks of the large files, downloaded in parallel and resumed if interrupted "
+      "(0 to download the files at once)")(
+      "parallel-chunks", po::value<int>()->default_value(1),
+      "Number of concurrent chunk downloads per file (number of threads per file for iRODS)")(
+      "bandwidth", po::value<std::uint64_t>()->default_value(0),
+      "Maximum throughput in bytes per second of all the downloads of the process (0 for no limit)")(
+      "node-bandwidth", po::value<std::uint64_t>()->default_value(0),
+      "Maximum throughput in bytes per second of all the downloads of the node (0 for no limit)")(
+      "io-priority", po::value<string>()->default_value("normal"),
+      "Disk I/O priority of the downloads: normal, low or idle (Linux only)")(
+      "drop-cache", po::value<string>()->default_value("no"),
+      "Drop the downloaded files from the page cache, to preserve the cache of the running jobs")(
+      "progress-period", po::value<int>()->default_value(30),
+      "Minimum duration in seconds between two logs of the progress (0 for no progress log)")(
+      "metrics-file", po::value<string>()->default_value(""),
+      "Path to the JSON summary of the transfers written after each synchronization, "
+      "relative to the local workspace (no summary if empty)")(
+      "incremental", po::value<string>()->default_value("no"),
+      "Skip the files which did not change since the previous synchronization, according to the manifest")(
+      "check-certificate", po::value<string>()->default_value("no"),
+      "Verify the certificate of HTTPS hosts (native HTTP client only)")(
+      "cache", po::value<string>()->default_value("no"), "Share the downloaded files between the workspaces")(
+      "cache-dir", po::value<string>()->default_value(""),
+      "Path to the object cache, prefixed like the local workspace (default: ~/.cache/elements-datasync)")(
+      "cache-size", po::value<int>()->default_value(0), "Maximum size of the object cache in MB (0 for no limit)");
 
   /* Get config file path */
   path abs_path = confFilePath(filename);
@@ -70,9 +149,30 @@ void ConnectionConfiguration::parseConfigurationFile(const path& filename) {
   user     = vm["user"].as<string>();
   password = vm["password"].as<string>();
   parseOverwritingPolicy(vm["overwrite"].as<string>());
-  distantRoot = vm["distant-workspace"].as<string>();
-  localRoot   = localWorkspacePrefix() / vm["local-workspace"].as<string>();
-  tries       = static_cast<size_t>(vm["tries"].as<int>());
+  checkCertificate = parseFlag("check-certificate", vm["check-certificate"].as<string>());
+  parseIncrementalPolicy(vm["incremental"].as<string>());
+  parseObjectCache(vm["cache"].as<string>(), vm["cache-dir"].as<string>(), vm["cache-size"].as<int>());
+  parseIoPriority(vm["io-priority"].as<string>());
+  dropCache = parseFlag("drop-cache", vm["drop-cache"].as<string>());
+  distantRoot               = vm["distant-workspace"].as<string>();
+  localRoot                 = localWorkspacePrefix() / vm["local-workspace"].as<string>();
+  tries                     = static_cast<size_t>(std::max(vm["tries"].as<int>(), 1));
+  parallelTransfers         = static_cast<size_t>(std::max(vm["parallel-transfers"].as<int>(), 1));
+  transfersPerHost          = static_cast<size_t>(std::max(vm["transfers-per-host"].as<int>(), 0));
+  batchSize                 = static_cast<size_t>(std::max(vm["batch-size"].as<int>(), 1));
+  chunkSize                 = static_cast<std::uint64_t>(std::max(vm["chunk-size"].as<int>(), 0)) * 1024 * 1024;
+  parallelChunks            = static_cast<size_t>(std::max(vm["parallel-chunks"].as<int>(), 1));
+  commandLimits.wallTimeout = std::chrono::seconds(std::max(vm["timeout"].as<int>(), 0));
+  commandLimits.idleTimeout = std::chrono::seconds(std::max(vm["idle-timeout"].as<int>(), 0));
+  retryDelay                = std::chrono::milliseconds(std::max(vm["retry-delay"].as<int>(), 0));
+  retryMaxDelay             = std::chrono::milliseconds(std::max(vm["retry-max-delay"].as<int>(), 0));
+  breakerThreshold          = static_cast<size_t>(std::max(vm["breaker-threshold"].as<int>(), 0));
+  breakerCooldown           = std::chrono::seconds(std::max(vm["breaker-cooldown"].as<int>(), 0));
+  bandwidth                 = vm["bandwidth"].as<std::uint64_t>();
+  nodeBandwidth             = vm["node-bandwidth"].as<std::uint64_t>();
+  progressPeriod            = std::chrono::seconds(std::max(vm["progress-period"].as<int>(), 0));
+  const path metrics        = vm["metrics-file"].as<string>();
+  metricsFile               = (metrics.empty() or metrics.is_absolute()) ? metrics : localRoot / metrics;
 }
 
 void ConnectionConfiguration::parseHost(const string& name) {
@@ -81,6 +181,8 @@ void ConnectionConfiguration::parseHost(const string& name) {
     host = DataHost::IRODS;
   } else if (uncased == "webdav") {
     host = DataHost::WEBDAV;
+  } else if (uncased == "http" or uncased == "https") {
+    host = DataHost::HTTP;
   } else {
     throw UnknownHost(name);
   }
@@ -103,5 +205,28 @@ void ConnectionConfiguration::parseOverwritingPolicy(const string& policy) {
   }
 }
 
+void ConnectionConfiguration::parseIncrementalPolicy(const string& policy) {
+  incremental = parseFlag("incremental", policy);
+}
+
+void ConnectionConfiguration::parseObjectCache(const string& policy, const string& directory, int capacityMb) {
+  useObjectCache = parseFlag("cache", policy);
+  cacheRoot      = directory.empty() ? ObjectCache::defaultRoot() : localWorkspacePrefix() / directory;
+  cacheCapacity  = static_cast<std::uintmax_t>(std::max(capacityMb, 0)) * 1024 * 1024;
+}
+
+void ConnectionConfiguration::parseIoPriority(const string& priority) {
+  const string uncased = lower(priority);
+  if (uncased == "normal") {
+    ioPriority = IoPriority::NORMAL;
+  } else if (uncased == "low") {
+    ioPriority = IoPriority::LOW;
+  } else if (uncased == "idle") {
+    ioPriority = IoPriority::IDLE;
+  } else {
+    throw std::runtime_error("I don't know this I/O priority: " + priority);
+  }
+}
+
 }  // namespace DataSync
 }  // namespace ElementsServices
@@ -17,8 +17,6 @@
  */
 
 #include <algorithm>
-#include <array>
-#include <cstdio>
 #include <cstdlib>
 #include <string>
 #include <utility>
@@ -27,6 +25,7 @@
 #include "ElementsKernel/Configuration.h"
 #include "ElementsKernel/System.h"
 
+#include "ElementsServices/DataSync/CommandRunner.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 
 namespace ElementsServices {
@@ -43,18 +42,9 @@ bool checkCall(string command) {
   return status == 0;
 }
 
-std::pair<string, string> runCommandAndCaptureOutErr(string command) {
-  string                   out, err;
-  std::array<char, BUFSIZ> buffer;
-  std::shared_ptr<FILE>    cmdpipe(popen(command.c_str(), "r"), pclose);
-  if (not cmdpipe) {
-    throw std::runtime_error(string("Unable to run command: ") + command);
-  }
-  if (fgets(buffer.data(), BUFSIZ, cmdpipe.get()) != nullptr) {
-    out += buffer.data();
-  }
-  // @TODO get standard error
-  return std::make_pair(out, err);
+std::pair<string, string> runCommandAndCaptureOutErr(string command, const CommandLimits& limits) {
+  const auto result = runCommand(command, limits);
+  return std::make_pair(result.out, result.err);
 }
 
 bool localDirExists(path localDir) {
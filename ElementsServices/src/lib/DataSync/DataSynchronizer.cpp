@@ -16,26 +16,346 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <signal.h>  // for kill
+#include <unistd.h>  // for getpid, gethostname
+
 #include "ElementsKernel/Unused.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "ElementsKernel/Logging.h"
 
+#include "ElementsServices/DataSync/ChunkJournal.h"
+#include "ElementsServices/DataSync/CommandRunner.h"
+#include "ElementsServices/DataSync/Compression.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 #include "ElementsServices/DataSync/DataSynchronizer.h"
+#include "ElementsServices/DataSync/DownloadScheduler.h"
+#include "ElementsServices/DataSync/FileLock.h"
+#include "ElementsServices/DataSync/IoPolicy.h"
+#include "ElementsServices/DataSync/ObjectCache.h"
+#include "ElementsServices/DataSync/RateLimiter.h"
+#include "ElementsServices/DataSync/SyncManifest.h"
+#include "ElementsServices/DataSync/TransferMetrics.h"
 
 namespace ElementsServices {
 namespace DataSync {
 
+namespace {
+
+auto log = Elements::Logging::getLogger("DataSync");
+
+/**
+ * @brief The file measured by a thread, to which the received bytes and the tries are accounted.
+ */
+struct MeasuredFile {
+  TransferMetrics* metrics;
+  std::size_t      index;
+};
+
+thread_local MeasuredFile measuredFile{nullptr, 0};
+
+/**
+ * @brief The prefix of the staging directories of the batches of the node.
+ */
+std::string stagingPrefix() {
+  char host[256] = {};
+  ::gethostname(host, sizeof(host) - 1);
+  return ".datasync-batch-" + std::string(host) + "-";
+}
+
+path uniqueStagingDirectory(path parent) {
+  static std::atomic<unsigned> counter{0};
+  return parent / (stagingPrefix() + std::to_string(::getpid()) + "-" + std::to_string(counter++));
+}
+
+/**
+ * @brief Remove the staging directories of the dead processes of the node.
+ */
+void removeStaleStagingDirectories(path parent) {
+  const std::string         prefix = stagingPrefix();
+  boost::system::error_code error;
+  for (boost::filesystem::directory_iterator it(parent, error), end; not error and it != end; it.increment(error)) {
+    const std::string name = it->path().filename().string();
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    const auto pid = static_cast<pid_t>(std::atol(name.c_str() + prefix.size()));
+    if (pid > 0 and ::kill(pid, 0) != 0 and errno == ESRCH) {
+      boost::system::error_code ignored;
+      boost::filesystem::remove_all(it->path(), ignored);
+    }
+  }
+}
+
+/**
+ * @brief Measure the synchronization of a file by the current thread, as a failure unless succeed() is called.
+ */
+class MeasuredTransfer {
+
+public:
+  MeasuredTransfer(TransferMetrics& metrics, path distantFile, path localFile)
+      : m_previous(measuredFile), m_file{&metrics, metrics.startFile(distantFile, localFile)}, m_finished(false) {
+    measuredFile = m_file;
+  }
+
+  MeasuredTransfer(const MeasuredTransfer&) = delete;
+  MeasuredTransfer& operator=(const MeasuredTransfer&) = delete;
+
+  ~MeasuredTransfer() {
+    measuredFile = m_previous;
+    if (not m_finished) {
+      m_file.metrics->finishFile(m_file.index, false, 0);
+    }
+  }
+
+  void succeed(path localFile) {
+    boost::system::error_code error;
+    const auto                size = boost::filesystem::file_size(localFile, error);
+    m_file.metrics->finishFile(m_file.index, true, error ? 0 : size);
+    m_finished = true;
+  }
+
+  /// the file succeeded without being transferred
+  void skip() {
+    m_file.metrics->skipFile(m_file.index);
+    m_finished = true;
+  }
+
+private:
+  MeasuredFile m_previous;
+  MeasuredFile m_file;
+  bool         m_finished;
+};
+
+}  // namespace
+
 DataSynchronizer::DataSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency)
-    : m_connection(connection), m_fileMap(dependency.fileMap()) {}
+    : m_connection(connection)
+    , m_dependencies(dependency)
+    , m_breaker(std::make_shared<CircuitBreaker>(connection.breakerThreshold, connection.breakerCooldown))
+    , m_fallback()
+    , m_processLimiter(connection.bandwidth > 0 ? RateLimiter::processWide(connection.bandwidth) : nullptr)
+    , m_nodeLimiter(connection.nodeBandwidth > 0 ? RateLimiter::nodeWide(connection.nodeBandwidth) : nullptr)
+    , m_metrics(std::make_shared<TransferMetrics>(connection.hostUrl.empty() ? connection.distantRoot.string()
+                                                                             : connection.hostUrl,
+                                                  connection.progressPeriod)) {}
+
+std::string DownloadFailed::failureListMessage(const std::vector<DownloadFailure>& failures) {
+  std::string message = "Unable to download " + std::to_string(failures.size()) + " file(s):";
+  for (const auto& failure : failures) {
+    message += "\n - '" + failure.distantFile.string() + "' as: '" + failure.localFile.string() + "'";
+    if (not failure.reason.empty()) {
+      message += " (" + failure.reason + ")";
+    }
+  }
+  return message;
+}
 
 void DataSynchronizer::downloadAllFiles() const {
-  for (const auto& item : m_fileMap) {
-    const auto& localFile   = item.first;
-    const auto& distantFile = item.second;
-    if (fileShouldBeWritten(localFile)) {
-      downloadOneFile(distantFile, localFile);
+  // the session outlives the workers which use it
+  const auto        session = openSession();
+  DownloadScheduler scheduler(m_connection.parallelTransfers, m_connection.transfersPerHost);
+  const std::string host    = hostName();
+  FileBatch         files;
+  for (size_t i = 0; i < m_dependencies.dependencyCount(); ++i) {
+    const path localFile = m_dependencies.localPathAt(i);
+    if (dependencyShouldBeSynchronized(localFile)) {
+      files.emplace_back(m_dependencies.distantPathAt(i), localFile);
     }
   }
+  m_metrics->submit(files.size());
+  // the batches bypass the metadata of the files, which the manifest and the cache need
+  std::set<path> downloaded;
+  std::mutex     downloadedMutex;
+  if (not m_connection.incrementalSyncEnabled() and not session->cache) {
+    // the compressed files go through the decompressor one by one
+    FileBatch uncompressedFiles;
+    for (const auto& file : files) {
+      if (compressionOf(file.second) == Compression::NONE) {
+        uncompressedFiles.push_back(file);
+      }
+    }
+    const auto batches = groupInBatches(uncompressedFiles);
+    for (const auto& batch : batches) {
+      if (batch.size() > 1) {
+        scheduler.submit(host, batch.front().first, batch.front().second,
+                         [this, &batch, &downloaded, &downloadedMutex]() {
+                           const auto                  done = downloadBatch(batch);
+                           std::lock_guard<std::mutex> lock(downloadedMutex);
+                           downloaded.insert(done.begin(), done.end());
+                         });
+      }
+    }
+    scheduler.wait();
+  }
+  for (const auto& file : files) {
+    const path& distantFile = file.first;
+    const path& localFile   = file.second;
+    if (downloaded.count(localFile) == 0) {
+      SyncManifest&      manifest = session->manifest;
+      const ObjectCache* objects  = session->cache.get();
+      scheduler.submit(host, distantFile, localFile, [this, &manifest, objects, distantFile, localFile]() {
+        synchronizeOneFile(manifest, objects, distantFile, localFile);
+      });
+    }
+  }
+  const auto failures = scheduler.wait();
+  closeSession(*session);
+  if (not failures.empty()) {
+    throw DownloadFailed(failures);
+  }
+}
+
+const TransferMetrics& DataSynchronizer::metrics() const {
+  return *m_metrics;
+}
+
+std::unique_ptr<SyncSession> DataSynchronizer::openSession() const {
+  m_metrics->begin();
+  std::unique_ptr<SyncSession> session(new SyncSession(manifestFile()));
+  if (m_connection.objectCacheEnabled()) {
+    session->cache.reset(new ObjectCache(m_connection.cacheRoot, m_connection.cacheCapacity));
+  }
+  return session;
+}
+
+bool DataSynchronizer::dependencyShouldBeSynchronized(path localFile) const {
+  return m_connection.incrementalSyncEnabled() or fileShouldBeWritten(localFile);
+}
+
+void DataSynchronizer::synchronizeDependency(SyncSession& session, path localFile) const {
+  const size_t index = m_dependencies.indexOf(localFile);
+  if (index == m_dependencies.dependencyCount()) {
+    throw DownloadFailed("", localFile, "The file is not a dependency", false);
+  }
+  if (dependencyShouldBeSynchronized(localFile)) {
+    synchronizeOneFile(session.manifest, session.cache.get(), m_dependencies.distantPathAt(index), localFile);
+  }
+}
+
+void DataSynchronizer::closeSession(SyncSession& session) const {
+  if (m_connection.incrementalSyncEnabled()) {
+    session.manifest.save();
+  }
+  if (session.cache) {
+    session.cache->evict();
+  }
+  m_metrics->end();
+  if (not m_connection.metricsFile.empty()) {
+    try {
+      m_metrics->writeSummary(m_connection.metricsFile);
+    } catch (const std::exception& e) {
+      // the synchronization is not failed for its report
+      log.warn(e.what());
+    }
+  }
+}
+
+void DataSynchronizer::setFallback(std::shared_ptr<const DataSynchronizer> fallback) {
+  m_fallback = fallback;
+}
+
+std::string DataSynchronizer::hostName() const {
+  return m_connection.hostUrl;
+}
+
+RemoteMetadata DataSynchronizer::remoteMetadata(ELEMENTS_UNUSED path distantFile) const {
+  return RemoteMetadata();
+}
+
+path DataSynchronizer::manifestFile() const {
+  return m_connection.localRoot / ".datasync-manifest";
+}
+
+path DataSynchronizer::lockDirectory() const {
+  return m_connection.localRoot / ".datasync-locks";
+}
+
+void DataSynchronizer::synchronizeOneFile(SyncManifest& manifest, const ObjectCache* cache, path distantFile,
+                                          path localFile) const {
+  const bool       incremental = m_connection.incrementalSyncEnabled();
+  MeasuredTransfer transfer(*m_metrics, distantFile, localFile);
+  const DownloadLock lock(lockDirectory(), localFile);
+  if (lock.downloadedMeanwhile() or not dependencyShouldBeSynchronized(localFile)) {
+    // another process downloaded it while this one was waiting
+    transfer.skip();
+    return;
+  }
+  if (m_fallback and m_breaker->isOpen()) {
+    // the degraded host is not even asked for the metadata
+    m_fallback->fetchAsFallback(localFile);
+    if (incremental) {
+      manifest.forget(localFile);
+    }
+    lock.markDownloaded();
+    transfer.succeed(localFile);
+    return;
+  }
+  bool transferred = true;
+  try {
+    transferred = synchronizeFromHost(manifest, cache, distantFile, localFile);
+  } catch (const std::exception&) {
+    if (not m_fallback) {
+      throw;
+    }
+    m_fallback->fetchAsFallback(localFile);
+    if (incremental) {
+      manifest.forget(localFile);
+    }
+  }
+  lock.markDownloaded();
+  if (transferred) {
+    transfer.succeed(localFile);
+  } else {
+    transfer.skip();
+  }
+}
+
+bool DataSynchronizer::synchronizeFromHost(SyncManifest& manifest, const ObjectCache* cache, path distantFile,
+                                           path localFile) const {
+  const bool           incremental = m_connection.incrementalSyncEnabled();
+  const bool           chunked     = supportsRanges() and m_connection.chunkedTransfersEnabled();
+  const RemoteMetadata remote =
+      (incremental or chunked or cache != nullptr) ? remoteMetadata(distantFile) : RemoteMetadata();
+  if (incremental and manifest.isUpToDate(distantFile, localFile, remote)) {
+    return false;
+  }
+  bool transferred = true;
+  const Compression compression = compressionOf(localFile);
+  if (cache != nullptr and remote.known) {
+    // the decompressed objects are not shared with the compressed ones
+    const path source =
+        compression == Compression::NONE ? distantFile : distantFile.string() + "|" + decompressionCommand(compression);
+    // the object is shared: it is checked before entering the cache
+    transferred = false;
+    cache->provide(ObjectCache::objectKey(hostName(), source, remote), localFile,
+                   [this, &distantFile, &remote, compression, &transferred](path object) {
+                     transferred = true;
+                     fetchWithRetries(distantFile, object, remote, compression);
+                     if (compression == Compression::NONE and boost::filesystem::file_size(object) != remote.size) {
+                       throw DownloadFailed(distantFile, object);
+                     }
+                   });
+  } else {
+    fetchWithRetries(distantFile, localFile, remote, compression);
+  }
+  if (incremental) {
+    manifest.record(distantFile, localFile, remote, compression);
+  }
+  return transferred;
 }
 
 bool DataSynchronizer::fileShouldBeWritten(path localFile) const {
@@ -52,9 +372,19 @@ bool DataSynchronizer::fileAlreadyExists(path localFile) const {
 void DataSynchronizer::downloadOneFile(path distantFile, path localFile) const {
   std::string command = createDownloadCommand(distantFile, localFile);
   createLocalDirOf(localFile);
-  const auto outErr = runCommandAndCaptureOutErr(command);
+  // a link to a cached object is replaced, not written through
+  boost::filesystem::remove(localFile);
+  const auto result = runCommand(command, m_connection.commandLimits);
+  if (result.timedOut) {
+    boost::system::error_code error;
+    boost::filesystem::remove(localFile, error);
+    throw DownloadFailed(distantFile, localFile, result.failure());
+  }
   if (not hasBeenDownloaded(distantFile, localFile)) {
-    throw DownloadFailed(distantFile, localFile);
+    if (result.succeeded()) {
+      throw DownloadFailed(distantFile, localFile);
+    }
+    throw DownloadFailed(distantFile, localFile, result.failure(), failureIsRetryable(result));
   }
 }
 
@@ -65,5 +395,281 @@ bool DataSynchronizer::hasBeenDownloaded(ELEMENTS_UNUSED path distantFile, path
   return boost::filesystem::file_size(localFile) > 0;
 }
 
+void DataSynchronizer::fetchWithRetries(path distantFile, path localFile, const RemoteMetadata& remote,
+                                        Compression compression) const {
+  const RetryPolicy policy(m_connection.tries, m_connection.retryDelay, m_connection.retryMaxDelay);
+  policy.run(
+      [this, &distantFile, &localFile, &remote, compression]() {
+        if (measuredFile.metrics != nullptr) {
+          measuredFile.metrics->recordTry(measuredFile.index);
+        }
+        fetchOneFile(distantFile, localFile, remote, compression);
+      },
+      errorIsRetryable, m_breaker.get());
+}
+
+void DataSynchronizer::fetchAsFallback(path localFile) const {
+  const size_t index = m_dependencies.indexOf(localFile);
+  if (index == m_dependencies.dependencyCount()) {
+    throw DownloadFailed("", localFile, "The file is not a dependency of the fallback host", false);
+  }
+  const path           distantFile = m_dependencies.distantPathAt(index);
+  const bool           chunked     = supportsRanges() and m_connection.chunkedTransfersEnabled();
+  const RemoteMetadata remote      = chunked ? remoteMetadata(distantFile) : RemoteMetadata();
+  fetchWithRetries(distantFile, localFile, remote, m_dependencies.compressionAt(index));
+}
+
+void DataSynchronizer::throttle(std::uint64_t bytes) const {
+  if (measuredFile.metrics != nullptr) {
+    measuredFile.metrics->recordBytes(measuredFile.index, bytes);
+  }
+  if (m_processLimiter) {
+    m_processLimiter->acquire(bytes);
+  }
+  if (m_nodeLimiter) {
+    m_nodeLimiter->acquire(bytes);
+  }
+}
+
+bool DataSynchronizer::failureIsRetryable(ELEMENTS_UNUSED const CommandResult& result) const {
+  return true;
+}
+
+bool DataSynchronizer::errorIsRetryable(const std::exception& error) {
+  const auto failure = dynamic_cast<const DownloadFailed*>(&error);
+  return failure != nullptr and failure->retryable();
+}
+
+Compression DataSynchronizer::compressionOf(path localFile) const {
+  return m_dependencies.compressionOf(localFile);
+}
+
+std::string DataSynchronizer::createStreamingDownloadCommand(ELEMENTS_UNUSED path distantFile) const {
+  return "";
+}
+
+void DataSynchronizer::downloadDecompressed(path distantFile, path localFile, Compression compression) const {
+  const std::string command = createStreamingDownloadCommand(distantFile);
+  if (command.empty()) {
+    // decompressed at once, then removed
+    const path compressedFile = localFile.string() + ".compressed";
+    downloadOneFile(distantFile, compressedFile);
+    CommandResult result;
+    {
+      // the paths are not given to the shell
+      PipedCommand      decompressor(decompressionCommand(compression), localFile.string());
+      std::ifstream     compressed(compressedFile.string(), std::ios::binary);
+      std::vector<char> buffer(1 << 16);
+      try {
+        while (compressed.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) or
+               compressed.gcount() > 0) {
+          decompressor.write(buffer.data(), static_cast<std::size_t>(compressed.gcount()));
+        }
+      } catch (const std::runtime_error&) {
+        // the decompressor stopped reading: its result tells why
+      }
+      result = decompressor.finish();
+    }
+    boost::system::error_code error;
+    boost::filesystem::remove(compressedFile, error);
+    if (not result.succeeded()) {
+      boost::filesystem::remove(localFile, error);
+      throw DownloadFailed(distantFile, localFile, "Decompression failed with " + result.failure());
+    }
+    return;
+  }
+  createLocalDirOf(localFile);
+  // a link to a cached object is replaced, not written through
+  boost::filesystem::remove(localFile);
+  CommandResult download;
+  CommandResult decompression;
+  {
+    // the decompressor reads the download as it is written
+    PipedCommand decompressor(decompressionCommand(compression), localFile.string());
+    download      = runCommand(command, m_connection.commandLimits, decompressor.input());
+    decompression = decompressor.finish();
+  }
+  if (not download.succeeded() or not decompression.succeeded()) {
+    boost::system::error_code error;
+    boost::filesystem::remove(localFile, error);
+  }
+  if (not download.succeeded()) {
+    throw DownloadFailed(distantFile, localFile, download.failure(), download.timedOut or failureIsRetryable(download));
+  }
+  if (not decompression.succeeded()) {
+    // e.g. a truncated download, which may succeed next time
+    throw DownloadFailed(distantFile, localFile, "Decompression failed with " + decompression.failure());
+  }
+}
+
+std::vector<FileBatch> DataSynchronizer::groupInBatches(const FileBatch& files) const {
+  std::vector<FileBatch> batches;
+  for (const auto& file : files) {
+    batches.push_back({file});
+  }
+  return batches;
+}
+
+std::string DataSynchronizer::createBatchDownloadCommand(ELEMENTS_UNUSED const FileBatch& batch) const {
+  throw std::runtime_error("The host does not support batches");
+}
+
+std::vector<path> DataSynchronizer::downloadBatch(const FileBatch& batch) const {
+  std::vector<path> downloaded;
+  const auto        start = std::chrono::steady_clock::now();
+  // the files which another process is downloading are left to the one-by-one downloads, which wait for it
+  std::vector<std::unique_ptr<DownloadLock>> locks;
+  FileBatch                                  lockedFiles;
+  FileBatch                                  stagedFiles;
+  const path                                 parent  = batch.front().second.parent_path();
+  const path                                 staging = uniqueStagingDirectory(parent);
+  for (const auto& file : batch) {
+    auto lock = DownloadLock::tryLock(lockDirectory(), file.second);
+    if (lock) {
+      locks.push_back(std::move(lock));
+      lockedFiles.push_back(file);
+      stagedFiles.emplace_back(file.first, staging / file.second.filename());
+    }
+  }
+  if (stagedFiles.empty()) {
+    return downloaded;
+  }
+  boost::system::error_code error;
+  bool                      succeeded = false;
+  try {
+    setThreadIoPriority(m_connection.ioPriority);
+    removeStaleStagingDirectories(parent);
+    boost::filesystem::create_directories(staging);
+    succeeded = runCommand(createBatchDownloadCommand(stagedFiles), m_connection.commandLimits).succeeded();
+  } catch (const std::exception&) {
+    boost::filesystem::remove_all(staging, error);
+    return downloaded;
+  }
+  // the files of the batch share its duration
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  for (std::size_t i = 0; i < stagedFiles.size(); ++i) {
+    const path& distantFile = lockedFiles[i].first;
+    const path& localFile   = lockedFiles[i].second;
+    const path& stagedFile  = stagedFiles[i].second;
+    if (hasBeenDownloaded(distantFile, stagedFile) and
+        (succeeded or stagedFileIsComplete(distantFile, stagedFile))) {
+      if (m_connection.dropCache) {
+        releasePageCache(stagedFile);
+      }
+      createLocalDirOf(localFile);
+      boost::filesystem::rename(stagedFile, localFile);
+      locks[i]->markDownloaded();
+      downloaded.push_back(localFile);
+      FileMetrics metrics;
+      metrics.distantFile = distantFile;
+      metrics.localFile   = localFile;
+      metrics.bytes       = boost::filesystem::file_size(localFile);
+      metrics.seconds     = elapsed.count();
+      metrics.tries       = 1;
+      metrics.succeeded   = true;
+      m_metrics->recordFile(metrics);
+    }
+  }
+  boost::filesystem::remove_all(staging, error);
+  return downloaded;
+}
+
+bool DataSynchronizer::stagedFileIsComplete(path distantFile, path stagedFile) const {
+  // after a failed batch, the file being written when it stopped is shorter than the distant one
+  const RemoteMetadata remote = remoteMetadata(distantFile);
+  boost::system::error_code error;
+  const auto                size = boost::filesystem::file_size(stagedFile, error);
+  return remote.known and not error and size == remote.size;
+}
+
+bool DataSynchronizer::supportsRanges() const {
+  return false;
+}
+
+void DataSynchronizer::downloadRange(ELEMENTS_UNUSED path distantFile, ELEMENTS_UNUSED const RemoteMetadata& remote,
+                                     ELEMENTS_UNUSED ByteRange range, ELEMENTS_UNUSED int descriptor) const {
+  throw std::runtime_error("The host does not support ranges");
+}
+
+void DataSynchronizer::fetchOneFile(path distantFile, path localFile, const RemoteMetadata& remote,
+                                    Compression compression) const {
+  // the download commands inherit the priority of the worker
+  setThreadIoPriority(m_connection.ioPriority);
+  if (compression == Compression::NONE and supportsRanges() and m_connection.chunkedTransfersEnabled() and
+      remote.known and remote.size > m_connection.chunkSize) {
+    // the journal renames its partial file into place
+    downloadInChunks(distantFile, localFile, remote);
+    return;
+  }
+  // the local file is complete or absent, whatever the other processes see
+  const path partialFile = uniquePartialPath(localFile);
+  try {
+    if (compression != Compression::NONE) {
+      downloadDecompressed(distantFile, partialFile, compression);
+    } else {
+      downloadOneFile(distantFile, partialFile);
+    }
+  } catch (...) {
+    boost::system::error_code error;
+    boost::filesystem::remove(partialFile, error);
+    throw;
+  }
+  if (m_connection.dropCache) {
+    releasePageCache(partialFile);
+  }
+  boost::filesystem::rename(partialFile, localFile);
+}
+
+void DataSynchronizer::downloadInChunks(path distantFile, path localFile, const RemoteMetadata& remote) const {
+
+  ChunkJournal journal(localFile, remote, m_connection.chunkSize);
+  const auto   pending = journal.pendingChunks();
+
+  // the chunks are dispatched one by one to the threads, which stop at their first failure
+  std::atomic<std::size_t> next{0};
+  std::vector<std::string> errors;
+  std::mutex               errorsMutex;
+  const MeasuredFile       measured = measuredFile;
+  auto                     work     = [&]() {
+    // the bytes of the chunks are accounted to the file
+    measuredFile = measured;
+    setThreadIoPriority(m_connection.ioPriority);
+    for (std::size_t i = next++; i < pending.size(); i = next++) {
+      try {
+        const ByteRange range = journal.chunk(pending[i]);
+        downloadRange(distantFile, remote, range, journal.descriptor());
+        journal.complete(pending[i]);
+        if (m_connection.dropCache) {
+          releasePageCache(journal.descriptor(), range.offset, range.length);
+        }
+      } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(errorsMutex);
+        errors.push_back(e.what());
+        return;
+      }
+    }
+  };
+
+  const std::size_t        threadCount = std::min(m_connection.parallelChunks, pending.size());
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < threadCount; ++t) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (not errors.empty()) {
+    const auto remaining = journal.pendingChunks().size();
+    throw DownloadFailed(distantFile, localFile,
+                         errors.front() + " (" + std::to_string(remaining) + " of " +
+                             std::to_string(journal.chunkCount()) + " chunks to resume)");
+  }
+  // a link to a cached object is replaced, not written through
+  boost::filesystem::remove(localFile);
+  journal.commit();
+}
+
 }  // namespace DataSync
 }  // namespace ElementsServices
@@ -29,7 +29,13 @@ std::shared_ptr<DataSynchronizer> createSynchronizer(ConnectionConfiguration con
   case DataHost::IRODS:
     return make_shared<IrodsSynchronizer>(connection, dependency);
   case DataHost::WEBDAV:
+    // the native client downloads the files of a WebDAV host without a process per file
+    if (httpIsAvailable(lower(connection.hostUrl).compare(0, 8, "https://") == 0)) {
+      return make_shared<HttpSynchronizer>(connection, dependency);
+    }
     return make_shared<WebdavSynchronizer>(connection, dependency);
+  case DataHost::HTTP:
+    return make_shared<HttpSynchronizer>(connection, dependency);
   default:
     throw UnknownHost();
   }
@@ -16,91 +16,295 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
-#include <fstream>
-#include <map>
-#include <string>
-#include <vector>
+#include <algorithm>   // for count, inplace_merge, lower_bound, sort, stable_sort
+#include <cstddef>     // for ptrdiff_t
+#include <cstring>     // for memchr
+#include <fcntl.h>     // for open, O_RDONLY
+#include <map>         // for map
+#include <stdexcept>   // for out_of_range
+#include <string>      // for string
+#include <sys/mman.h>  // for mmap, madvise, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#include <vector>      // for vector
+
+#include <boost/utility/string_ref.hpp>  // for string_ref
 
 #include "ElementsServices/DataSync/DependencyConfiguration.h"
 
 namespace ElementsServices {
 namespace DataSync {
 
+using boost::string_ref;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * @brief A read-only mapping of a whole file, which is empty if the file cannot be read.
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const path& filename) : m_data(MAP_FAILED), m_size(0) {
+    const int descriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+      return;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) == 0 and status.st_size > 0) {
+      m_size = static_cast<size_t>(status.st_size);
+      m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (m_data != MAP_FAILED) {
+        ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+      }
+    }
+    ::close(descriptor);
+  }
+
+  ~MappedFile() {
+    if (m_data != MAP_FAILED) {
+      ::munmap(m_data, m_size);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  string_ref content() const {
+    if (m_data == MAP_FAILED) {
+      return string_ref();
+    }
+    return string_ref(static_cast<const char*>(m_data), m_size);
+  }
+
+private:
+  void*  m_data;
+  size_t m_size;
+};
+
+}  // namespace
+
 DependencyConfiguration::DependencyConfiguration(path distantRoot, path localRoot, path configFile)
-    : m_aliasSeparator('\t'), m_distantRoot(distantRoot), m_localRoot(localRoot), m_fileMap() {
+    : m_aliasSeparator('\t')
+    , m_distantRoot(distantRoot)
+    , m_localRoot(localRoot)
+    , m_localPrefix((localRoot / "x").string())
+    , m_names()
+    , m_entries()
+    , m_sortedCount(0)
+    , m_addedCount(0) {
+  // the local paths are looked up by their names relative to the root
+  m_localPrefix.pop_back();
   parseConfigurationFile(configFile);
 }
 
 std::map<path, path> DependencyConfiguration::fileMap() const {
-  return m_fileMap;
+  std::map<path, path> file_map;
+  for (size_t i = 0; i < dependencyCount(); ++i) {
+    file_map.emplace(localPathAt(i), distantPathAt(i));
+  }
+  return file_map;
 }
 
 path DependencyConfiguration::distantPathOf(path localFile) const {
-  return m_fileMap.at(localFile);  // @TODO error handling
+  const size_t index = indexOf(localFile);
+  if (index == dependencyCount()) {
+    throw std::out_of_range("Not a dependency: " + localFile.string());
+  }
+  return distantPathAt(index);
 }
 
 size_t DependencyConfiguration::dependencyCount() const {
-  return m_fileMap.size();
+  return m_sortedCount;
+}
+
+size_t DependencyConfiguration::indexOf(const path& localFile) const {
+  const string& file = localFile.string();
+  if (file.compare(0, m_localPrefix.size(), m_localPrefix) != 0) {
+    return dependencyCount();
+  }
+  const string_ref name     = string_ref(file).substr(m_localPrefix.size());
+  const auto       isBefore = [this](const Entry& entry, string_ref other) {
+    return localNameOf(entry) < other;
+  };
+  const auto sorted  = m_entries.begin() + static_cast<std::ptrdiff_t>(m_sortedCount);
+  const auto matches = std::lower_bound(m_entries.begin(), sorted, name, isBefore);
+  if (matches == sorted or localNameOf(*matches) != name) {
+    return dependencyCount();
+  }
+  return static_cast<size_t>(matches - m_entries.begin());
+}
+
+path DependencyConfiguration::localPathAt(size_t index) const {
+  return m_localRoot / localNameOf(m_entries.at(index)).to_string();
+}
+
+path DependencyConfiguration::distantPathAt(size_t index) const {
+  return m_distantRoot / distantNameOf(m_entries.at(index)).to_string();
+}
+
+Compression DependencyConfiguration::compressionAt(size_t index) const {
+  return m_entries.at(index).compression;
 }
 
 vector<path> DependencyConfiguration::distantPaths() const {
   vector<path> distant_paths;
-  for (const auto& item : m_fileMap) {
-    distant_paths.emplace_back(item.second);
+  distant_paths.reserve(dependencyCount());
+  for (size_t i = 0; i < dependencyCount(); ++i) {
+    distant_paths.emplace_back(distantPathAt(i));
   }
   return distant_paths;
 }
 
 vector<path> DependencyConfiguration::localPaths() const {
   vector<path> local_paths;
-  for (const auto& item : m_fileMap) {
-    local_paths.emplace_back(item.first);
+  local_paths.reserve(dependencyCount());
+  for (size_t i = 0; i < dependencyCount(); ++i) {
+    local_paths.emplace_back(localPathAt(i));
   }
   return local_paths;
 }
 
-void DependencyConfiguration::parseConfigurationFile(path filename) {
-  path          abs_path = confFilePath(filename);
-  std::ifstream inputStream(abs_path.c_str());
-  string        line;
-  while (std::getline(inputStream, line)) {
-    parseConfigurationLine(line);
+vector<path> DependencyConfiguration::localPathsInFileOrder() const {
+  vector<size_t> indices(dependencyCount());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = i;
   }
+  std::sort(indices.begin(), indices.end(), [this](size_t lhs, size_t rhs) {
+    return m_entries[lhs].order < m_entries[rhs].order;
+  });
+  vector<path> local_paths;
+  local_paths.reserve(indices.size());
+  for (size_t i : indices) {
+    local_paths.emplace_back(localPathAt(i));
+  }
+  return local_paths;
 }
 
-void DependencyConfiguration::parseConfigurationLine(string line) {
-  if (lineHasAlias(line)) {
-    parseLineWithAlias(line);
-  } else {
-    parseLineWithoutAlias(line);
+std::map<path, Compression> DependencyConfiguration::compressions() const {
+  std::map<path, Compression> file_compressions;
+  for (size_t i = 0; i < dependencyCount(); ++i) {
+    if (compressionAt(i) != Compression::NONE) {
+      file_compressions.emplace(localPathAt(i), compressionAt(i));
+    }
+  }
+  return file_compressions;
+}
+
+Compression DependencyConfiguration::compressionOf(path localFile) const {
+  const size_t index = indexOf(localFile);
+  return index == dependencyCount() ? Compression::NONE : compressionAt(index);
+}
+
+void DependencyConfiguration::parseConfigurationFile(path filename) {
+  const MappedFile file(confFilePath(filename));
+  string_ref       content = file.content();
+  // the names are at most as long as the lines
+  m_names.reserve(m_names.size() + content.size());
+  m_entries.reserve(m_entries.size() + static_cast<size_t>(std::count(content.begin(), content.end(), '\n')) + 1);
+  while (not content.empty()) {
+    const auto   end    = static_cast<const char*>(std::memchr(content.data(), '\n', content.size()));
+    const size_t length = end == nullptr ? content.size() : static_cast<size_t>(end - content.data());
+    appendLine(content.substr(0, length));
+    content.remove_prefix(std::min(length + 1, content.size()));
   }
+  sortDependencies();
+}
+
+void DependencyConfiguration::parseConfigurationLine(string_ref line) {
+  appendLine(line);
+  sortDependencies();
 }
 
 char DependencyConfiguration::aliasSeparator() const {
   return m_aliasSeparator;
 }
 
-bool DependencyConfiguration::lineHasAlias(string line) const {
-  string::size_type offset = line.find(m_aliasSeparator);
-  return offset != string::npos;
+bool DependencyConfiguration::lineHasAlias(string_ref line) const {
+  return line.find(m_aliasSeparator) != string_ref::npos;
+}
+
+void DependencyConfiguration::parseLineWithAlias(string_ref line) {
+  appendLineWithAlias(line);
+  sortDependencies();
+}
+
+void DependencyConfiguration::parseLineWithoutAlias(string_ref line) {
+  addDependency(line, line);
+  sortDependencies();
+}
+
+void DependencyConfiguration::addDependency(string_ref localName, string_ref distantName, Compression compression) {
+  Entry entry;
+  entry.localOffset = m_names.size();
+  entry.localSize   = localName.size();
+  m_names.append(localName.data(), localName.size());
+  if (distantName.data() == localName.data() and distantName.size() == localName.size()) {
+    // a line without alias stores its name once
+    entry.distantOffset = entry.localOffset;
+  } else {
+    entry.distantOffset = m_names.size();
+    m_names.append(distantName.data(), distantName.size());
+  }
+  entry.distantSize = distantName.size();
+  entry.order       = m_addedCount++;
+  entry.compression = compression;
+  m_entries.push_back(entry);
+}
+
+void DependencyConfiguration::sortDependencies() {
+  const auto byLocalName = [this](const Entry& lhs, const Entry& rhs) {
+    return localNameOf(lhs) < localNameOf(rhs);
+  };
+  const auto added = m_entries.begin() + static_cast<std::ptrdiff_t>(m_sortedCount);
+  // the stable sort and merge keep the duplicates in the order of the lines
+  std::stable_sort(added, m_entries.end(), byLocalName);
+  std::inplace_merge(m_entries.begin(), added, m_entries.end(), byLocalName);
+  // the last line wins, at the position of the first one
+  size_t kept = 0;
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    if (kept > 0 and localNameOf(m_entries[kept - 1]) == localNameOf(m_entries[i])) {
+      const size_t order        = m_entries[kept - 1].order;
+      m_entries[kept - 1]       = m_entries[i];
+      m_entries[kept - 1].order = order;
+    } else {
+      m_entries[kept++] = m_entries[i];
+    }
+  }
+  m_entries.resize(kept);
+  m_sortedCount = kept;
+}
+
+void DependencyConfiguration::appendLine(string_ref line) {
+  if (line.empty()) {
+    return;
+  }
+  if (lineHasAlias(line)) {
+    appendLineWithAlias(line);
+  } else {
+    addDependency(line, line);
+  }
+}
+
+void DependencyConfiguration::appendLineWithAlias(string_ref line) {
+  const size_t      offset       = line.find(m_aliasSeparator);
+  const string_ref  distantName  = line.substr(0, offset);
+  const string_ref  aliasAndFlag = offset == string_ref::npos ? line : line.substr(offset + 1);
+  const size_t      flagOffset   = aliasAndFlag.find(m_aliasSeparator);
+  const string_ref  localName    = aliasAndFlag.substr(0, flagOffset);
+  const Compression compression  = flagOffset == string_ref::npos
+                                       ? Compression::NONE
+                                       : compressionFromName(aliasAndFlag.substr(flagOffset + 1).to_string());
+  addDependency(localName, distantName, compression);
 }
 
-void DependencyConfiguration::parseLineWithAlias(string line) {
-  string::size_type offset          = line.find(m_aliasSeparator);
-  const string      distantFilename = line.substr(0, offset);
-  const string      localFilename   = line.substr(offset + 1);
-  const path        distantPath     = m_distantRoot / distantFilename;
-  const path        localPath       = m_localRoot / localFilename;
-  m_fileMap[localPath]              = distantPath;
+string_ref DependencyConfiguration::localNameOf(const Entry& entry) const {
+  return string_ref(m_names.data() + entry.localOffset, entry.localSize);
 }
 
-void DependencyConfiguration::parseLineWithoutAlias(string line) {
-  const path distantPath = m_distantRoot / line;
-  const path localPath   = m_localRoot / line;
-  m_fileMap[localPath]   = distantPath;
+string_ref DependencyConfiguration::distantNameOf(const Entry& entry) const {
+  return string_ref(m_names.data() + entry.distantOffset, entry.distantSize);
 }
 
 }  // namespace DataSync
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "ElementsServices/DataSync/DownloadScheduler.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ElementsServices {
+namespace DataSync {
+
+DownloadScheduler::DownloadScheduler(std::size_t workerCount, std::size_t hostLimit, std::size_t queueCapacity)
+    : m_hostLimit(hostLimit)
+    , m_queueCapacity(queueCapacity > 0 ? queueCapacity : 2 * std::max<std::size_t>(workerCount, 1))
+    , m_activeCount(0)
+    , m_stopping(false) {
+  const std::size_t count = std::max<std::size_t>(workerCount, 1);
+  for (std::size_t i = 0; i < count; ++i) {
+    m_workers.emplace_back(&DownloadScheduler::work, this);
+  }
+}
+
+DownloadScheduler::~DownloadScheduler() {
+  wait();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_jobAvailable.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void DownloadScheduler::submit(const std::string& host, path distantFile, path localFile, Task task) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_slotAvailable.wait(lock, [this]() {
+    return m_queue.size() < m_queueCapacity;
+  });
+  m_queue.push_back(Job{host, distantFile, localFile, std::move(task)});
+  lock.unlock();
+  m_jobAvailable.notify_one();
+}
+
+std::vector<DownloadFailure> DownloadScheduler::wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_allDone.wait(lock, [this]() {
+    return m_queue.empty() and m_activeCount == 0;
+  });
+  std::vector<DownloadFailure> failures;
+  failures.swap(m_failures);
+  return failures;
+}
+
+std::size_t DownloadScheduler::workerCount() const {
+  return m_workers.size();
+}
+
+bool DownloadScheduler::hasRunnableJob() const {
+  if (m_hostLimit == 0) {
+    return not m_queue.empty();
+  }
+  return std::any_of(m_queue.begin(), m_queue.end(), [this](const Job& job) {
+    const auto active = m_activePerHost.find(job.host);
+    return active == m_activePerHost.end() or active->second < m_hostLimit;
+  });
+}
+
+std::deque<DownloadScheduler::Job>::iterator DownloadScheduler::nextRunnableJob() {
+  if (m_hostLimit == 0) {
+    return m_queue.begin();
+  }
+  return std::find_if(m_queue.begin(), m_queue.end(), [this](const Job& job) {
+    return m_activePerHost[job.host] < m_hostLimit;
+  });
+}
+
+void DownloadScheduler::work() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_jobAvailable.wait(lock, [this]() {
+      return m_stopping or hasRunnableJob();
+    });
+    if (not hasRunnableJob()) {
+      return;  // stopping with an empty queue
+    }
+
+    const auto it  = nextRunnableJob();
+    Job        job = std::move(*it);
+    m_queue.erase(it);
+    ++m_activePerHost[job.host];
+    ++m_activeCount;
+    lock.unlock();
+    m_slotAvailable.notify_one();
+
+    std::string reason;
+    bool        failed = false;
+    try {
+      job.task();
+    } catch (const std::exception& e) {
+      failed = true;
+      reason = e.what();
+    } catch (...) {
+      failed = true;
+      reason = "unknown error";
+    }
+
+    lock.lock();
+    --m_activePerHost[job.host];
+    --m_activeCount;
+    if (failed) {
+      m_failures.push_back(DownloadFailure{job.distantFile, job.localFile, reason});
+    }
+    // The end of a job can unblock a job of the same host.
+    m_jobAvailable.notify_all();
+    if (m_queue.empty() and m_activeCount == 0) {
+      m_allDone.notify_all();
+    }
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
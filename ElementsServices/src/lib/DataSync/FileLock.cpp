@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>     // for open, O_CREAT
+#include <sys/file.h>  // for flock
+#include <sys/stat.h>  // for stat, fstat
+#include <unistd.h>    // for close, getpid, pread, pwrite, ftruncate
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "ElementsServices/DataSync/FileLock.h"
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+std::int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+path createdLockFile(path lockDirectory, path localFile) {
+  boost::filesystem::create_directories(lockDirectory);
+  return DownloadLock::lockFileOf(lockDirectory, localFile);
+}
+
+}  // namespace
+
+path uniquePartialPath(path file) {
+  static std::atomic<unsigned> counter{0};
+  return file.string() + ".part-" + std::to_string(::getpid()) + "-" + std::to_string(counter++);
+}
+
+bool isPartialPath(path file) {
+  return file.filename().string().find(".part-") != std::string::npos;
+}
+
+FileLock::FileLock(path file, int operation) : m_file(file), m_fd(-1), m_locked(false) {
+  reopen();
+  lock(operation);
+}
+
+FileLock::~FileLock() {
+  ::close(m_fd);
+}
+
+bool FileLock::lock(int operation) {
+  for (;;) {
+    int status = ::flock(m_fd, operation);
+    while (status != 0 and errno == EINTR) {
+      status = ::flock(m_fd, operation);
+    }
+    m_locked = status == 0;
+    if (not m_locked or not fileWasReplaced()) {
+      return m_locked;
+    }
+    // the holder removed the file before releasing it: the lock excludes nobody
+    reopen();
+  }
+}
+
+bool FileLock::locked() const {
+  return m_locked;
+}
+
+int FileLock::descriptor() const {
+  return m_fd;
+}
+
+bool FileLock::fileWasReplaced() const {
+  struct stat locked;
+  struct stat current;
+  if (::fstat(m_fd, &locked) != 0) {
+    return false;
+  }
+  if (::stat(m_file.c_str(), &current) != 0) {
+    return true;
+  }
+  return locked.st_dev != current.st_dev or locked.st_ino != current.st_ino;
+}
+
+void FileLock::reopen() {
+  if (m_fd >= 0) {
+    ::close(m_fd);
+  }
+  m_locked = false;
+  m_fd     = ::open(m_file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+  if (m_fd < 0) {
+    throw std::runtime_error("Unable to open the lock file: " + m_file.string());
+  }
+}
+
+DownloadLock::DownloadLock(path lockDirectory, path localFile) : DownloadLock(lockDirectory, localFile, true) {}
+
+DownloadLock::DownloadLock(path lockDirectory, path localFile, bool blocking)
+    : m_localFile(localFile), m_lock(createdLockFile(lockDirectory, localFile), LOCK_EX | LOCK_NB), m_waitStart(-1) {
+  if (not m_lock.locked() and blocking) {
+    m_waitStart = nowNs();
+    if (not m_lock.lock(LOCK_EX)) {
+      throw std::runtime_error("Unable to lock the download of: " + localFile.string());
+    }
+  }
+  if (m_lock.locked()) {
+    removePartialFiles();
+  }
+}
+
+std::unique_ptr<DownloadLock> DownloadLock::tryLock(path lockDirectory, path localFile) {
+  std::unique_ptr<DownloadLock> lock(new DownloadLock(lockDirectory, localFile, false));
+  if (not lock->m_lock.locked()) {
+    lock.reset();
+  }
+  return lock;
+}
+
+bool DownloadLock::downloadedMeanwhile() const {
+  if (m_waitStart < 0) {
+    return false;
+  }
+  char          buffer[64] = {};
+  const ssize_t count      = ::pread(m_lock.descriptor(), buffer, sizeof(buffer) - 1, 0);
+  if (count <= 0) {
+    return false;
+  }
+  std::istringstream stamp(std::string(buffer, static_cast<std::size_t>(count)));
+  std::int64_t       time = -1;
+  std::uintmax_t     size = 0;
+  if (not(stamp >> time >> size) or time < m_waitStart) {
+    return false;
+  }
+  boost::system::error_code error;
+  return boost::filesystem::is_regular_file(m_localFile, error) and
+         boost::filesystem::file_size(m_localFile, error) == size and not error;
+}
+
+void DownloadLock::markDownloaded() const {
+  boost::system::error_code error;
+  const auto                size  = boost::filesystem::file_size(m_localFile, error);
+  const std::string         stamp = std::to_string(nowNs()) + "\n" + std::to_string(error ? 0 : size) + "\n";
+  if (::ftruncate(m_lock.descriptor(), 0) == 0) {
+    // a missing stamp only costs a download to the waiting processes
+    const auto written = ::pwrite(m_lock.descriptor(), stamp.data(), stamp.size(), 0);
+    static_cast<void>(written);
+  }
+}
+
+path DownloadLock::lockFileOf(path lockDirectory, path localFile) {
+  const std::string  identity = localFile.string();
+  std::ostringstream name;
+  name << std::hex << std::setfill('0') << std::setw(16) << textHash(identity, 0) << std::setw(16)
+       << textHash(identity, 1) << ".lock";
+  return lockDirectory / name.str();
+}
+
+void DownloadLock::removePartialFiles() const {
+  const path                parent = m_localFile.has_parent_path() ? m_localFile.parent_path() : path(".");
+  const std::string         prefix = m_localFile.filename().string() + ".part-";
+  boost::system::error_code error;
+  for (boost::filesystem::directory_iterator it(parent, error), end; not error and it != end; it.increment(error)) {
+    if (it->path().filename().string().compare(0, prefix.size(), prefix) == 0) {
+      boost::system::error_code ignored;
+      boost::filesystem::remove(it->path(), ignored);
+    }
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
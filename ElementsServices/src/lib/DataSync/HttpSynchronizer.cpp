@@ -0,0 +1,774 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>   // for open
+#include <unistd.h>  // for close
+
+#include <boost/version.hpp>  // for BOOST_VERSION
+
+#include <cctype>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if BOOST_VERSION >= 107000
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#ifdef ELEMENTSSERVICES_HAVE_OPENSSL
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/ssl.hpp>
+#endif
+#endif
+
+#include "ElementsKernel/Unused.h"  // for ELEMENTS_UNUSED
+
+#include "ElementsServices/DataSync/ChunkJournal.h"
+#include "ElementsServices/DataSync/CommandRunner.h"
+#include "ElementsServices/DataSync/Compression.h"
+#include "ElementsServices/DataSync/HttpSynchronizer.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+std::string percentEncoded(const std::string& text) {
+  static const char digits[] = "0123456789ABCDEF";
+  std::string       encoded;
+  for (const char c : text) {
+    const auto byte = static_cast<unsigned char>(c);
+    if (std::isalnum(byte) or c == '-' or c == '.' or c == '_' or c == '~' or c == '/') {
+      encoded += c;
+    } else {
+      encoded += '%';
+      encoded += digits[byte >> 4];
+      encoded += digits[byte & 0xF];
+    }
+  }
+  return encoded;
+}
+
+std::string base64(const std::string& text) {
+  static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string       encoded;
+  std::size_t       i = 0;
+  for (; i + 2 < text.size(); i += 3) {
+    const auto bits = static_cast<unsigned>(static_cast<unsigned char>(text[i])) << 16 |
+                      static_cast<unsigned>(static_cast<unsigned char>(text[i + 1])) << 8 |
+                      static_cast<unsigned>(static_cast<unsigned char>(text[i + 2]));
+    encoded += digits[(bits >> 18) & 0x3F];
+    encoded += digits[(bits >> 12) & 0x3F];
+    encoded += digits[(bits >> 6) & 0x3F];
+    encoded += digits[bits & 0x3F];
+  }
+  if (i < text.size()) {
+    const bool two  = i + 1 < text.size();
+    auto       bits = static_cast<unsigned>(static_cast<unsigned char>(text[i])) << 16;
+    if (two) {
+      bits |= static_cast<unsigned>(static_cast<unsigned char>(text[i + 1])) << 8;
+    }
+    encoded += digits[(bits >> 18) & 0x3F];
+    encoded += digits[(bits >> 12) & 0x3F];
+    encoded += two ? digits[(bits >> 6) & 0x3F] : '=';
+    encoded += '=';
+  }
+  return encoded;
+}
+
+}  // namespace
+
+#if BOOST_VERSION >= 107000
+
+namespace {
+
+namespace asio  = boost::asio;
+namespace beast = boost::beast;
+namespace http  = beast::http;
+using tcp       = asio::ip::tcp;
+
+struct HttpUrl {
+  std::string scheme;
+  std::string host;
+  std::string port;
+  std::string target;
+
+  bool secure() const {
+    return scheme == "https";
+  }
+
+  std::string origin() const {
+    return scheme + "://" + host + ":" + port;
+  }
+
+  /// the value of the Host header: the port is omitted when it is the default one
+  std::string hostHeader() const {
+    return (port == (secure() ? "443" : "80")) ? host : host + ":" + port;
+  }
+};
+
+HttpUrl parseUrl(const std::string& url) {
+
+  const auto schemeEnd = url.find("://");
+  if (schemeEnd == std::string::npos) {
+    throw std::runtime_error("Invalid URL: " + url);
+  }
+
+  HttpUrl parsed;
+  parsed.scheme = lower(url.substr(0, schemeEnd));
+  if (parsed.scheme != "http" and parsed.scheme != "https") {
+    throw std::runtime_error("Unsupported URL scheme: " + url);
+  }
+
+  const std::string rest        = url.substr(schemeEnd + 3);
+  const auto        authorityEnd = rest.find('/');
+  std::string       authority    = rest.substr(0, authorityEnd);
+  parsed.target                  = authorityEnd == std::string::npos ? "/" : rest.substr(authorityEnd);
+
+  const auto userInfoEnd = authority.rfind('@');
+  if (userInfoEnd != std::string::npos) {
+    authority = authority.substr(userInfoEnd + 1);
+  }
+
+  // the IPv6 addresses are enclosed in brackets
+  const auto portStart = authority.rfind(':');
+  if (portStart != std::string::npos and authority.find(']', portStart) == std::string::npos) {
+    parsed.host = authority.substr(0, portStart);
+    parsed.port = authority.substr(portStart + 1);
+  } else {
+    parsed.host = authority;
+    parsed.port = parsed.secure() ? "443" : "80";
+  }
+  if (parsed.host.size() > 1 and parsed.host.front() == '[') {
+    parsed.host = parsed.host.substr(1, parsed.host.size() - 2);
+  }
+
+  return parsed;
+}
+
+HttpUrl resolveLocation(const HttpUrl& base, const std::string& location) {
+  if (location.find("://") != std::string::npos) {
+    return parseUrl(location);
+  }
+  HttpUrl resolved = base;
+  if (not location.empty() and location.front() == '/') {
+    resolved.target = location;
+  } else {
+    resolved.target = base.target.substr(0, base.target.rfind('/') + 1) + location;
+  }
+  return resolved;
+}
+
+/**
+ * @brief The parts of an HTTP response used by the synchronizer.
+ */
+struct HttpResponse {
+  unsigned       status{0};
+  std::string    reason{};
+  std::string    location{};
+  bool           keepAlive{false};
+  RemoteMetadata metadata{};
+  std::uint64_t  received{0};
+};
+
+/**
+ * @brief The destination of the body of a successful GET.
+ * @details
+ * Either the whole body goes to a new file,
+ * or a range of the body is requested and written at its offset in an open file.
+ * The range is only accepted if the distant file is still the expected version.
+ * The received buffers are throttled before being written.
+ * The whole body can be written to a decompressor instead of the file.
+ */
+struct Transfer {
+  const path*                        file{nullptr};
+  PipedCommand*                      decompressor{nullptr};
+  int                                descriptor{-1};
+  ByteRange                          range{0, 0};
+  RemoteMetadata                     remote{};
+  std::function<void(std::uint64_t)> throttle{};
+
+  bool ranged() const {
+    return descriptor >= 0;
+  }
+
+  /// the value of the Range header
+  std::string rangeHeader() const {
+    return "bytes=" + std::to_string(range.offset) + "-" + std::to_string(range.offset + range.length - 1);
+  }
+
+  /// the expected value of the Content-Range header
+  std::string contentRange() const {
+    return "bytes " + std::to_string(range.offset) + "-" + std::to_string(range.offset + range.length - 1) + "/" +
+           std::to_string(remote.size);
+  }
+};
+
+/// maximum duration of an operation without any progress
+const auto idleTimeout = std::chrono::seconds(60);
+
+constexpr int maxRedirections = 5;
+
+/// the completion handler of the asynchronous operations which are waited for
+struct Completion {
+  boost::system::error_code* result;
+  void                       operator()(boost::system::error_code error) const {
+    *result = error;
+  }
+  template <typename T>
+  void operator()(boost::system::error_code error, const T&) const {
+    *result = error;
+  }
+};
+
+/**
+ * @brief A keep-alive HTTP or HTTPS connection, used by a single thread at a time.
+ * @details
+ * The operations are asynchronous and waited for, so that they can time out.
+ */
+class HttpConnection {
+
+public:
+  HttpConnection(const HttpUrl& url, bool checkCertificate);
+
+  HttpConnection(const HttpConnection&) = delete;
+  HttpConnection& operator=(const HttpConnection&) = delete;
+
+  ~HttpConnection();
+
+  /// whether a request was already sent through this connection
+  bool reused() const {
+    return m_reused;
+  }
+
+  /// send the request and read the response; the body of a successful GET goes to the transfer destination
+  HttpResponse exchange(http::verb verb, const HttpUrl& url, const std::string& authorization,
+                        const Transfer& transfer);
+
+private:
+  template <typename Initiate>
+  void await(Initiate initiate);
+
+  template <typename Operation>
+  void withStream(Operation operation);
+
+  template <typename Parser>
+  void readBody(Parser& parser);
+
+  /// write the body at an offset of a file, and return its length
+  std::uint64_t readInto(http::response_parser<http::buffer_body>& parser, const Transfer& transfer, int descriptor,
+                         std::uint64_t offset, std::uint64_t maxLength);
+
+  std::uint64_t readFile(http::response_parser<http::buffer_body>& parser, const Transfer& transfer);
+
+  asio::io_context m_context;
+#ifdef ELEMENTSSERVICES_HAVE_OPENSSL
+  std::unique_ptr<asio::ssl::context>                     m_tls;
+  std::unique_ptr<beast::ssl_stream<beast::tcp_stream>> m_secure;
+#endif
+  std::unique_ptr<beast::tcp_stream> m_plain;
+  beast::tcp_stream*                 m_lowest;
+  beast::flat_buffer                 m_buffer;
+  bool                               m_reused;
+};
+
+HttpConnection::HttpConnection(const HttpUrl& url, bool checkCertificate)
+    : m_context(), m_plain(), m_lowest(nullptr), m_buffer(), m_reused(false) {
+
+  tcp::resolver resolver(m_context);
+  const auto    endpoints = resolver.resolve(url.host, url.port);
+
+  if (url.secure()) {
+#ifdef ELEMENTSSERVICES_HAVE_OPENSSL
+    m_tls.reset(new asio::ssl::context(asio::ssl::context::tls_client));
+    m_secure.reset(new beast::ssl_stream<beast::tcp_stream>(m_context, *m_tls));
+    if (not SSL_set_tlsext_host_name(m_secure->native_handle(), url.host.c_str())) {
+      throw std::runtime_error("Unable to set the TLS server name: " + url.host);
+    }
+    if (checkCertificate) {
+      m_tls->set_default_verify_paths();
+      m_secure->set_verify_mode(asio::ssl::verify_peer);
+      m_secure->set_verify_callback(asio::ssl::host_name_verification(url.host));
+    } else {
+      m_secure->set_verify_mode(asio::ssl::verify_none);
+    }
+    m_lowest = &beast::get_lowest_layer(*m_secure);
+#else
+    throw std::runtime_error("HTTPS is not available: ElementsServices was built without OpenSSL");
+#endif
+  } else {
+    m_plain.reset(new beast::tcp_stream(m_context));
+    m_lowest = m_plain.get();
+  }
+
+  await([this, &endpoints](Completion completion) {
+    m_lowest->async_connect(endpoints, completion);
+  });
+  m_lowest->socket().set_option(tcp::no_delay(true));
+
+#ifdef ELEMENTSSERVICES_HAVE_OPENSSL
+  if (m_secure) {
+    await([this](Completion completion) {
+      m_secure->async_handshake(asio::ssl::stream_base::client, completion);
+    });
+  }
+#endif
+}
+
+HttpConnection::~HttpConnection() {
+  // no TLS close notification: the server may not answer it
+  boost::system::error_code error;
+  m_lowest->socket().close(error);
+}
+
+template <typename Initiate>
+void HttpConnection::await(Initiate initiate) {
+  boost::system::error_code result = asio::error::would_block;
+  m_lowest->expires_after(idleTimeout);
+  initiate(Completion{&result});
+  m_context.restart();
+  m_context.run();
+  // the buffer bodies are read buffer by buffer
+  if (result and result != http::error::need_buffer) {
+    throw boost::system::system_error(result);
+  }
+}
+
+template <typename Operation>
+void HttpConnection::withStream(Operation operation) {
+#ifdef ELEMENTSSERVICES_HAVE_OPENSSL
+  if (m_secure) {
+    operation(*m_secure);
+    return;
+  }
+#endif
+  operation(*m_plain);
+}
+
+template <typename Parser>
+void HttpConnection::readBody(Parser& parser) {
+  // the timeout is reset at each chunk: only the stalled transfers are aborted
+  while (not parser.is_done()) {
+    withStream([this, &parser](auto& stream) {
+      await([this, &stream, &parser](Completion completion) {
+        http::async_read_some(stream, m_buffer, parser, completion);
+      });
+    });
+  }
+}
+
+std::uint64_t HttpConnection::readInto(http::response_parser<http::buffer_body>& parser, const Transfer& transfer,
+                                       int descriptor, std::uint64_t offset, std::uint64_t maxLength) {
+  std::vector<char> buffer(64 * 1024);
+  std::uint64_t     received = 0;
+  while (not parser.is_done()) {
+    parser.get().body().data = buffer.data();
+    parser.get().body().size = buffer.size();
+    withStream([this, &parser](auto& stream) {
+      await([this, &stream, &parser](Completion completion) {
+        http::async_read_some(stream, m_buffer, parser, completion);
+      });
+    });
+    const std::size_t size = buffer.size() - parser.get().body().size;
+    if (received + size > maxLength) {
+      throw std::runtime_error("The range is longer than requested");
+    }
+    if (transfer.throttle) {
+      transfer.throttle(size);
+    }
+    if (transfer.decompressor != nullptr) {
+      transfer.decompressor->write(buffer.data(), size);
+    } else {
+      writeAt(descriptor, offset + received, buffer.data(), size);
+    }
+    received += size;
+  }
+  return received;
+}
+
+std::uint64_t HttpConnection::readFile(http::response_parser<http::buffer_body>& parser, const Transfer& transfer) {
+  if (transfer.decompressor != nullptr) {
+    return readInto(parser, transfer, -1, 0, std::numeric_limits<std::uint64_t>::max());
+  }
+  const int descriptor = ::open(transfer.file->c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (descriptor < 0) {
+    throw std::runtime_error("Unable to write file: " + transfer.file->string() + " (" + std::strerror(errno) + ")");
+  }
+  try {
+    const auto received = readInto(parser, transfer, descriptor, 0, std::numeric_limits<std::uint64_t>::max());
+    ::close(descriptor);
+    return received;
+  } catch (...) {
+    ::close(descriptor);
+    throw;
+  }
+}
+
+HttpResponse HttpConnection::exchange(http::verb verb, const HttpUrl& url, const std::string& authorization,
+                                      const Transfer& transfer) {
+
+  m_reused = true;
+
+  http::request<http::empty_body> request(verb, url.target, 11);
+  request.set(http::field::host, url.hostHeader());
+  request.set(http::field::user_agent, "Elements-DataSync");
+  if (not authorization.empty()) {
+    request.set(http::field::authorization, authorization);
+  }
+  if (transfer.ranged()) {
+    request.set(http::field::range, transfer.rangeHeader());
+    // a weak validator cannot be used for ranges: the Content-Range is checked instead
+    if (not transfer.remote.version.empty() and transfer.remote.version.compare(0, 2, "W/") != 0) {
+      request.set(http::field::if_range, transfer.remote.version);
+    }
+  }
+  request.keep_alive(true);
+
+  withStream([this, &request](auto& stream) {
+    await([this, &stream, &request](Completion completion) {
+      http::async_write(stream, request, completion);
+    });
+  });
+
+  http::response_parser<http::empty_body> header;
+  header.skip(verb == http::verb::head);
+  withStream([this, &header](auto& stream) {
+    await([this, &stream, &header](Completion completion) {
+      http::async_read_header(stream, m_buffer, header, completion);
+    });
+  });
+
+  const auto&  fields = header.get();
+  HttpResponse response;
+  response.status   = fields.result_int();
+  response.reason   = std::string(fields.reason());
+  response.location = std::string(fields[http::field::location]);
+  if (header.content_length()) {
+    response.metadata.size = *header.content_length();
+  }
+  const std::string etag         = std::string(fields[http::field::etag]);
+  const std::string lastModified = std::string(fields[http::field::last_modified]);
+  response.metadata.version      = etag.empty() ? lastModified : etag;
+  response.metadata.known =
+      response.status / 100 == 2 and header.content_length() and not response.metadata.version.empty();
+
+  const bool success = response.status / 100 == 2;
+  const bool partial = response.status == 206 and fields[http::field::content_range] == transfer.contentRange();
+  if (transfer.ranged() and partial) {
+    http::response_parser<http::buffer_body> body(std::move(header));
+    body.body_limit(std::numeric_limits<std::uint64_t>::max());
+    response.received  = readInto(body, transfer, transfer.descriptor, transfer.range.offset, transfer.range.length);
+    response.keepAlive = body.keep_alive();
+  } else if (transfer.ranged() and success) {
+    // not the requested range, e.g. the whole file which changed: the body is not read, and the connection dropped
+    response.keepAlive = false;
+  } else if (success and transfer.file != nullptr and verb == http::verb::get) {
+    http::response_parser<http::buffer_body> body(std::move(header));
+    body.body_limit(std::numeric_limits<std::uint64_t>::max());
+    response.received  = readFile(body, transfer);
+    response.keepAlive = body.keep_alive();
+  } else if (not header.is_done()) {
+    // the error pages are read to keep the connection usable
+    http::response_parser<http::string_body> body(std::move(header));
+    readBody(body);
+    response.keepAlive = body.keep_alive();
+  } else {
+    response.keepAlive = header.keep_alive();
+  }
+
+  return response;
+}
+
+}  // namespace
+
+/**
+ * @brief The idle connections, by origin.
+ */
+class HttpConnectionPool {
+
+public:
+  explicit HttpConnectionPool(bool checkCertificate) : m_checkCertificate(checkCertificate), m_opened(0) {}
+
+  std::size_t openedConnections() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_opened;
+  }
+
+  /// send a request, following the redirections
+  HttpResponse request(http::verb verb, HttpUrl url, std::string authorization, const Transfer& transfer) {
+    for (int redirection = 0;; ++redirection) {
+      const HttpResponse response = requestOnce(verb, url, authorization, transfer);
+      if (response.status / 100 != 3 or response.location.empty() or redirection == maxRedirections) {
+        return response;
+      }
+      const HttpUrl next = resolveLocation(url, response.location);
+      // the credentials are not sent to another server
+      if (next.origin() != url.origin()) {
+        authorization.clear();
+      }
+      url = next;
+    }
+  }
+
+private:
+  HttpResponse requestOnce(http::verb verb, const HttpUrl& url, const std::string& authorization,
+                           const Transfer& transfer) {
+    for (int attempt = 0;; ++attempt) {
+      auto       connection = acquire(url);
+      const bool reused     = connection->reused();
+      try {
+        const HttpResponse response = connection->exchange(verb, url, authorization, transfer);
+        if (response.keepAlive) {
+          release(url, std::move(connection));
+        }
+        return response;
+      } catch (const boost::system::system_error& e) {
+        // the server may have closed an idle connection meanwhile
+        if (reused and attempt == 0) {
+          continue;
+        }
+        throw std::runtime_error(url.origin() + url.target + ": " + e.code().message());
+      }
+    }
+  }
+
+  std::unique_ptr<HttpConnection> acquire(const HttpUrl& url) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto&                       idle = m_idle[url.origin()];
+      if (not idle.empty()) {
+        auto connection = std::move(idle.back());
+        idle.pop_back();
+        return connection;
+      }
+      ++m_opened;
+    }
+    // the connection is opened outside of the lock
+    return std::unique_ptr<HttpConnection>(new HttpConnection(url, m_checkCertificate));
+  }
+
+  void release(const HttpUrl& url, std::unique_ptr<HttpConnection> connection) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle[url.origin()].push_back(std::move(connection));
+  }
+
+  const bool                                                        m_checkCertificate;
+  std::size_t                                                       m_opened;
+  std::map<std::string, std::vector<std::unique_ptr<HttpConnection>>> m_idle;
+  mutable std::mutex                                                m_mutex;
+};
+
+bool httpIsAvailable(ELEMENTS_UNUSED bool secure) {
+#ifdef ELEMENTSSERVICES_HAVE_OPENSSL
+  return true;
+#else
+  return not secure;
+#endif
+}
+
+HttpSynchronizer::HttpSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency)
+    : DataSynchronizer(connection, dependency)
+    , m_pool(std::make_shared<HttpConnectionPool>(connection.checkCertificate)) {
+  if (not httpIsAvailable(parseUrl(m_connection.hostUrl).secure())) {
+    throw std::runtime_error("You are trying to use HTTPS, "
+                             "but ElementsServices was built without OpenSSL.");
+  }
+}
+
+std::size_t HttpSynchronizer::openedConnections() const {
+  return m_pool->openedConnections();
+}
+
+RemoteMetadata HttpSynchronizer::remoteMetadata(path distantFile) const {
+  try {
+    const auto authorization = basicAuthorization(m_connection.user, m_connection.password);
+    return m_pool->request(http::verb::head, parseUrl(distantUrl(distantFile)), authorization, Transfer()).metadata;
+  } catch (const std::exception&) {
+    return RemoteMetadata();
+  }
+}
+
+void HttpSynchronizer::downloadOneFile(path distantFile, path localFile) const {
+  createLocalDirOf(localFile);
+  // a link to a cached object is replaced, not written through
+  boost::filesystem::remove(localFile);
+  downloadBody(distantFile, localFile, nullptr);
+}
+
+void HttpSynchronizer::downloadDecompressed(path distantFile, path localFile, Compression compression) const {
+  createLocalDirOf(localFile);
+  boost::filesystem::remove(localFile);
+  PipedCommand decompressor(decompressionCommand(compression), localFile.string());
+  try {
+    downloadBody(distantFile, localFile, &decompressor);
+  } catch (const std::exception&) {
+    // the decompressor fails at the end of its truncated input
+    decompressor.finish();
+    boost::system::error_code error;
+    boost::filesystem::remove(localFile, error);
+    throw;
+  }
+  const auto decompression = decompressor.finish();
+  if (not decompression.succeeded()) {
+    boost::system::error_code error;
+    boost::filesystem::remove(localFile, error);
+    throw DownloadFailed(distantFile, localFile, "Decompression failed with " + decompression.failure());
+  }
+}
+
+void HttpSynchronizer::downloadBody(path distantFile, path localFile, PipedCommand* decompressor) const {
+
+  Transfer transfer;
+  transfer.file         = &localFile;
+  transfer.decompressor = decompressor;
+  transfer.throttle     = [this](std::uint64_t bytes) {
+    throttle(bytes);
+  };
+  HttpResponse response;
+  try {
+    const auto authorization = basicAuthorization(m_connection.user, m_connection.password);
+    response = m_pool->request(http::verb::get, parseUrl(distantUrl(distantFile)), authorization, transfer);
+  } catch (const std::exception& e) {
+    boost::system::error_code error;
+    boost::filesystem::remove(localFile, error);
+    throw DownloadFailed(distantFile, localFile, e.what());
+  }
+
+  if (response.status / 100 != 2) {
+    // the client errors are permanent, except for the timeouts and the rate limits
+    const bool retryable = response.status >= 500 or response.status == 408 or response.status == 429;
+    throw DownloadFailed(distantFile, localFile, "HTTP " + std::to_string(response.status) + " " + response.reason,
+                         retryable);
+  }
+  if (response.metadata.size > 0 and response.received != response.metadata.size) {
+    throw DownloadFailed(distantFile, localFile, "truncated");
+  }
+}
+
+bool HttpSynchronizer::supportsRanges() const {
+  return true;
+}
+
+void HttpSynchronizer::downloadRange(path distantFile, const RemoteMetadata& remote, ByteRange range,
+                                     int descriptor) const {
+
+  Transfer transfer;
+  transfer.descriptor = descriptor;
+  transfer.range      = range;
+  transfer.remote     = remote;
+  transfer.throttle   = [this](std::uint64_t bytes) {
+    throttle(bytes);
+  };
+  const std::string bytes =
+      "bytes " + std::to_string(range.offset) + "-" + std::to_string(range.offset + range.length - 1);
+
+  HttpResponse response;
+  try {
+    const auto authorization = basicAuthorization(m_connection.user, m_connection.password);
+    response = m_pool->request(http::verb::get, parseUrl(distantUrl(distantFile)), authorization, transfer);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(bytes + ": " + e.what());
+  }
+
+  if (response.status / 100 != 2) {
+    throw std::runtime_error(bytes + ": HTTP " + std::to_string(response.status) + " " + response.reason);
+  }
+  if (response.status != 206) {
+    throw std::runtime_error(bytes + ": the distant file changed, or the host ignores the ranges");
+  }
+  if (response.received != range.length) {
+    throw std::runtime_error(bytes + ": truncated");
+  }
+}
+
+#else
+
+/**
+ * @brief Placeholder: the native HTTP client requires Boost.Beast (Boost 1.70).
+ */
+class HttpConnectionPool {};
+
+bool httpIsAvailable(bool) {
+  return false;
+}
+
+HttpSynchronizer::HttpSynchronizer(const ConnectionConfiguration& connection, const DependencyConfiguration& dependency)
+    : DataSynchronizer(connection, dependency), m_pool() {
+  throw std::runtime_error("You are trying to use the native HTTP client, "
+                           "but ElementsServices was built with a Boost version older than 1.70.");
+}
+
+std::size_t HttpSynchronizer::openedConnections() const {
+  return 0;
+}
+
+RemoteMetadata HttpSynchronizer::remoteMetadata(path) const {
+  return RemoteMetadata();
+}
+
+void HttpSynchronizer::downloadOneFile(path distantFile, path localFile) const {
+  throw DownloadFailed(distantFile, localFile, "no HTTP client");
+}
+
+void HttpSynchronizer::downloadDecompressed(path distantFile, path localFile, Compression) const {
+  throw DownloadFailed(distantFile, localFile, "no HTTP client");
+}
+
+void HttpSynchronizer::downloadBody(path distantFile, path localFile, PipedCommand*) const {
+  throw DownloadFailed(distantFile, localFile, "no HTTP client");
+}
+
+bool HttpSynchronizer::supportsRanges() const {
+  return false;
+}
+
+void HttpSynchronizer::downloadRange(path, const RemoteMetadata&, ByteRange, int) const {
+  throw std::runtime_error("no HTTP client");
+}
+
+#endif
+
+std::string basicAuthorization(const std::string& user, const std::string& password) {
+  if (user.empty() and password.empty()) {
+    return "";
+  }
+  return "Basic " + base64(user + ":" + password);
+}
+
+std::string HttpSynchronizer::createDownloadCommand(path distantFile, path localFile) const {
+  return "GET " + distantUrl(distantFile) + " > " + localFile.string();
+}
+
+std::string HttpSynchronizer::distantUrl(path distantFile) const {
+  return m_connection.hostUrl + "/" + percentEncoded(distantFile.string());
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>   // for open, posix_fadvise
+#include <unistd.h>  // for fdatasync, close, syscall
+
+#ifdef __linux__
+#include <sys/syscall.h>  // for SYS_ioprio_set
+#endif
+
+#include <cstdint>
+
+#include "ElementsServices/DataSync/IoPolicy.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+#ifdef __linux__
+// from linux/ioprio.h, which is not installed everywhere
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+constexpr int IOPRIO_CLASS_NONE  = 0;
+constexpr int IOPRIO_CLASS_BE    = 2;
+constexpr int IOPRIO_CLASS_IDLE  = 3;
+constexpr int IOPRIO_WHO_PROCESS = 1;
+
+int ioprioValue(IoPriority priority) {
+  switch (priority) {
+  case IoPriority::LOW:
+    return (IOPRIO_CLASS_BE << IOPRIO_CLASS_SHIFT) | 7;
+  case IoPriority::IDLE:
+    return IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT;
+  default:
+    return IOPRIO_CLASS_NONE << IOPRIO_CLASS_SHIFT;
+  }
+}
+#endif
+
+}  // namespace
+
+bool setThreadIoPriority(IoPriority priority) {
+#ifdef __linux__
+  // the I/O priority is per thread, and inherited by the forked processes
+  thread_local IoPriority current = IoPriority::NORMAL;
+  if (priority == current) {
+    return true;
+  }
+  if (::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, ioprioValue(priority)) != 0) {
+    return false;
+  }
+  current = priority;
+  return true;
+#else
+  return priority == IoPriority::NORMAL;
+#endif
+}
+
+void releasePageCache(int descriptor, std::uint64_t offset, std::uint64_t length) {
+#ifdef __APPLE__
+  // no advice on macOS, where the page cache is managed globally
+  static_cast<void>(offset);
+  static_cast<void>(length);
+  ::fsync(descriptor);
+#else
+  // the dirty pages cannot be dropped: they are written first
+  ::fdatasync(descriptor);
+  ::posix_fadvise(descriptor, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+#endif
+}
+
+void releasePageCache(const path& file) {
+  const int descriptor = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    return;
+  }
+  releasePageCache(descriptor);
+  ::close(descriptor);
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
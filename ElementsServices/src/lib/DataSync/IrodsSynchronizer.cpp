@@ -16,7 +16,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "ElementsServices/DataSync/IrodsSynchronizer.h"
 
@@ -27,6 +33,35 @@ bool irodsIsInstalled() {
   return checkCall("iget --help");
 }
 
+RemoteMetadata irodsMetadataFromListing(const std::string& listing) {
+
+  // owner replica resource size date status name
+  std::istringstream stream(listing);
+  std::string        line;
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    std::string        owner;
+    std::string        replica;
+    std::string        resource;
+    std::string        size;
+    std::string        date;
+    std::string        status;
+    if (fields >> owner >> replica >> resource >> size >> date >> status and status == "&") {
+      RemoteMetadata metadata;
+      try {
+        metadata.size = std::stoull(size);
+      } catch (const std::logic_error&) {
+        continue;
+      }
+      metadata.version = date;
+      metadata.known   = true;
+      return metadata;
+    }
+  }
+
+  return RemoteMetadata();
+}
+
 IrodsSynchronizer::IrodsSynchronizer(const ConnectionConfiguration& connection,
                                      const DependencyConfiguration& dependency)
     : DataSynchronizer(connection, dependency) {
@@ -42,5 +77,63 @@ std::string IrodsSynchronizer::createDownloadCommand(path distantFile, path loca
   return cmd;
 }
 
+std::string IrodsSynchronizer::createStreamingDownloadCommand(path distantFile) const {
+  return "iget " + distantFile.string() + " -";
+}
+
+std::vector<FileBatch> IrodsSynchronizer::groupInBatches(const FileBatch& files) const {
+  std::vector<FileBatch>    batches;
+  std::map<path, FileBatch> directories;
+  for (const auto& file : files) {
+    if (file.first.filename() == file.second.filename()) {
+      directories[file.second.parent_path()].push_back(file);
+    } else {
+      batches.push_back({file});
+    }
+  }
+  for (const auto& directory : directories) {
+    const FileBatch& group = directory.second;
+    for (std::size_t begin = 0; begin < group.size(); begin += m_connection.batchSize) {
+      const std::size_t end = std::min(begin + m_connection.batchSize, group.size());
+      batches.emplace_back(group.begin() + static_cast<std::ptrdiff_t>(begin),
+                           group.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+  }
+  return batches;
+}
+
+std::string IrodsSynchronizer::createBatchDownloadCommand(const FileBatch& batch) const {
+  // a single session for all the files, which are written in the same directory
+  std::string cmd = "iget -f";
+  if (m_connection.parallelChunks > 1) {
+    cmd += " -N " + std::to_string(m_connection.parallelChunks);
+  }
+  for (const auto& file : batch) {
+    cmd += " " + file.first.string();
+  }
+  cmd += " " + batch.front().second.parent_path().string();
+  return cmd;
+}
+
+bool IrodsSynchronizer::failureIsRetryable(const CommandResult& result) const {
+  // the missing files and the permission or authentication errors are permanent
+  for (const std::string error : {"USER_FILE_DOES_NOT_EXIST", "CAT_NO_ACCESS_PERMISSION", "CAT_INVALID_AUTHENTICATION",
+                                  "CAT_INVALID_USER", "OVERWRITE_WITHOUT_FORCE_FLAG"}) {
+    if (containsInThisOrder(result.err, {error}) or containsInThisOrder(result.out, {error})) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RemoteMetadata IrodsSynchronizer::remoteMetadata(path distantFile) const {
+  const std::string cmd = "ils -l " + distantFile.string() + " 2>/dev/null";
+  try {
+    return irodsMetadataFromListing(runCommandAndCaptureOutErr(cmd, m_connection.commandLimits).first);
+  } catch (const std::exception&) {
+    return RemoteMetadata();
+  }
+}
+
 }  // namespace DataSync
 }  // namespace ElementsServices
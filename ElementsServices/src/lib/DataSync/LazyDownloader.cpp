@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ElementsServices/DataSync/DataSynchronizer.h"
+#include "ElementsServices/DataSync/DownloadScheduler.h"
+#include "ElementsServices/DataSync/LazyDownloader.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+LazyDownloader::LazyDownloader(std::shared_ptr<const DataSynchronizer> synchronizer, std::vector<path> localFiles,
+                               std::size_t prefetcherCount)
+    : m_synchronizer(synchronizer)
+    , m_session(synchronizer->openSession())
+    , m_order(std::move(localFiles))
+    , m_dependencies()
+    , m_next(0)
+    , m_stopping(false)
+    , m_mutex()
+    , m_changed()
+    , m_prefetchers() {
+  for (const auto& localFile : m_order) {
+    m_dependencies[localFile] = Dependency{State::PENDING, nullptr};
+  }
+  for (std::size_t i = 0; i < prefetcherCount; ++i) {
+    m_prefetchers.emplace_back(&LazyDownloader::prefetch, this);
+  }
+}
+
+LazyDownloader::~LazyDownloader() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_changed.notify_all();
+  for (auto& prefetcher : m_prefetchers) {
+    prefetcher.join();
+  }
+  try {
+    m_synchronizer->closeSession(*m_session);
+  } catch (const std::exception&) {
+    // the manifest is only an optimization
+  }
+}
+
+void LazyDownloader::require(path localFile) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const auto                   item = m_dependencies.find(localFile);
+  if (item == m_dependencies.end()) {
+    return;
+  }
+  Dependency& dependency = item->second;
+  if (dependency.state == State::PENDING) {
+    fetch(lock, localFile, dependency);
+  }
+  m_changed.wait(lock, [&dependency]() {
+    return dependency.state == State::DONE or dependency.state == State::FAILED;
+  });
+  if (dependency.state == State::FAILED) {
+    std::rethrow_exception(dependency.error);
+  }
+}
+
+void LazyDownloader::requireAll() {
+  std::vector<DownloadFailure> failures;
+  for (const auto& localFile : m_order) {
+    try {
+      require(localFile);
+    } catch (const std::exception& e) {
+      failures.push_back({"", localFile, e.what()});
+    }
+  }
+  if (not failures.empty()) {
+    throw DownloadFailed(failures);
+  }
+}
+
+void LazyDownloader::fetch(std::unique_lock<std::mutex>& lock, path localFile, Dependency& dependency) {
+  dependency.state = State::RUNNING;
+  lock.unlock();
+  std::exception_ptr error;
+  try {
+    m_synchronizer->synchronizeDependency(*m_session, localFile);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  lock.lock();
+  dependency.state = error ? State::FAILED : State::DONE;
+  dependency.error = error;
+  m_changed.notify_all();
+}
+
+void LazyDownloader::prefetch() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (not m_stopping and m_next < m_order.size()) {
+    const path  localFile  = m_order[m_next++];
+    Dependency& dependency = m_dependencies[localFile];
+    // the files which were required in the meantime are skipped
+    if (dependency.state == State::PENDING) {
+      fetch(lock, localFile, dependency);
+    }
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>     // for open, O_CREAT, AT_FDCWD
+#include <sys/file.h>  // for LOCK_SH, LOCK_EX
+#include <sys/stat.h>  // for utimensat
+#include <unistd.h>    // for close, unlink
+
+#ifdef __linux__
+#include <linux/fs.h>   // for FICLONE
+#include <sys/ioctl.h>  // for ioctl
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "ElementsServices/DataSync/FileLock.h"
+#include "ElementsServices/DataSync/ObjectCache.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+bool reflink(path object, path localFile) {
+#ifdef FICLONE
+  const int source = ::open(object.c_str(), O_RDONLY | O_CLOEXEC);
+  if (source < 0) {
+    return false;
+  }
+  const int target = ::open(localFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  bool      cloned = false;
+  if (target >= 0) {
+    cloned = ::ioctl(target, FICLONE, source) == 0;
+    ::close(target);
+    if (not cloned) {
+      ::unlink(localFile.c_str());
+    }
+  }
+  ::close(source);
+  return cloned;
+#else
+  return false;
+#endif
+}
+
+CacheLink linkObject(path object, path localFile) {
+
+  // the symbolic link would be dangling
+  if (not boost::filesystem::is_regular_file(object)) {
+    throw std::runtime_error("The cached object is missing: " + object.string());
+  }
+
+  boost::system::error_code error;
+
+  // the local file is replaced, never written through
+  boost::filesystem::remove(localFile, error);
+
+  boost::filesystem::create_hard_link(object, localFile, error);
+  if (not error) {
+    return CacheLink::HARDLINK;
+  }
+
+  if (reflink(object, localFile)) {
+    return CacheLink::REFLINK;
+  }
+
+  boost::filesystem::create_symlink(boost::filesystem::absolute(object), localFile, error);
+  if (not error) {
+    return CacheLink::SYMLINK;
+  }
+
+  boost::filesystem::copy_file(object, localFile);
+  boost::filesystem::permissions(localFile, boost::filesystem::add_perms | boost::filesystem::owner_write);
+  return CacheLink::COPY;
+}
+
+/**
+ * @brief Visit the complete objects of the cache, with their size.
+ * @details
+ * The other processes may evict objects during the walk: the entries which vanished are skipped,
+ * and the walk stops at the first directory which cannot be read anymore.
+ */
+template <typename Visit>
+void forEachObject(path objects, Visit visit) {
+  using boost::filesystem::recursive_directory_iterator;
+  boost::system::error_code error;
+  for (recursive_directory_iterator it(objects, error), end; not error and it != end; it.increment(error)) {
+    boost::system::error_code entryError;
+    if (not boost::filesystem::is_regular_file(it->status(entryError)) or isPartialPath(it->path())) {
+      continue;
+    }
+    const auto size = boost::filesystem::file_size(it->path(), entryError);
+    if (not entryError) {
+      visit(it->path(), size);
+    }
+  }
+}
+
+}  // namespace
+
+ObjectCache::ObjectCache(path root, std::uintmax_t capacity) : m_root(root), m_capacity(capacity) {
+  boost::filesystem::create_directories(m_root / "objects");
+  boost::filesystem::create_directories(m_root / "locks");
+}
+
+path ObjectCache::defaultRoot() {
+  const std::string cacheHome = environmentVariable("XDG_CACHE_HOME");
+  if (not cacheHome.empty()) {
+    return path(cacheHome) / "elements-datasync";
+  }
+  return path(environmentVariable("HOME")) / ".cache" / "elements-datasync";
+}
+
+std::string ObjectCache::objectKey(const std::string& host, path distantFile, const RemoteMetadata& remote) {
+  const std::string identity = host + '\n' + distantFile.string() + '\n' + std::to_string(remote.size) + '\n' +
+                               remote.version;
+  // two independent 64-bit hashes make the collisions negligible
+  std::ostringstream key;
+  key << std::hex << std::setfill('0') << std::setw(16) << textHash(identity, 0) << std::setw(16)
+      << textHash(identity, 1);
+  return key.str();
+}
+
+path ObjectCache::root() const {
+  return m_root;
+}
+
+std::uintmax_t ObjectCache::capacity() const {
+  return m_capacity;
+}
+
+path ObjectCache::objectPath(const std::string& key) const {
+  return m_root / "objects" / key.substr(0, 2) / key;
+}
+
+path ObjectCache::lockPath(const std::string& key) const {
+  return m_root / "locks" / (key + ".lock");
+}
+
+void ObjectCache::touch(const std::string& key) const {
+  // the modification time of the lock file is the last use of the object
+  ::utimensat(AT_FDCWD, lockPath(key).c_str(), nullptr, 0);
+}
+
+CacheLink ObjectCache::provide(const std::string& key, path localFile, const Fetch& fetch) const {
+
+  const path object = objectPath(key);
+  createLocalDirOf(localFile);
+
+  // the shared lock prevents the eviction while the object is linked
+  FileLock lock(lockPath(key), LOCK_SH);
+
+  if (not boost::filesystem::is_regular_file(object)) {
+    lock.lock(LOCK_EX);
+    // another process may have fetched it while we were waiting
+    if (not boost::filesystem::is_regular_file(object)) {
+      boost::filesystem::create_directories(object.parent_path());
+      const path part = uniquePartialPath(object);
+      try {
+        fetch(part);
+      } catch (...) {
+        boost::system::error_code error;
+        boost::filesystem::remove(part, error);
+        throw;
+      }
+      // the objects are shared: they must not be modified through the links
+      boost::filesystem::permissions(part, boost::filesystem::owner_read | boost::filesystem::group_read |
+                                               boost::filesystem::others_read);
+      boost::filesystem::rename(part, object);
+    }
+  }
+
+  touch(key);
+  return linkObject(object, localFile);
+}
+
+std::uintmax_t ObjectCache::usage() const {
+  std::uintmax_t total = 0;
+  forEachObject(m_root / "objects", [&total](path, std::uintmax_t size) {
+    total += size;
+  });
+  return total;
+}
+
+std::size_t ObjectCache::evict() const {
+
+  if (m_capacity == 0) {
+    return 0;
+  }
+
+  // (last use, size, key)
+  std::vector<std::tuple<std::int64_t, std::uintmax_t, std::string>> objects;
+  std::uintmax_t                                                     total = 0;
+  forEachObject(m_root / "objects", [this, &objects, &total](path object, std::uintmax_t size) {
+    const std::string key      = object.filename().string();
+    std::int64_t      lastUsed = localModificationTime(lockPath(key));
+    if (lastUsed < 0) {
+      lastUsed = localModificationTime(object);
+    }
+    objects.emplace_back(lastUsed, size, key);
+    total += size;
+  });
+
+  std::sort(objects.begin(), objects.end());
+
+  std::size_t evicted = 0;
+  for (const auto& object : objects) {
+    if (total <= m_capacity) {
+      break;
+    }
+    const std::string& key = std::get<2>(object);
+    FileLock           lock(lockPath(key), LOCK_EX | LOCK_NB);
+    if (not lock.locked()) {
+      continue;
+    }
+    boost::system::error_code error;
+    boost::filesystem::remove(objectPath(key), error);
+    if (not error) {
+      // the processes which wait for this lock file will lock the next one, see FileLock
+      boost::filesystem::remove(lockPath(key), error);
+      total -= std::get<1>(object);
+      ++evicted;
+    }
+  }
+
+  return evicted;
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
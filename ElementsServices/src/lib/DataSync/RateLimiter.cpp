@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>     // for O_CREAT, O_RDWR
+#include <sys/mman.h>  // for shm_open, mmap
+#include <unistd.h>    // for ftruncate, close, getuid
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "ElementsServices/DataSync/RateLimiter.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// the steady clock is the same for all the processes of the node
+std::int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+std::int64_t durationNs(std::uint64_t bytes, std::uint64_t bytesPerSecond) {
+  return static_cast<std::int64_t>(static_cast<double>(bytes) * 1e9 / static_cast<double>(bytesPerSecond));
+}
+
+}  // namespace
+
+RateLimiter::RateLimiter(std::uint64_t bytesPerSecond)
+    : m_rate(bytesPerSecond), m_ownSchedule(0), m_schedule(&m_ownSchedule), m_mapping(nullptr) {}
+
+RateLimiter::RateLimiter(std::uint64_t bytesPerSecond, const std::string& sharedName)
+    : m_rate(bytesPerSecond), m_ownSchedule(0), m_schedule(&m_ownSchedule), m_mapping(nullptr) {
+
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The schedule cannot be shared between processes");
+
+  // only the processes of the user can write the schedule
+  const int descriptor = ::shm_open(sharedName.c_str(), O_RDWR | O_CREAT, 0600);
+  if (descriptor < 0) {
+    throw std::runtime_error("Unable to open the shared memory " + sharedName + ": " + std::strerror(errno));
+  }
+  // a new object is filled with zeros, which is a valid schedule
+  if (::ftruncate(descriptor, sizeof(std::atomic<std::int64_t>)) != 0) {
+    const std::string error = std::strerror(errno);
+    ::close(descriptor);
+    throw std::runtime_error("Unable to size the shared memory " + sharedName + ": " + error);
+  }
+  m_mapping = ::mmap(nullptr, sizeof(std::atomic<std::int64_t>), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+  ::close(descriptor);
+  if (m_mapping == MAP_FAILED) {
+    m_mapping = nullptr;
+    throw std::runtime_error("Unable to map the shared memory " + sharedName + ": " + std::strerror(errno));
+  }
+  m_schedule = static_cast<std::atomic<std::int64_t>*>(m_mapping);
+}
+
+RateLimiter::~RateLimiter() {
+  if (m_mapping != nullptr) {
+    ::munmap(m_mapping, sizeof(std::atomic<std::int64_t>));
+  }
+}
+
+std::shared_ptr<RateLimiter> RateLimiter::processWide(std::uint64_t bytesPerSecond) {
+  static std::mutex                                          mutex;
+  static std::map<std::uint64_t, std::weak_ptr<RateLimiter>> limiters;
+  std::lock_guard<std::mutex>                                lock(mutex);
+  auto                                                       limiter = limiters[bytesPerSecond].lock();
+  if (not limiter) {
+    limiter                  = std::make_shared<RateLimiter>(bytesPerSecond);
+    limiters[bytesPerSecond] = limiter;
+  }
+  return limiter;
+}
+
+std::shared_ptr<RateLimiter> RateLimiter::nodeWide(std::uint64_t bytesPerSecond) {
+  return std::make_shared<RateLimiter>(bytesPerSecond, "/elements-datasync-rate-" + std::to_string(::getuid()));
+}
+
+std::uint64_t RateLimiter::bytesPerSecond() const {
+  return m_rate;
+}
+
+void RateLimiter::acquire(std::uint64_t bytes) {
+  if (m_rate == 0 or bytes == 0) {
+    return;
+  }
+  const std::int64_t burst    = durationNs(std::max<std::uint64_t>(m_rate / 4, 64 * 1024), m_rate);
+  const std::int64_t backlog  = 4 * burst;
+  const std::int64_t cost     = durationNs(bytes, m_rate);
+  std::int64_t       schedule = m_schedule->load();
+  std::int64_t       now      = 0;
+  std::int64_t       next     = 0;
+  // reserve the bytes at the end of the schedule, or now if the bucket is full.
+  // The backlog is bounded: a corrupted shared schedule cannot block the transfers.
+  do {
+    now  = nowNs();
+    next = std::min(std::max(schedule, now), now + backlog) + cost;
+  } while (not m_schedule->compare_exchange_weak(schedule, next));
+  const std::int64_t wait = next - burst - now;
+  if (wait > 0) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "ElementsServices/DataSync/RetryPolicy.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+CircuitBreaker::CircuitBreaker(std::size_t threshold, std::chrono::milliseconds cooldown)
+    : m_threshold(threshold)
+    , m_cooldown(cooldown)
+    , m_failures(0)
+    , m_open(false)
+    , m_trialRunning(false)
+    , m_openedAt()
+    , m_mutex() {}
+
+bool CircuitBreaker::allows() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (not m_open) {
+    return true;
+  }
+  if (m_trialRunning or Clock::now() - m_openedAt < m_cooldown) {
+    return false;
+  }
+  m_trialRunning = true;
+  return true;
+}
+
+void CircuitBreaker::recordSuccess() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_failures     = 0;
+  m_open         = false;
+  m_trialRunning = false;
+}
+
+void CircuitBreaker::recordFailure() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_failures;
+  if (m_threshold > 0 and (m_trialRunning or m_failures >= m_threshold)) {
+    m_open     = true;
+    m_openedAt = Clock::now();
+  }
+  m_trialRunning = false;
+}
+
+bool CircuitBreaker::isOpen() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_open;
+}
+
+RetryPolicy::RetryPolicy(std::size_t tries, std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay)
+    : m_tries(std::max<std::size_t>(tries, 1)), m_initialDelay(initialDelay), m_maxDelay(maxDelay) {}
+
+std::size_t RetryPolicy::tries() const {
+  return m_tries;
+}
+
+std::chrono::milliseconds RetryPolicy::maxDelayBefore(std::size_t retry) const {
+  auto delay = m_initialDelay;
+  for (std::size_t i = 1; i < retry and delay < m_maxDelay; ++i) {
+    delay *= 2;
+  }
+  return std::min(delay, m_maxDelay);
+}
+
+std::chrono::milliseconds RetryPolicy::delayBefore(std::size_t retry) const {
+  thread_local std::mt19937_64 generator{std::random_device{}()};
+  std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution(0, maxDelayBefore(retry).count());
+  return std::chrono::milliseconds(distribution(generator));
+}
+
+void RetryPolicy::run(const std::function<void()>& task, const Classifier& retryable, CircuitBreaker* breaker) const {
+  std::exception_ptr lastError;
+  for (std::size_t attempt = 0; attempt < m_tries; ++attempt) {
+    if (attempt > 0) {
+      if (breaker != nullptr and breaker->isOpen()) {
+        break;
+      }
+      std::this_thread::sleep_for(delayBefore(attempt));
+    }
+    if (breaker != nullptr and not breaker->allows()) {
+      break;
+    }
+    try {
+      task();
+      if (breaker != nullptr) {
+        breaker->recordSuccess();
+      }
+      return;
+    } catch (const std::exception& e) {
+      const bool transient = retryable(e);
+      // the fatal errors, like a missing file, say nothing about the health of the host
+      if (breaker != nullptr) {
+        transient ? breaker->recordFailure() : breaker->recordSuccess();
+      }
+      if (not transient) {
+        throw;
+      }
+      lastError = std::current_exception();
+    }
+  }
+  if (lastError) {
+    std::rethrow_exception(lastError);
+  }
+  throw CircuitOpen();
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <sys/stat.h>  // for stat
+#include <unistd.h>    // for getpid
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+const std::string manifestHeader = "# elements-datasync manifest 2";
+
+constexpr std::uint64_t hashPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t hashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t hashPrime3 = 0x165667B19E3779F9ULL;
+
+inline std::uint64_t rotateLeft(std::uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline std::uint64_t mixWord(std::uint64_t hash, std::uint64_t word) {
+  hash ^= rotateLeft(word * hashPrime2, 31) * hashPrime1;
+  return rotateLeft(hash, 27) * hashPrime1 + hashPrime3;
+}
+
+/**
+ * @brief Hash of consecutive blocks.
+ * @details
+ * All the blocks but the last one must have a size multiple of the word size.
+ */
+class BlockHasher {
+public:
+  explicit BlockHasher(std::uint64_t seed) : m_hash(hashPrime3 + seed * hashPrime1), m_length(0) {}
+
+  void update(const char* data, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= count; i += sizeof(std::uint64_t)) {
+      std::uint64_t word;
+      std::memcpy(&word, data + i, sizeof(word));
+      m_hash = mixWord(m_hash, word);
+    }
+    if (i < count) {
+      std::uint64_t word = 0;
+      std::memcpy(&word, data + i, count - i);
+      m_hash = mixWord(m_hash, word);
+    }
+    m_length += count;
+  }
+
+  std::uint64_t digest() const {
+    // final avalanche
+    std::uint64_t hash = m_hash ^ m_length;
+    hash ^= hash >> 33;
+    hash *= hashPrime2;
+    hash ^= hash >> 29;
+    hash *= hashPrime3;
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+private:
+  std::uint64_t  m_hash;
+  std::uintmax_t m_length;
+};
+
+std::string sanitized(std::string field) {
+  for (auto& c : field) {
+    if (c == '\t' or c == '\n' or c == '\r') {
+      c = ' ';
+    }
+  }
+  return field;
+}
+
+}  // namespace
+
+std::uint64_t contentHash(path file) {
+
+  std::ifstream stream(file.c_str(), std::ios::binary);
+  if (not stream) {
+    throw std::runtime_error("Unable to read file: " + file.string());
+  }
+
+  // The block size is a multiple of the word size: only the last block has a tail.
+  std::vector<char> buffer(1 << 20);
+  BlockHasher       hasher(0);
+  while (stream) {
+    stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hasher.update(buffer.data(), static_cast<std::size_t>(stream.gcount()));
+  }
+
+  return hasher.digest();
+}
+
+std::uint64_t textHash(const std::string& text, std::uint64_t seed) {
+  BlockHasher hasher(seed);
+  hasher.update(text.data(), text.size());
+  return hasher.digest();
+}
+
+std::int64_t localModificationTime(path file) {
+  struct stat status;
+  if (::stat(file.c_str(), &status) != 0) {
+    return -1;
+  }
+#if defined(__APPLE__)
+  const auto& time = status.st_mtimespec;
+#else
+  const auto& time = status.st_mtim;
+#endif
+  return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + static_cast<std::int64_t>(time.tv_nsec);
+}
+
+SyncManifest::SyncManifest(path file) : m_file(file), m_entries(), m_mutex() {
+  load();
+}
+
+path SyncManifest::file() const {
+  return m_file;
+}
+
+std::size_t SyncManifest::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+bool SyncManifest::isUpToDate(path distantFile, path localFile, const RemoteMetadata& remote) const {
+  if (not remote.known) {
+    return false;
+  }
+  ManifestEntry entry;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto                  it = m_entries.find(localFile.string());
+    if (it == m_entries.end()) {
+      return false;
+    }
+    entry = it->second;
+  }
+  if (entry.distantFile != distantFile or entry.remoteSize != remote.size or entry.version != sanitized(remote.version)) {
+    return false;
+  }
+  // a local modification or truncation is detected without reading the file
+  if (not boost::filesystem::is_regular_file(localFile)) {
+    return false;
+  }
+  return boost::filesystem::file_size(localFile) == entry.size and localModificationTime(localFile) == entry.localTime;
+}
+
+void SyncManifest::record(path distantFile, path localFile, const RemoteMetadata& remote, Compression compression) {
+
+  ManifestEntry entry;
+  entry.distantFile = distantFile;
+  entry.size        = boost::filesystem::file_size(localFile);
+  entry.remoteSize  = remote.size;
+  entry.version     = sanitized(remote.version);
+  entry.hash        = contentHash(localFile);
+  entry.localTime   = localModificationTime(localFile);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto                  previous = m_entries.find(localFile.string());
+
+  std::string reason;
+  // the host reports the size of the compressed file
+  if (remote.known and compression == Compression::NONE and entry.size != remote.size) {
+    reason = std::to_string(entry.size) + " bytes received, " + std::to_string(remote.size) + " expected";
+  } else if (remote.known and previous != m_entries.end() and previous->second.distantFile == distantFile and
+             previous->second.version == entry.version and previous->second.size == entry.size and
+             previous->second.hash != entry.hash) {
+    reason = "the content differs from the previous download of the same version";
+  }
+
+  if (not reason.empty()) {
+    if (previous != m_entries.end()) {
+      m_entries.erase(previous);
+    }
+    throw ManifestMismatch(distantFile, reason);
+  }
+
+  m_entries[localFile.string()] = entry;
+}
+
+bool SyncManifest::verify(path localFile) const {
+  ManifestEntry entry;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto                  it = m_entries.find(localFile.string());
+    if (it == m_entries.end()) {
+      return false;
+    }
+    entry = it->second;
+  }
+  if (not boost::filesystem::is_regular_file(localFile) or boost::filesystem::file_size(localFile) != entry.size) {
+    return false;
+  }
+  return contentHash(localFile) == entry.hash;
+}
+
+void SyncManifest::forget(path localFile) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.erase(localFile.string());
+}
+
+void SyncManifest::save() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  createLocalDirOf(m_file);
+  const path temporary = m_file.string() + ".tmp-" + std::to_string(::getpid());
+  {
+    std::ofstream stream(temporary.c_str());
+    stream << manifestHeader << '\n';
+    for (const auto& item : m_entries) {
+      const auto& entry = item.second;
+      stream << item.first << '\t' << entry.distantFile.string() << '\t' << entry.size << '\t' << entry.remoteSize
+             << '\t' << entry.version << '\t' << std::hex << entry.hash << std::dec << '\t' << entry.localTime << '\n';
+    }
+    if (not stream) {
+      throw std::runtime_error("Unable to write the manifest: " + temporary.string());
+    }
+  }
+  boost::filesystem::rename(temporary, m_file);
+}
+
+void SyncManifest::load() {
+  std::ifstream stream(m_file.c_str());
+  std::string   line;
+  if (not stream or not std::getline(stream, line) or line != manifestHeader) {
+    // missing or incompatible manifest: everything will be downloaded again
+    return;
+  }
+  try {
+    while (std::getline(stream, line)) {
+      std::istringstream fields(line);
+      std::string        local;
+      std::string        distant;
+      std::string        size;
+      std::string        remoteSize;
+      std::string        hash;
+      std::string        localTime;
+      ManifestEntry      entry;
+      if (std::getline(fields, local, '\t') and std::getline(fields, distant, '\t') and
+          std::getline(fields, size, '\t') and std::getline(fields, remoteSize, '\t') and
+          std::getline(fields, entry.version, '\t') and
+          std::getline(fields, hash, '\t') and std::getline(fields, localTime)) {
+        entry.distantFile = distant;
+        entry.size        = std::stoull(size);
+        entry.remoteSize  = std::stoull(remoteSize);
+        entry.hash        = std::stoull(hash, nullptr, 16);
+        entry.localTime   = std::stoll(localTime);
+        m_entries[local]  = entry;
+      }
+    }
+  } catch (const std::logic_error&) {
+    // corrupted manifest: it is safer to forget everything
+    m_entries.clear();
+  }
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
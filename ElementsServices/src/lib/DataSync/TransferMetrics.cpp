@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ElementsKernel/Logging.h"
+
+#include "ElementsServices/DataSync/TransferMetrics.h"
+
+namespace ElementsServices {
+namespace DataSync {
+
+using std::chrono::steady_clock;
+
+namespace {
+
+auto log = Elements::Logging::getLogger("DataSync");
+
+double rate(std::uint64_t bytes, double seconds) {
+  return seconds > 0 ? static_cast<double>(bytes) / seconds : 0.;
+}
+
+std::string megabytes(double bytes) {
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(1) << bytes / (1024. * 1024.) << " MB";
+  return stream.str();
+}
+
+std::string duration(double seconds) {
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(1) << seconds << " s";
+  return stream.str();
+}
+
+std::string jsonString(const std::string& value) {
+  std::ostringstream stream;
+  stream << '"';
+  for (const char c : value) {
+    if (c == '"' or c == '\\') {
+      stream << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    } else {
+      stream << c;
+    }
+  }
+  stream << '"';
+  return stream.str();
+}
+
+}  // namespace
+
+double FileMetrics::throughput() const {
+  return rate(bytes, seconds);
+}
+
+std::size_t MetricsSummary::queued() const {
+  const std::size_t started = active + succeeded + failed;
+  return submitted > started ? submitted - started : 0;
+}
+
+double MetricsSummary::throughput() const {
+  return rate(bytes, seconds);
+}
+
+TransferMetrics::TransferMetrics(const std::string& host, std::chrono::milliseconds progressPeriod)
+    : m_mutex()
+    , m_host(host)
+    , m_progressPeriod(progressPeriod)
+    , m_begin(steady_clock::now())
+    , m_nextProgress(m_begin + progressPeriod)
+    , m_submitted(0)
+    , m_files()
+    , m_starts()
+    , m_finished() {}
+
+void TransferMetrics::begin() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_begin        = steady_clock::now();
+  m_nextProgress = m_begin + m_progressPeriod;
+  m_submitted    = 0;
+  m_files.clear();
+  m_starts.clear();
+  m_finished.clear();
+}
+
+void TransferMetrics::submit(std::size_t count) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_submitted += count;
+}
+
+std::size_t TransferMetrics::startFile(path distantFile, path localFile) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  FileMetrics                 metrics;
+  metrics.distantFile = distantFile;
+  metrics.localFile   = localFile;
+  m_files.push_back(metrics);
+  m_starts.push_back(steady_clock::now());
+  m_finished.push_back(false);
+  return m_files.size() - 1;
+}
+
+void TransferMetrics::recordTry(std::size_t file) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_files.at(file).tries;
+}
+
+void TransferMetrics::recordBytes(std::size_t file, std::uint64_t bytes) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto&                       metrics = m_files.at(file);
+    if (metrics.firstByteSeconds < 0) {
+      metrics.firstByteSeconds = elapsedSeconds(m_starts[file]);
+    }
+    metrics.bytes += bytes;
+  }
+  logProgressIfDue();
+}
+
+void TransferMetrics::finishFile(std::size_t file, bool succeeded, std::uint64_t size) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto&                       metrics = m_files.at(file);
+    metrics.seconds                     = elapsedSeconds(m_starts[file]);
+    metrics.succeeded                   = succeeded;
+    if (metrics.bytes == 0) {
+      metrics.bytes = size;
+    }
+    m_finished[file] = true;
+  }
+  logProgressIfDue();
+}
+
+void TransferMetrics::skipFile(std::size_t file) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto&                       metrics = m_files.at(file);
+    metrics.seconds                     = elapsedSeconds(m_starts[file]);
+    metrics.succeeded                   = true;
+    metrics.skipped                     = true;
+    metrics.bytes                       = 0;
+    m_finished[file]                    = true;
+  }
+  logProgressIfDue();
+}
+
+void TransferMetrics::recordFile(const FileMetrics& metrics) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.push_back(metrics);
+    m_starts.push_back(steady_clock::now());
+    m_finished.push_back(true);
+  }
+  logProgressIfDue();
+}
+
+void TransferMetrics::end() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto                  summary = summaryUnlocked();
+  if (summary.succeeded + summary.failed == 0) {
+    return;
+  }
+  log.info("Synchronized " + std::to_string(summary.succeeded) + " file(s) from " + m_host + ": " +
+           megabytes(static_cast<double>(summary.bytes)) + " in " + duration(summary.seconds) + " at " +
+           megabytes(summary.throughput()) + "/s, " + std::to_string(summary.retries) + " retries, " +
+           std::to_string(summary.failed) + " failure(s)");
+}
+
+MetricsSummary TransferMetrics::summary() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return summaryUnlocked();
+}
+
+std::vector<FileMetrics> TransferMetrics::files() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_files;
+}
+
+std::string TransferMetrics::progressMessage() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return progressMessageUnlocked();
+}
+
+std::string TransferMetrics::jsonSummary() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto                  summary = summaryUnlocked();
+  std::ostringstream          json;
+  json << "{\n";
+  json << "  \"host\": " << jsonString(m_host) << ",\n";
+  json << "  \"files\": " << m_files.size() << ",\n";
+  json << "  \"succeeded\": " << summary.succeeded << ",\n";
+  json << "  \"skipped\": " << summary.skipped << ",\n";
+  json << "  \"failed\": " << summary.failed << ",\n";
+  json << "  \"bytes\": " << summary.bytes << ",\n";
+  json << "  \"seconds\": " << summary.seconds << ",\n";
+  json << "  \"throughput\": " << summary.throughput() << ",\n";
+  json << "  \"retries\": " << summary.retries << ",\n";
+  json << "  \"transfers\": [";
+  for (std::size_t i = 0; i < m_files.size(); ++i) {
+    const auto& file = m_files[i];
+    json << (i == 0 ? "\n" : ",\n");
+    json << "    {\"distant\": " << jsonString(file.distantFile.string())
+         << ", \"local\": " << jsonString(file.localFile.string()) << ", \"bytes\": " << file.bytes
+         << ", \"seconds\": " << file.seconds << ", \"throughput\": " << file.throughput() << ", \"first_byte\": ";
+    if (file.firstByteSeconds < 0) {
+      json << "null";
+    } else {
+      json << file.firstByteSeconds;
+    }
+    json << ", \"tries\": " << file.tries << ", \"succeeded\": " << (file.succeeded ? "true" : "false")
+         << ", \"skipped\": " << (file.skipped ? "true" : "false") << "}";
+  }
+  json << (m_files.empty() ? "]\n" : "\n  ]\n");
+  json << "}\n";
+  return json.str();
+}
+
+void TransferMetrics::writeSummary(path file) const {
+  createLocalDirOf(file);
+  std::ofstream stream(file.c_str());
+  stream << jsonSummary();
+  if (not stream) {
+    throw std::runtime_error("Unable to write the transfer metrics to: " + file.string());
+  }
+}
+
+double TransferMetrics::elapsedSeconds(steady_clock::time_point since) const {
+  return std::chrono::duration<double>(steady_clock::now() - since).count();
+}
+
+MetricsSummary TransferMetrics::summaryUnlocked() const {
+  MetricsSummary summary;
+  summary.submitted = m_submitted;
+  summary.seconds   = elapsedSeconds(m_begin);
+  for (std::size_t i = 0; i < m_files.size(); ++i) {
+    const auto& file = m_files[i];
+    if (not m_finished[i]) {
+      ++summary.active;
+    } else if (file.succeeded) {
+      ++summary.succeeded;
+      summary.skipped += file.skipped ? 1 : 0;
+    } else {
+      ++summary.failed;
+    }
+    summary.bytes += file.bytes;
+    summary.retries += file.tries > 1 ? file.tries - 1 : 0;
+  }
+  return summary;
+}
+
+std::string TransferMetrics::progressMessageUnlocked() const {
+  const auto summary = summaryUnlocked();
+  return "Synchronizing from " + m_host + ": " + std::to_string(summary.succeeded) + " done, " +
+         std::to_string(summary.active) + " active, " + std::to_string(summary.queued()) + " queued, " +
+         std::to_string(summary.failed) + " failed, " + megabytes(static_cast<double>(summary.bytes)) + " at " +
+         megabytes(summary.throughput()) + "/s, " + std::to_string(summary.retries) + " retries";
+}
+
+void TransferMetrics::logProgressIfDue() {
+  if (m_progressPeriod.count() <= 0) {
+    return;
+  }
+  std::string message;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto                  now = steady_clock::now();
+    if (now < m_nextProgress) {
+      return;
+    }
+    m_nextProgress = now + m_progressPeriod;
+    message        = progressMessageUnlocked();
+  }
+  log.info(message);
+}
+
+}  // namespace DataSync
+}  // namespace ElementsServices
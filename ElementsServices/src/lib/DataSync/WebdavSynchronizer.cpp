@@ -16,6 +16,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include "ElementsServices/DataSync/WebdavSynchronizer.h"
@@ -27,24 +33,121 @@ bool webdavIsInstalled() {
   return checkCall("wget -h");
 }
 
+RemoteMetadata webdavMetadataFromHeaders(const std::string& headers) {
+
+  RemoteMetadata     metadata;
+  bool               success = false;
+  bool               hasSize = false;
+  std::string        etag;
+  std::string        lastModified;
+  std::istringstream stream(headers);
+  std::string        line;
+
+  while (std::getline(stream, line)) {
+    const auto begin = line.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+      continue;
+    }
+    line = line.substr(begin, line.find_last_not_of(" \t\r") + 1 - begin);
+    if (line.compare(0, 5, "HTTP/") == 0) {
+      // a new response, e.g. after a redirection
+      const auto code = line.find(' ');
+      success         = code != std::string::npos and line.compare(code + 1, 1, "2") == 0;
+      hasSize         = false;
+      etag.clear();
+      lastModified.clear();
+      continue;
+    }
+    const auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    const std::string name  = lower(line.substr(0, colon));
+    const auto        first = line.find_first_not_of(' ', colon + 1);
+    const std::string value = first == std::string::npos ? "" : line.substr(first);
+    if (name == "content-length") {
+      metadata.size = std::stoull(value);
+      hasSize       = true;
+    } else if (name == "etag") {
+      etag = value;
+    } else if (name == "last-modified") {
+      lastModified = value;
+    }
+  }
+
+  metadata.version = etag.empty() ? lastModified : etag;
+  metadata.known   = success and hasSize and not metadata.version.empty();
+  return metadata;
+}
+
 WebdavSynchronizer::WebdavSynchronizer(const ConnectionConfiguration& connection,
                                        const DependencyConfiguration& dependency)
-    : DataSynchronizer(connection, dependency) {
+    : DataSynchronizer(connection, dependency), m_wgetrc(std::make_shared<Elements::TempFile>("wgetrc-%%%%-%%%%")) {
   if (not webdavIsInstalled()) {
     throw std::runtime_error("You are trying to use WebDAV, "
                              "but it does not seem to be installed.");
   }
+  // the file is made private before the credentials are written
+  boost::filesystem::permissions(m_wgetrc->path(), boost::filesystem::owner_read | boost::filesystem::owner_write);
+  std::ofstream wgetrc(m_wgetrc->path().c_str());
+  wgetrc << "user = " << m_connection.user << "\npassword = " << m_connection.password << "\n";
+  if (not wgetrc) {
+    throw std::runtime_error("Unable to write the wget configuration: " + m_wgetrc->path().string());
+  }
 }
 
 std::string WebdavSynchronizer::createDownloadCommand(path distantFile, path localFile) const {
-  std::string cmd = "wget --no-check-certificate ";
-  cmd += " --user=" + m_connection.user;
-  cmd += " --password=" + m_connection.password;
-  cmd += " -O " + localFile.string();
+  return createWgetCommand(distantFile, localFile.string());
+}
+
+std::string WebdavSynchronizer::createStreamingDownloadCommand(path distantFile) const {
+  return createWgetCommand(distantFile, "-");
+}
+
+std::string WebdavSynchronizer::wget() const {
+  return "WGETRC=" + m_wgetrc->path().string() + " wget --no-check-certificate";
+}
+
+std::string WebdavSynchronizer::createWgetCommand(path distantFile, const std::string& output) const {
+  std::string cmd = wget();
+  cmd += " -O " + output;
   cmd += " " + m_connection.hostUrl + "/" + distantFile.string();
-  cmd += " --tries " + std::to_string(m_connection.tries);
+  // the retries are handled by the synchronizer, with a backoff
+  cmd += " --tries 1";
+  if (m_connection.bandwidth > 0) {
+    // wget cannot share a limit: the process bandwidth is split between the concurrent downloads
+    cmd += " --limit-rate=" + std::to_string(std::max<std::uint64_t>(
+                                  m_connection.bandwidth / m_connection.parallelTransfers, 1));
+  }
   return cmd;
 }
 
+bool WebdavSynchronizer::failureIsRetryable(const CommandResult& result) const {
+  // see the exit status section of the wget manual
+  switch (result.exitCode) {
+  case 2:  // parse error
+  case 3:  // file I/O error
+  case 5:  // SSL verification failure
+  case 6:  // authentication failure
+    return false;
+  case 8:  // error response: only the server errors, timeouts and rate limits are transient
+    return containsInThisOrder(result.err, {"ERROR 5"}) or containsInThisOrder(result.err, {"ERROR 408"}) or
+           containsInThisOrder(result.err, {"ERROR 429"});
+  default:
+    return true;
+  }
+}
+
+RemoteMetadata WebdavSynchronizer::remoteMetadata(path distantFile) const {
+  std::string cmd = wget() + " --spider --server-response";
+  cmd += " " + m_connection.hostUrl + "/" + distantFile.string();
+  cmd += " 2>&1";
+  try {
+    return webdavMetadataFromHeaders(runCommandAndCaptureOutErr(cmd, m_connection.commandLimits).first);
+  } catch (const std::exception&) {
+    return RemoteMetadata();
+  }
+}
+
 }  // namespace DataSync
 }  // namespace ElementsServices
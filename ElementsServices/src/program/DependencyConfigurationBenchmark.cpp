@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <chrono>   // for steady_clock, duration
+#include <cstddef>  // for size_t
+#include <fstream>  // for ifstream, ofstream
+#include <map>      // for map
+#include <string>   // for string, to_string
+
+#include <boost/program_options.hpp>  // for program options from configuration file of command line arguments
+
+#include "ElementsKernel/Environment.h"     // for Environment
+#include "ElementsKernel/ProgramHeaders.h"  // for including all Program/related headers
+#include "ElementsKernel/Temporary.h"       // for TempDir
+
+#include "ElementsServices/DataSync/DependencyConfiguration.h"  // for DependencyConfiguration
+
+using std::map;
+using std::size_t;
+using std::string;
+
+using boost::program_options::value;
+
+namespace ElementsServices {
+namespace DataSync {
+
+namespace {
+
+/// run the function and return the elapsed time in seconds
+template <typename Function>
+double timeIt(Function f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/// the parsing of the dependency files by line and into a map, as a reference
+map<path, path> parseWithMap(const path& distantRoot, const path& localRoot, const path& filename) {
+  map<path, path> file_map;
+  std::ifstream   input(filename.c_str());
+  string          line;
+  while (std::getline(input, line)) {
+    const string::size_type offset = line.find('\t');
+    if (offset == string::npos) {
+      file_map[localRoot / line] = distantRoot / line;
+    } else {
+      const string::size_type flagOffset = line.find('\t', offset + 1);
+      file_map[localRoot / line.substr(offset + 1, flagOffset - offset - 1)] = distantRoot / line.substr(0, offset);
+    }
+  }
+  return file_map;
+}
+
+}  // namespace
+
+/**
+ * @class DependencyConfigurationBenchmark
+ * @brief
+ *    Measure the parsing of a large dependency file
+ * @details
+ *    A file of aliased and non-aliased dependencies is generated in a temporary directory,
+ *    then parsed by the DependencyConfiguration and by a reference parser into a map.
+ */
+class DependencyConfigurationBenchmark : public Elements::Program {
+
+public:
+  Elements::ExitCode mainMethod(map<string, VariableValue>& args) override {
+
+    auto log = Elements::Logging::getLogger("DependencyConfigurationBenchmark");
+
+    const auto lines = args["lines"].as<size_t>();
+
+    Elements::TempDir     directory;
+    Elements::Environment environment;
+    environment.prepend("ELEMENTS_CONF_PATH", directory.path().string() + ":");
+    const path filename = "dependencies.txt";
+    {
+      std::ofstream output((directory.path() / filename).c_str());
+      for (size_t i = 0; i < lines; ++i) {
+        const string name = "data/dir" + std::to_string(i % 1000) + "/file" + std::to_string(i) + ".fits";
+        if (i % 2 == 0) {
+          output << name << '\n';
+        } else {
+          output << name << ".gz\t" << name << "\tgzip\n";
+        }
+      }
+    }
+    const path abs_path = directory.path() / filename;
+
+    map<path, path> reference;
+    const double    map_time = timeIt([&reference, &abs_path]() {
+      reference = parseWithMap("distant", "local", abs_path);
+    });
+
+    DependencyConfiguration dependencies("", "", filename);
+    const double            parse_time = timeIt([&dependencies, &filename]() {
+      dependencies = DependencyConfiguration("distant", "local", filename);
+    });
+
+    size_t       found       = 0;
+    const double lookup_time = timeIt([&dependencies, &reference, &found]() {
+      for (const auto& item : reference) {
+        if (dependencies.distantPathOf(item.first) == item.second) {
+          ++found;
+        }
+      }
+    });
+
+    if (dependencies.dependencyCount() != reference.size() or found != reference.size()) {
+      log.error() << "The dependency configuration and the reference parser differ";
+      return Elements::ExitCode::SOFTWARE;
+    }
+
+    const double mega_lines = static_cast<double>(lines) / 1.0e6;
+    log.info() << "Parsed " << lines << " dependency lines";
+    log.info() << "reference parsing into a map: " << map_time << " s (" << mega_lines / map_time << " Mlines/s)";
+    log.info() << "DependencyConfiguration:      " << parse_time << " s (" << mega_lines / parse_time
+               << " Mlines/s)";
+    log.info() << "lookup of all the files:      " << lookup_time << " s";
+
+    return Elements::ExitCode::OK;
+  }
+
+  OptionsDescription defineSpecificProgramOptions() override {
+    OptionsDescription options{};
+    options.add_options()("lines", value<size_t>()->default_value(1000000), "Number of dependency lines");
+    return options;
+  }
+};
+
+}  // namespace DataSync
+}  // namespace ElementsServices
+
+/**
+ * Implementation of a main using a base class macro
+ * This must be present in all Elements programs
+ */
+MAIN_FOR(ElementsServices::DataSync::DependencyConfigurationBenchmark)
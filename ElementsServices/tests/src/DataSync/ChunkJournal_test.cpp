@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Temporary.h"
+
+#include "ElementsServices/DataSync/ChunkJournal.h"
+
+#include "fixtures/FileContent.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::ChunkJournal;
+using DataSync::path;
+using std::string;
+
+namespace {
+
+DataSync::RemoteMetadata metadataOf(const string& version) {
+  DataSync::RemoteMetadata metadata;
+  metadata.known   = true;
+  metadata.size    = 10;
+  metadata.version = version;
+  return metadata;
+}
+
+/// write the chunk with its own content, e.g. "0123" for the first chunk of 4 bytes
+void writeChunk(ChunkJournal& journal, std::size_t index) {
+  const string content = string("0123456789").substr(journal.chunk(index).offset, journal.chunk(index).length);
+  DataSync::writeAt(journal.descriptor(), journal.chunk(index).offset, content.data(), content.size());
+  journal.complete(index);
+}
+
+}  // namespace
+
+struct ChunkJournalFixture {
+  Elements::TempDir m_dir{"ChunkJournal_test-%%%%%%%"};
+  path              m_file = m_dir.path() / "dir" / "file.bin";
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_SUITE(ChunkJournal_test, ChunkJournalFixture)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(chunks_test) {
+  ChunkJournal journal(m_file, metadataOf("v1"), 4);
+  BOOST_CHECK_EQUAL(journal.chunkCount(), 3);
+  BOOST_CHECK_EQUAL(journal.chunk(1).offset, 4);
+  BOOST_CHECK_EQUAL(journal.chunk(1).length, 4);
+  BOOST_CHECK_EQUAL(journal.chunk(2).offset, 8);
+  BOOST_CHECK_EQUAL(journal.chunk(2).length, 2);
+  BOOST_CHECK_EQUAL(journal.pendingChunks().size(), 3);
+  // the partial file is allocated
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(ChunkJournal::partialFile(m_file)), 10);
+}
+
+BOOST_AUTO_TEST_CASE(commit_test) {
+  ChunkJournal journal(m_file, metadataOf("v1"), 4);
+  writeChunk(journal, 2);
+  writeChunk(journal, 0);
+  BOOST_CHECK_THROW(journal.commit(), std::runtime_error);
+  writeChunk(journal, 1);
+  journal.commit();
+  BOOST_CHECK_EQUAL(contentOf(m_file), "0123456789");
+  BOOST_CHECK(not boost::filesystem::exists(ChunkJournal::partialFile(m_file)));
+  BOOST_CHECK(not boost::filesystem::exists(ChunkJournal::journalFile(m_file)));
+}
+
+BOOST_AUTO_TEST_CASE(resume_test) {
+  {
+    ChunkJournal interrupted(m_file, metadataOf("v1"), 4);
+    writeChunk(interrupted, 0);
+    writeChunk(interrupted, 2);
+  }
+  ChunkJournal journal(m_file, metadataOf("v1"), 4);
+  BOOST_CHECK(journal.pendingChunks() == std::vector<std::size_t>({1}));
+  writeChunk(journal, 1);
+  journal.commit();
+  BOOST_CHECK_EQUAL(contentOf(m_file), "0123456789");
+}
+
+BOOST_AUTO_TEST_CASE(tornJournal_test) {
+  {
+    ChunkJournal interrupted(m_file, metadataOf("v1"), 4);
+    writeChunk(interrupted, 0);
+  }
+  std::ofstream(ChunkJournal::journalFile(m_file).c_str(), std::ios::app) << "1x";
+  ChunkJournal journal(m_file, metadataOf("v1"), 4);
+  BOOST_CHECK(journal.pendingChunks() == std::vector<std::size_t>({1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(restart_test) {
+  {
+    ChunkJournal interrupted(m_file, metadataOf("v1"), 4);
+    writeChunk(interrupted, 0);
+  }
+  // another version of the distant file
+  BOOST_CHECK_EQUAL(ChunkJournal(m_file, metadataOf("v2"), 4).pendingChunks().size(), 3);
+  {
+    ChunkJournal interrupted(m_file, metadataOf("v2"), 4);
+    writeChunk(interrupted, 0);
+  }
+  // another chunk size
+  BOOST_CHECK_EQUAL(ChunkJournal(m_file, metadataOf("v2"), 5).pendingChunks().size(), 2);
+  {
+    ChunkJournal interrupted(m_file, metadataOf("v2"), 5);
+    writeChunk(interrupted, 0);
+  }
+  // a partial file which was altered
+  boost::filesystem::resize_file(ChunkJournal::partialFile(m_file), 4);
+  BOOST_CHECK_EQUAL(ChunkJournal(m_file, metadataOf("v2"), 5).pendingChunks().size(), 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
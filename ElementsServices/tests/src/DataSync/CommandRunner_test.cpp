@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <signal.h>  // for SIGKILL
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Temporary.h"
+#include "ElementsServices/DataSync/CommandRunner.h"
+
+#include "fixtures/FileContent.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::CommandLimits;
+using DataSync::runCommand;
+using std::string;
+
+namespace {
+
+CommandLimits limitsOf(int wallMs, int idleMs) {
+  CommandLimits limits;
+  limits.wallTimeout = std::chrono::milliseconds(wallMs);
+  limits.idleTimeout = std::chrono::milliseconds(idleMs);
+  return limits;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(CommandRunner_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(outputs_test) {
+  const auto result = runCommand("echo out; echo err >&2; echo out2");
+  BOOST_CHECK_EQUAL(result.out, "out\nout2\n");
+  BOOST_CHECK_EQUAL(result.err, "err\n");
+  BOOST_CHECK(result.succeeded());
+  BOOST_CHECK_EQUAL(result.exitCode, 0);
+  BOOST_CHECK(not result.timedOut);
+}
+
+BOOST_AUTO_TEST_CASE(largeOutputs_test) {
+  // more than the pipe capacities, on both outputs
+  const auto result = runCommand("head -c 1000000 /dev/zero; head -c 1000000 /dev/zero >&2; head -c 10 /dev/zero");
+  BOOST_CHECK_EQUAL(result.out.size(), 1000010);
+  BOOST_CHECK_EQUAL(result.err.size(), 1000000);
+  BOOST_CHECK(result.succeeded());
+}
+
+BOOST_AUTO_TEST_CASE(noInput_test) {
+  const auto result = runCommand("cat", limitsOf(5000, 0));
+  BOOST_CHECK(result.succeeded());
+  BOOST_CHECK_EQUAL(result.out, "");
+}
+
+BOOST_AUTO_TEST_CASE(exitStatus_test) {
+  const auto failed = runCommand("echo first >&2; echo 'the reason' >&2; exit 3");
+  BOOST_CHECK(not failed.succeeded());
+  BOOST_CHECK_EQUAL(failed.exitCode, 3);
+  BOOST_CHECK_EQUAL(failed.failure(), "exit code 3: the reason");
+  const auto killed = runCommand("kill -9 $$");
+  BOOST_CHECK(not killed.succeeded());
+  BOOST_CHECK_EQUAL(killed.signal, SIGKILL);
+  BOOST_CHECK_EQUAL(killed.exitCode, -1);
+}
+
+BOOST_AUTO_TEST_CASE(wallTimeout_test) {
+  // the grandchild keeps the outputs open: it must be killed with its group
+  const auto result = runCommand("sleep 30 & echo started; sleep 30", limitsOf(300, 0));
+  BOOST_CHECK(result.timedOut);
+  BOOST_CHECK(not result.succeeded());
+  BOOST_CHECK_EQUAL(result.out, "started\n");
+  BOOST_CHECK_EQUAL(result.signal, SIGKILL);
+  BOOST_CHECK_GE(result.wallTime.count(), 300);
+  BOOST_CHECK_LT(result.wallTime.count(), 10000);
+  BOOST_CHECK(result.failure().find("timed out") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(closedOutputsTimeout_test) {
+  const auto result = runCommand("exec >&- 2>&-; sleep 30", limitsOf(300, 0));
+  BOOST_CHECK(result.timedOut);
+  BOOST_CHECK_LT(result.wallTime.count(), 10000);
+}
+
+BOOST_AUTO_TEST_CASE(idleTimeout_test) {
+  // the output resets the idle timeout
+  const auto active = runCommand("for i in 1 2 3 4 5; do echo $i; sleep 0.1; done", limitsOf(0, 2000));
+  BOOST_CHECK(active.succeeded());
+  const auto idle = runCommand("echo started; sleep 30", limitsOf(0, 300));
+  BOOST_CHECK(idle.timedOut);
+  BOOST_CHECK_EQUAL(idle.out, "started\n");
+  BOOST_CHECK_LT(idle.wallTime.count(), 10000);
+}
+
+BOOST_AUTO_TEST_CASE(resourceUsage_test) {
+  const auto result = runCommand("i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done");
+  BOOST_CHECK(result.succeeded());
+  BOOST_CHECK_GT(result.userTime + result.systemTime, 0.);
+  BOOST_CHECK_GT(result.maxResidentKb, 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrentCommands_test) {
+  // a child must not inherit the pipes of the others, otherwise the quick ones would wait for the slow one
+  std::vector<std::thread>               threads;
+  std::vector<std::chrono::milliseconds> durations(8);
+  for (std::size_t i = 0; i < durations.size(); ++i) {
+    threads.emplace_back([i, &durations]() {
+      const auto result = runCommand(i == 0 ? "sleep 3" : "echo " + std::to_string(i));
+      durations[i]      = result.wallTime;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (std::size_t i = 1; i < durations.size(); ++i) {
+    BOOST_CHECK_LT(durations[i].count(), 2500);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(pipedCommand_test) {
+  // more than the socket buffer, so that the writes wait for the command
+  Elements::TempFile      output;
+  DataSync::PipedCommand  command("wc -c", output.path().string());
+  const std::vector<char> data(1000000, 'x');
+  command.write(data.data(), data.size());
+  const auto result = command.finish();
+  BOOST_CHECK(result.succeeded());
+  BOOST_CHECK_EQUAL(std::stoi(contentOf(output.path())), 1000000);
+}
+
+BOOST_AUTO_TEST_CASE(pipedCommands_test) {
+  Elements::TempFile     output;
+  DataSync::PipedCommand command("gzip -c | gzip -dc", output.path().string());
+  const auto             producer = runCommand("echo line1; echo line2", CommandLimits(), command.input());
+  BOOST_CHECK(producer.succeeded());
+  BOOST_CHECK_EQUAL(producer.out, "");
+  BOOST_CHECK(command.finish().succeeded());
+  BOOST_CHECK_EQUAL(contentOf(output.path()), "line1\nline2\n");
+}
+
+BOOST_AUTO_TEST_CASE(pipedCommandFailure_test) {
+  Elements::TempFile     output;
+  DataSync::PipedCommand command("gzip -dc", output.path().string());
+  command.write("garbage", 7);
+  const auto result = command.finish();
+  BOOST_CHECK(not result.succeeded());
+  BOOST_CHECK(not result.err.empty());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -73,7 +73,11 @@ BOOST_FIXTURE_TEST_CASE(localWorkspacePrefix_test, WorkspaceFixture) {
   }
 }
 
-// @TODO runCommand_err_test
+BOOST_AUTO_TEST_CASE(runCommand_err_test) {
+  const auto outerr = DataSync::runCommandAndCaptureOutErr("echo out; echo err >&2; false");
+  BOOST_CHECK_EQUAL(outerr.first, "out\n");
+  BOOST_CHECK_EQUAL(outerr.second, "err\n");
+}
 
 BOOST_AUTO_TEST_CASE(containsInThisOrder_test) {
 
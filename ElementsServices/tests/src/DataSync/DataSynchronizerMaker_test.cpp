@@ -22,10 +22,16 @@
  * @author user
  */
 
+#include <memory>
+
 #include <boost/test/unit_test.hpp>
 
 #include "ElementsServices/DataSync/DataSynchronizerMaker.h"
 
+#include "fixtures/ConfigFilesFixture.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE(DataSynchronizerMaker_test)
@@ -37,6 +43,18 @@ BOOST_AUTO_TEST_CASE(missing_test) {
   // @TODO implement test
 }
 
+BOOST_FIXTURE_TEST_CASE(webdavHostUsesTheNativeClient_test, WorkspaceFixture) {
+  const DataSync::ConnectionConfiguration connection(theWebdavFrConfig());
+  const DataSync::DependencyConfiguration dependency(connection.distantRoot, connection.localRoot,
+                                                     theDependencyConfig());
+  // the host URL is https
+  if (DataSync::httpIsAvailable(true)) {
+    BOOST_CHECK(std::dynamic_pointer_cast<DataSync::HttpSynchronizer>(createSynchronizer(connection, dependency)));
+  } else if (DataSync::webdavIsInstalled()) {
+    BOOST_CHECK(std::dynamic_pointer_cast<DataSync::WebdavSynchronizer>(createSynchronizer(connection, dependency)));
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,11 +16,23 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
 
+#include "ElementsServices/DataSync/CommandRunner.h"
 #include "ElementsServices/DataSync/DataSynchronizer.h"
+#include "ElementsServices/DataSync/FileLock.h"
 
 #include "fixtures/ConfigFilesFixture.h"
+#include "fixtures/LocalDataSynchronizer.h"
 #include "fixtures/MockDataSynchronizer.h"
 
 namespace DataSync = ElementsServices::DataSync;
@@ -38,6 +50,407 @@ BOOST_AUTO_TEST_CASE(downloadFailure_test) {
 
 // @TODO test overwriting policy
 
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_SUITE(ParallelDataSynchronizer_test, LocalDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(parallelDownload_test) {
+  BOOST_CHECK_EQUAL(m_connection.parallelTransfers, 4);
+  BOOST_CHECK_EQUAL(m_connection.transfersPerHost, 4);
+  downloadAllFiles();
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), distantFiles[i].string());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(allFailuresReported_test) {
+  boost::filesystem::remove(distantRoot() / "file1.txt");
+  boost::filesystem::remove(distantRoot() / "dir/file4.txt");
+  try {
+    downloadAllFiles();
+    BOOST_FAIL("DownloadFailed not thrown");
+  } catch (const DataSync::DownloadFailed& e) {
+    const std::string message = e.what();
+    BOOST_CHECK(DataSync::containsInThisOrder(message, {"2 file(s)"}));
+    BOOST_CHECK(DataSync::containsInThisOrder(message, {"file1.txt"}));
+    BOOST_CHECK(DataSync::containsInThisOrder(message, {"dir/file4.txt"}));
+  }
+  // The other files have been downloaded anyway
+  BOOST_CHECK(boost::filesystem::is_regular_file(localRoot() / "file2.txt"));
+  BOOST_CHECK(boost::filesystem::is_regular_file(localRoot() / "file5.txt"));
+}
+
+BOOST_AUTO_TEST_CASE(transfersAreMeasured_test) {
+  m_connection.metricsFile = localRoot() / "metrics.json";
+  boost::filesystem::remove(distantRoot() / "file1.txt");
+  BOOST_CHECK_THROW(downloadAllFiles(), DataSync::DownloadFailed);
+  const auto summary = metrics().summary();
+  BOOST_CHECK_EQUAL(summary.submitted, 5);
+  BOOST_CHECK_EQUAL(summary.succeeded, 4);
+  BOOST_CHECK_EQUAL(summary.failed, 1);
+  BOOST_CHECK_EQUAL(summary.queued(), 0);
+  // the distant files contain their relative path
+  BOOST_CHECK_EQUAL(summary.bytes, std::string("file2-V1.txtfile3.txtdir/file4.txtdir/file5-V2.txt").size());
+  for (const auto& file : metrics().files()) {
+    BOOST_CHECK_EQUAL(file.tries, 1);
+  }
+  BOOST_CHECK(contentOf(m_connection.metricsFile).find("\"failed\": 1") != std::string::npos);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+struct IncrementalDataSynchronizer : public LocalDataSynchronizer {
+  IncrementalDataSynchronizer() : LocalDataSynchronizer(theLocalIncrementalConfig()) {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(IncrementalDataSynchronizer_test, IncrementalDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(unchangedFilesAreSkipped_test) {
+  BOOST_CHECK(m_connection.incrementalSyncEnabled());
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+  BOOST_CHECK(boost::filesystem::is_regular_file(manifestFile()));
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+  // nothing was transferred
+  const auto summary = metrics().summary();
+  BOOST_CHECK_EQUAL(summary.succeeded, 5);
+  BOOST_CHECK_EQUAL(summary.skipped, 5);
+  BOOST_CHECK_EQUAL(summary.bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(changedFilesAreDownloaded_test) {
+  downloadAllFiles();
+  // The overwriting policy is ignored in incremental mode
+  writeFile(distantRoot() / "file3.txt", "distant update");
+  writeFile(localRoot() / "file1.txt", "local modification");
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 7);
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "dir/file3.txt"), "distant update");
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file1.txt"), "file1.txt");
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+struct CachedDataSynchronizer : public LocalDataSynchronizer {
+  CachedDataSynchronizer() : LocalDataSynchronizer(theLocalCacheConfig()) {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(CachedDataSynchronizer_test, CachedDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(filesAreSharedThroughTheCache_test) {
+  BOOST_CHECK(m_connection.objectCacheEnabled());
+  BOOST_CHECK_EQUAL(m_connection.cacheCapacity, 1024 * 1024);
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+  // another workspace gets the same files from the cache
+  boost::filesystem::remove_all(localRoot());
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+  BOOST_CHECK_EQUAL(metrics().summary().skipped, 5);
+  BOOST_CHECK_EQUAL(metrics().summary().bytes, 0);
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), distantFiles[i].string());
+    BOOST_CHECK_EQUAL(boost::filesystem::hard_link_count(localRoot() / localFiles[i]), 2);
+  }
+  // a new version of a distant file is a new object
+  writeFile(distantRoot() / "file1.txt", "new version");
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 6);
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file1.txt"), "new version");
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief A local host which fails the first tries of each file, like a flaky network.
+ */
+struct FlakyDataSynchronizer : public LocalDataSynchronizer {
+
+  FlakyDataSynchronizer() : LocalDataSynchronizer() {
+    m_breaker = std::make_shared<DataSync::CircuitBreaker>(0, std::chrono::milliseconds(0));
+  }
+
+  std::string createDownloadCommand(DataSync::path distantFile, DataSync::path localFile) const override {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (++m_attempts[distantFile] <= m_failuresPerFile) {
+        return "echo 'Connection reset by peer' >&2; exit 4";
+      }
+    }
+    return LocalDataSynchronizer::createDownloadCommand(distantFile, localFile);
+  }
+
+  int attemptsOf(const std::string& distantFile) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_attempts[distantRoot() / distantFile];
+  }
+
+  int                                   m_failuresPerFile = 2;
+  mutable std::map<DataSync::path, int> m_attempts;
+  mutable std::mutex                    m_mutex;
+};
+
+BOOST_FIXTURE_TEST_SUITE(RetryingDataSynchronizer_test, FlakyDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(transientFailuresAreRetried_test) {
+  BOOST_CHECK_EQUAL(m_connection.tries, 4);
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), distantFiles[i].string());
+    BOOST_CHECK_EQUAL(attemptsOf(distantFiles[i].string()), 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(triesAreLimited_test) {
+  m_failuresPerFile = 10;
+  try {
+    downloadAllFiles();
+    BOOST_FAIL("DownloadFailed not thrown");
+  } catch (const DataSync::DownloadFailed& e) {
+    BOOST_CHECK(DataSync::containsInThisOrder(e.what(), {"5 file(s)", "exit code 4: Connection reset by peer"}));
+  }
+  BOOST_CHECK_EQUAL(attemptsOf("file1.txt"), 4);
+}
+
+BOOST_AUTO_TEST_CASE(missingFilesAreNotRetried_test) {
+  m_failuresPerFile = 0;
+  boost::filesystem::remove(distantRoot() / "file1.txt");
+  BOOST_CHECK_THROW(downloadAllFiles(), DataSync::DownloadFailed);
+  BOOST_CHECK_EQUAL(attemptsOf("file1.txt"), 1);
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief A mirror of a local host, with its own distant files.
+ */
+struct MirrorSynchronizer : public DataSync::DataSynchronizer {
+
+  explicit MirrorSynchronizer(const LocalDataSynchronizer& primary)
+      : DataSync::DataSynchronizer(
+            DataSync::ConnectionConfiguration(theLocalParallelConfig()),
+            DataSync::DependencyConfiguration(primary.m_top_dir.path() / "mirror", primary.localRoot(),
+                                              theDependencyConfig())) {
+    for (const auto& file : theDistantFiles()) {
+      const DataSync::path distantFile = primary.m_top_dir.path() / "mirror" / file;
+      DataSync::createLocalDirOf(distantFile);
+      writeFile(distantFile, "mirror " + file.string());
+    }
+  }
+
+  std::string createDownloadCommand(DataSync::path distantFile, DataSync::path localFile) const override {
+    return "cp " + distantFile.string() + " " + localFile.string();
+  }
+};
+
+struct FallbackDataSynchronizer : public FlakyDataSynchronizer {
+
+  FallbackDataSynchronizer() : FlakyDataSynchronizer(), m_mirror(std::make_shared<MirrorSynchronizer>(*this)) {
+    m_failuresPerFile = 0;
+    setFallback(m_mirror);
+  }
+
+  std::shared_ptr<MirrorSynchronizer> m_mirror;
+};
+
+BOOST_FIXTURE_TEST_SUITE(FallbackDataSynchronizer_test, FallbackDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(failedFilesComeFromTheFallback_test) {
+  boost::filesystem::remove(distantRoot() / "file1.txt");
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file1.txt"), "mirror file1.txt");
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file2.txt"), "file2-V1.txt");
+}
+
+BOOST_AUTO_TEST_CASE(degradedHostIsBypassed_test) {
+  m_failuresPerFile = 10;
+  m_breaker         = std::make_shared<DataSync::CircuitBreaker>(1, std::chrono::seconds(60));
+  downloadAllFiles();
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  int        attempts     = 0;
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), "mirror " + distantFiles[i].string());
+    attempts += attemptsOf(distantFiles[i].string());
+  }
+  // at most one try per worker before the circuit opens
+  BOOST_CHECK_LE(attempts, 4);
+  BOOST_CHECK(m_breaker->isOpen());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief A local host which serves the first file compressed with gzip,
+ * and which can stream the downloads or not.
+ */
+struct CompressedDataSynchronizer : public LocalDataSynchronizer {
+
+  explicit CompressedDataSynchronizer(DataSync::path connection = theLocalParallelConfig())
+      : LocalDataSynchronizer(connection, theCompressedDependencyConfig()) {
+    const auto distantFile = (distantRoot() / "file1.txt").string();
+    BOOST_REQUIRE(DataSync::runCommand("gzip -c " + distantFile + " > " + distantFile + ".gz").succeeded());
+  }
+
+  std::string createStreamingDownloadCommand(DataSync::path distantFile) const override {
+    return m_streaming ? "cat " + distantFile.string() : "";
+  }
+
+  bool m_streaming = false;
+};
+
+BOOST_FIXTURE_TEST_SUITE(CompressedDataSynchronizer_test, CompressedDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(compressedFilesAreDecompressed_test) {
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file1.txt"), "file1.txt");
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "dir/file4.txt"), "dir/file4.txt");
+  BOOST_CHECK(not boost::filesystem::exists(localRoot() / "file1.txt.compressed"));
+}
+
+BOOST_AUTO_TEST_CASE(compressedFilesAreStreamed_test) {
+  m_streaming = true;
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file1.txt"), "file1.txt");
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "dir/file4.txt"), "dir/file4.txt");
+  // only the uncompressed file is copied
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(corruptedArchiveIsReported_test) {
+  m_streaming = true;
+  writeFile(distantRoot() / "file1.txt.gz", "not a gzip archive");
+  BOOST_CHECK_THROW(downloadAllFiles(), DataSync::DownloadFailed);
+  BOOST_CHECK(not boost::filesystem::exists(localRoot() / "file1.txt"));
+}
+
+BOOST_AUTO_TEST_CASE(corruptedDownloadIsReported_test) {
+  writeFile(distantRoot() / "file1.txt.gz", "not a gzip archive");
+  BOOST_CHECK_THROW(downloadAllFiles(), DataSync::DownloadFailed);
+  BOOST_CHECK(not boost::filesystem::exists(localRoot() / "file1.txt"));
+  BOOST_CHECK(not boost::filesystem::exists(localRoot() / "file1.txt.compressed"));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+struct IncrementalCompressedDataSynchronizer : public CompressedDataSynchronizer {
+  IncrementalCompressedDataSynchronizer() : CompressedDataSynchronizer(theLocalIncrementalConfig()) {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(IncrementalCompressedDataSynchronizer_test, IncrementalCompressedDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(decompressedFilesAreSkipped_test) {
+  // the manifest compares the size of the archive, not of the decompressed file
+  downloadAllFiles();
+  const auto downloadCount = m_downloadCount.load();
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file1.txt"), "file1.txt");
+  downloadAllFiles();
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), downloadCount);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief A local host whose downloads are slow enough to overlap with the ones of another process.
+ */
+struct SlowDataSynchronizer : public DataSync::DataSynchronizer {
+
+  explicit SlowDataSynchronizer(const LocalDataSynchronizer& workspace)
+      : DataSync::DataSynchronizer(
+            DataSync::ConnectionConfiguration(theLocalParallelConfig()),
+            DataSync::DependencyConfiguration(workspace.distantRoot(), workspace.localRoot(), theDependencyConfig())) {}
+
+  std::string createDownloadCommand(DataSync::path distantFile, DataSync::path localFile) const override {
+    ++m_downloadCount;
+    return "sleep 0.2; cp " + distantFile.string() + " " + localFile.string();
+  }
+
+  mutable std::atomic<int> m_downloadCount{0};
+};
+
+BOOST_FIXTURE_TEST_SUITE(ConcurrentDataSynchronizer_test, LocalDataSynchronizer)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(filesAreDownloadedOnce_test) {
+  // two processes sharing the workspace
+  const SlowDataSynchronizer first(*this);
+  const SlowDataSynchronizer second(*this);
+  std::thread                concurrent([&second]() {
+    second.downloadAllFiles();
+  });
+  first.downloadAllFiles();
+  concurrent.join();
+  BOOST_CHECK_EQUAL(first.m_downloadCount.load() + second.m_downloadCount.load(), 5);
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), distantFiles[i].string());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(failedFilesLeaveNothing_test) {
+  boost::filesystem::remove(distantRoot() / "file1.txt");
+  BOOST_CHECK_THROW(downloadAllFiles(), DataSync::DownloadFailed);
+  BOOST_CHECK(not boost::filesystem::exists(localRoot() / "file1.txt"));
+  for (boost::filesystem::directory_iterator it(localRoot()), end; it != end; ++it) {
+    BOOST_CHECK(not DataSync::isPartialPath(it->path()));
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -17,9 +17,12 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "ElementsServices/DataSync/Compression.h"
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 
 #include "fixtures/ConfigFilesFixture.h"
@@ -74,6 +77,53 @@ BOOST_AUTO_TEST_CASE(conf_dependencies_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(conf_dependencies_in_file_order_test) {
+  DataSync::DependencyConfiguration config("", "local", theDependencyConfig());
+  const auto                        found_files = config.localPathsInFileOrder();
+  const auto                        expected    = theLocalFiles();
+  BOOST_REQUIRE_EQUAL(found_files.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    BOOST_CHECK_EQUAL(found_files[i], "local" / expected[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(indexed_dependencies_test) {
+  DataSync::DependencyConfiguration config("distant", "local", theCompressedDependencyConfig());
+  BOOST_REQUIRE_EQUAL(config.dependencyCount(), 2);
+  const std::size_t index = config.indexOf("local/file1.txt");
+  BOOST_REQUIRE_LT(index, config.dependencyCount());
+  BOOST_CHECK_EQUAL(config.localPathAt(index), "local/file1.txt");
+  BOOST_CHECK_EQUAL(config.distantPathAt(index), "distant/file1.txt.gz");
+  BOOST_CHECK(config.compressionAt(index) == DataSync::Compression::GZIP);
+  BOOST_CHECK_EQUAL(config.indexOf("local/missing.txt"), config.dependencyCount());
+  BOOST_CHECK_EQUAL(config.indexOf("distant/file1.txt"), config.dependencyCount());
+  BOOST_CHECK_THROW(config.distantPathOf("local/missing.txt"), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(duplicated_dependencies_test) {
+  DependencyConfigurationPublic config("distant", "local", theCompressedDependencyConfig());
+  const string                  separator(1, config.aliasSeparator());
+  config.parseLineWithAlias("file1-V2.txt" + separator + "file1.txt");
+  config.parseLineWithoutAlias("file6.txt");
+  BOOST_CHECK_EQUAL(config.dependencyCount(), 3);
+  BOOST_CHECK_EQUAL(config.distantPathOf("local/file1.txt"), "distant/file1-V2.txt");
+  BOOST_CHECK(config.compressionOf("local/file1.txt") == DataSync::Compression::NONE);
+  const auto found_files = config.localPathsInFileOrder();
+  BOOST_REQUIRE_EQUAL(found_files.size(), 3);
+  BOOST_CHECK_EQUAL(found_files[0], "local/file1.txt");
+  BOOST_CHECK_EQUAL(found_files[1], "local/dir/file4.txt");
+  BOOST_CHECK_EQUAL(found_files[2], "local/file6.txt");
+}
+
+BOOST_AUTO_TEST_CASE(conf_compressions_test) {
+  DataSync::DependencyConfiguration config("distant", "local", theCompressedDependencyConfig());
+  BOOST_CHECK_EQUAL(config.distantPathOf("local/file1.txt"), "distant/file1.txt.gz");
+  BOOST_CHECK(config.compressionOf("local/file1.txt") == DataSync::Compression::GZIP);
+  BOOST_CHECK(config.compressionOf("local/dir/file4.txt") == DataSync::Compression::NONE);
+  BOOST_CHECK_EQUAL(config.compressions().size(), 1);
+  BOOST_CHECK_THROW(DataSync::compressionFromName("rar"), std::runtime_error);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsServices/DataSync/DownloadScheduler.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::DownloadScheduler;
+using DataSync::path;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DownloadScheduler_test)
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Track the maximum number of tasks running at the same time.
+ */
+struct ConcurrencyProbe {
+  std::atomic<int> active{0};
+  std::atomic<int> maximum{0};
+  std::atomic<int> done{0};
+  void run() {
+    const int current = ++active;
+    int       previous = maximum.load();
+    while (current > previous and not maximum.compare_exchange_weak(previous, current)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --active;
+    ++done;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(allTasksRun_test) {
+  ConcurrencyProbe probe;
+  {
+    DownloadScheduler scheduler(4);
+    BOOST_CHECK_EQUAL(scheduler.workerCount(), 4);
+    for (int i = 0; i < 20; ++i) {
+      scheduler.submit("host", "distant", "local", [&probe]() {
+        probe.run();
+      });
+    }
+    BOOST_CHECK(scheduler.wait().empty());
+  }
+  BOOST_CHECK_EQUAL(probe.done.load(), 20);
+  BOOST_CHECK_GT(probe.maximum.load(), 1);
+  BOOST_CHECK_LE(probe.maximum.load(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(hostLimit_test) {
+  ConcurrencyProbe first;
+  ConcurrencyProbe second;
+  DownloadScheduler scheduler(6, 2, 4);
+  for (int i = 0; i < 10; ++i) {
+    scheduler.submit("first", "distant", "local", [&first]() {
+      first.run();
+    });
+    scheduler.submit("second", "distant", "local", [&second]() {
+      second.run();
+    });
+  }
+  BOOST_CHECK(scheduler.wait().empty());
+  BOOST_CHECK_EQUAL(first.done.load(), 10);
+  BOOST_CHECK_EQUAL(second.done.load(), 10);
+  BOOST_CHECK_LE(first.maximum.load(), 2);
+  BOOST_CHECK_LE(second.maximum.load(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(failuresAreCollected_test) {
+  DownloadScheduler scheduler(3);
+  std::atomic<int>  done{0};
+  for (int i = 0; i < 9; ++i) {
+    const path local = "local" + std::to_string(i);
+    scheduler.submit("host", "distant", local, [i, &done]() {
+      ++done;
+      if (i % 3 == 0) {
+        throw std::runtime_error("failure " + std::to_string(i));
+      }
+    });
+  }
+  const auto failures = scheduler.wait();
+  BOOST_CHECK_EQUAL(done.load(), 9);
+  BOOST_CHECK_EQUAL(failures.size(), 3);
+  for (const auto& failure : failures) {
+    BOOST_CHECK_EQUAL(failure.reason, "failure " + failure.localFile.string().substr(5));
+  }
+  // The failures are reported once
+  BOOST_CHECK(scheduler.wait().empty());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <sys/file.h>  // for LOCK_EX, LOCK_NB
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Temporary.h"
+#include "ElementsServices/DataSync/FileLock.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::DownloadLock;
+using DataSync::path;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FileLock_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(partialPathsAreUnique_test) {
+  std::set<path> paths;
+  for (int i = 0; i < 100; ++i) {
+    const path partial = DataSync::uniquePartialPath("dir/file.fits");
+    BOOST_CHECK(DataSync::isPartialPath(partial));
+    BOOST_CHECK_EQUAL(partial.parent_path(), "dir");
+    paths.insert(partial);
+  }
+  BOOST_CHECK_EQUAL(paths.size(), 100);
+  BOOST_CHECK(not DataSync::isPartialPath("dir/file.fits.part"));
+}
+
+BOOST_AUTO_TEST_CASE(lockIsExclusive_test) {
+  Elements::TempDir  dir;
+  const path         lockFile = dir.path() / "file.lock";
+  DataSync::FileLock first(lockFile, LOCK_EX);
+  BOOST_CHECK(first.locked());
+  // the locks of the threads conflict, like the ones of the processes
+  DataSync::FileLock second(lockFile, LOCK_EX | LOCK_NB);
+  BOOST_CHECK(not second.locked());
+}
+
+BOOST_AUTO_TEST_CASE(removedLockFileIsLockedAgain_test) {
+  Elements::TempDir                   dir;
+  const path                          lockFile = dir.path() / "file.lock";
+  std::unique_ptr<DataSync::FileLock> holder(new DataSync::FileLock(lockFile, LOCK_EX));
+  std::unique_ptr<DataSync::FileLock> waiter;
+  std::thread                         waiting([&]() {
+    waiter.reset(new DataSync::FileLock(lockFile, LOCK_EX));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // e.g. an eviction from the object cache
+  boost::filesystem::remove(lockFile);
+  holder.reset();
+  waiting.join();
+  BOOST_REQUIRE(waiter->locked());
+  BOOST_CHECK(boost::filesystem::exists(lockFile));
+  // the waiter still excludes the next comers
+  DataSync::FileLock next(lockFile, LOCK_EX | LOCK_NB);
+  BOOST_CHECK(not next.locked());
+}
+
+BOOST_AUTO_TEST_CASE(partialFilesAreRemoved_test) {
+  Elements::TempDir dir;
+  const path        localFile = dir.path() / "file.fits";
+  const path        leftover  = DataSync::uniquePartialPath(localFile);
+  std::ofstream(leftover.c_str()) << "partial";
+  std::ofstream((localFile.string() + ".part").c_str()) << "resumable";
+  {
+    const auto lock = DownloadLock::tryLock(dir.path() / "locks", localFile);
+    BOOST_REQUIRE(lock);
+    BOOST_CHECK(not DownloadLock::tryLock(dir.path() / "locks", localFile));
+    BOOST_CHECK(not lock->downloadedMeanwhile());
+  }
+  BOOST_CHECK(not boost::filesystem::exists(leftover));
+  // the chunk journals are resumed, not removed
+  BOOST_CHECK(boost::filesystem::exists(localFile.string() + ".part"));
+  BOOST_CHECK(DownloadLock::tryLock(dir.path() / "locks", localFile));
+}
+
+BOOST_AUTO_TEST_CASE(waiterSeesTheDownload_test) {
+  Elements::TempDir             dir;
+  const path                    locks     = dir.path() / "locks";
+  const path                    localFile = dir.path() / "file.fits";
+  std::unique_ptr<DownloadLock> holder(new DownloadLock(locks, localFile));
+  bool                          downloadedMeanwhile = false;
+  std::thread                   waiter([&]() {
+    const DownloadLock lock(locks, localFile);
+    downloadedMeanwhile = lock.downloadedMeanwhile();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  std::ofstream(localFile.c_str()) << "downloaded";
+  holder->markDownloaded();
+  holder.reset();
+  waiter.join();
+  BOOST_CHECK(downloadedMeanwhile);
+  // a later process downloads it again
+  const DownloadLock later(locks, localFile);
+  BOOST_CHECK(not later.downloadedMeanwhile());
+}
+
+BOOST_AUTO_TEST_CASE(failedDownloadIsRetriedByTheWaiter_test) {
+  Elements::TempDir             dir;
+  const path                    locks     = dir.path() / "locks";
+  const path                    localFile = dir.path() / "file.fits";
+  std::unique_ptr<DownloadLock> holder(new DownloadLock(locks, localFile));
+  bool                          downloadedMeanwhile = true;
+  std::thread                   waiter([&]() {
+    const DownloadLock lock(locks, localFile);
+    downloadedMeanwhile = lock.downloadedMeanwhile();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  holder.reset();
+  waiter.join();
+  BOOST_CHECK(not downloadedMeanwhile);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
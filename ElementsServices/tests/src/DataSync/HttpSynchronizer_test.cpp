@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/version.hpp>
+
+#include "ElementsServices/DataSync/ChunkJournal.h"
+#include "ElementsServices/DataSync/CommandRunner.h"
+#include "ElementsServices/DataSync/HttpSynchronizer.h"
+
+#include "fixtures/ConfigFilesFixture.h"
+#include "fixtures/FileContent.h"
+#include "fixtures/LocalHttpServer.h"
+
+using std::string;
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::path;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(HttpSynchronizer_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(basicAuthorization_test) {
+  // RFC 7617 example
+  BOOST_CHECK_EQUAL(DataSync::basicAuthorization("Aladdin", "open sesame"), "Basic QWxhZGRpbjpvcGVuIHNlc2FtZQ==");
+  BOOST_CHECK_EQUAL(DataSync::basicAuthorization("a", "b"), "Basic YTpi");
+  BOOST_CHECK_EQUAL(DataSync::basicAuthorization("", ""), "");
+}
+
+#if BOOST_VERSION >= 107000
+
+/**
+ * @brief A local HTTP server which serves the distant files, and a synchronizer.
+ */
+struct HttpFixture : public WorkspaceFixture {
+
+  HttpFixture() : WorkspaceFixture(), m_server(createDistantFiles(), DataSync::basicAuthorization("user", "secret")) {}
+
+  path createDistantFiles() {
+    for (const auto& file : theDistantFiles()) {
+      const path distantFile = m_top_dir.path() / "distant" / file;
+      DataSync::createLocalDirOf(distantFile);
+      writeFile(distantFile, file.string());
+    }
+    return m_top_dir.path();
+  }
+
+  DataSync::HttpSynchronizer createSynchronizer(const string& password = "secret", std::uint64_t chunkSize = 0,
+                                                std::size_t parallelChunks = 1) {
+    DataSync::ConnectionConfiguration connection(theLocalHttpConfig());
+    connection.hostUrl        = m_server.url();
+    connection.password       = password;
+    connection.chunkSize      = chunkSize;
+    connection.parallelChunks = parallelChunks;
+    DataSync::DependencyConfiguration dependency(connection.distantRoot, connection.localRoot, theDependencyConfig());
+    return DataSync::HttpSynchronizer(connection, dependency);
+  }
+
+  /// replace the first distant file with a large one, and return its content
+  string enlargeFirstFile() {
+    string content;
+    for (int i = 0; i < 10000; ++i) {
+      content += std::to_string(1000000 + i * 7).substr(1) + "\n";
+    }
+    writeFile(distantFirstFile(), content);
+    return content;
+  }
+
+  path distantFirstFile() const {
+    return m_top_dir.path() / "distant" / theDistantFiles()[0];
+  }
+
+  path localFirstFile() const {
+    return DataSync::ConnectionConfiguration(theLocalHttpConfig()).localRoot / theLocalFiles()[0];
+  }
+
+  LocalHttpServer m_server;
+};
+
+BOOST_FIXTURE_TEST_CASE(connectionsAreReused_test, HttpFixture) {
+  auto synchronizer = createSynchronizer();
+  synchronizer.downloadAllFiles();
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  const path localRoot    = DataSync::ConnectionConfiguration(theLocalHttpConfig()).localRoot;
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot / localFiles[i]), distantFiles[i].string());
+  }
+  BOOST_CHECK_EQUAL(m_server.servedRequests(), 5);
+  // at most one connection per download worker
+  BOOST_CHECK_LE(m_server.acceptedConnections(), 3);
+  BOOST_CHECK_EQUAL(synchronizer.openedConnections(), m_server.acceptedConnections());
+  // the native client reports the received bytes
+  for (const auto& file : synchronizer.metrics().files()) {
+    BOOST_CHECK_GE(file.bytes, file.distantFile.filename().string().size());
+    BOOST_CHECK_GE(file.firstByteSeconds, 0.);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(failuresAreReported_test, HttpFixture) {
+  boost::filesystem::remove(m_top_dir.path() / "distant" / "file1.txt");
+  auto synchronizer = createSynchronizer();
+  try {
+    synchronizer.downloadAllFiles();
+    BOOST_FAIL("DownloadFailed not thrown");
+  } catch (const DataSync::DownloadFailed& e) {
+    BOOST_CHECK(DataSync::containsInThisOrder(e.what(), {"1 file(s)", "file1.txt", "HTTP 404"}));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(wrongPassword_test, HttpFixture) {
+  auto synchronizer = createSynchronizer("wrong");
+  try {
+    synchronizer.downloadAllFiles();
+    BOOST_FAIL("DownloadFailed not thrown");
+  } catch (const DataSync::DownloadFailed& e) {
+    BOOST_CHECK(DataSync::containsInThisOrder(e.what(), {"5 file(s)", "HTTP 401"}));
+    // the password is not leaked in the messages
+    BOOST_CHECK(not DataSync::containsInThisOrder(e.what(), {"wrong"}));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(remoteMetadata_test, HttpFixture) {
+  const auto synchronizer = createSynchronizer();
+  const auto metadata     = synchronizer.remoteMetadata("distant/dir/file4.txt");
+  BOOST_CHECK(metadata.known);
+  BOOST_CHECK_EQUAL(metadata.size, string("dir/file4.txt").size());
+  BOOST_CHECK_EQUAL(metadata.version.front(), '"');
+  // the redirections are followed
+  const auto redirected = synchronizer.remoteMetadata("redirect/distant/dir/file4.txt");
+  BOOST_CHECK(redirected.known);
+  BOOST_CHECK_EQUAL(redirected.version, metadata.version);
+  BOOST_CHECK(not synchronizer.remoteMetadata("distant/missing.txt").known);
+  BOOST_CHECK_EQUAL(synchronizer.openedConnections(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(chunkedDownload_test, HttpFixture) {
+  const string content      = enlargeFirstFile();
+  auto         synchronizer = createSynchronizer("secret", 16 * 1024, 3);
+  synchronizer.downloadAllFiles();
+  BOOST_CHECK(contentOf(localFirstFile()) == content);
+  BOOST_CHECK(not boost::filesystem::exists(DataSync::ChunkJournal::partialFile(localFirstFile())));
+  BOOST_CHECK(not boost::filesystem::exists(DataSync::ChunkJournal::journalFile(localFirstFile())));
+  // 5 HEAD, 4 whole small files and 5 ranges of the large one
+  BOOST_CHECK_EQUAL(m_server.servedRequests(), 5 + 4 + 5);
+}
+
+BOOST_FIXTURE_TEST_CASE(resumedDownload_test, HttpFixture) {
+  const string content      = enlargeFirstFile();
+  auto         synchronizer = createSynchronizer("secret", 16 * 1024, 2);
+  const auto   remote       = synchronizer.remoteMetadata("distant" / theDistantFiles()[0]);
+  {
+    // an interrupted download with the first 3 chunks
+    DataSync::ChunkJournal interrupted(localFirstFile(), remote, 16 * 1024);
+    for (std::size_t i = 0; i < 3; ++i) {
+      const auto chunk = interrupted.chunk(i);
+      DataSync::writeAt(interrupted.descriptor(), chunk.offset, content.data() + chunk.offset, chunk.length);
+      interrupted.complete(i);
+    }
+  }
+  const auto requestsBefore = m_server.servedRequests();
+  synchronizer.downloadAllFiles();
+  BOOST_CHECK(contentOf(localFirstFile()) == content);
+  // 5 HEAD, 4 whole small files and the 2 missing ranges of the large one
+  BOOST_CHECK_EQUAL(m_server.servedRequests() - requestsBefore, 5 + 4 + 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(changedFileIsRestarted_test, HttpFixture) {
+  const string content      = enlargeFirstFile();
+  auto         synchronizer = createSynchronizer("secret", 16 * 1024, 2);
+  auto         outdated     = synchronizer.remoteMetadata("distant" / theDistantFiles()[0]);
+  outdated.version          = "\"outdated\"";
+  {
+    DataSync::ChunkJournal interrupted(localFirstFile(), outdated, 16 * 1024);
+    const string           garbage(16 * 1024, 'x');
+    DataSync::writeAt(interrupted.descriptor(), 0, garbage.data(), garbage.size());
+    interrupted.complete(0);
+  }
+  synchronizer.downloadAllFiles();
+  BOOST_CHECK(contentOf(localFirstFile()) == content);
+}
+
+BOOST_FIXTURE_TEST_CASE(throttledDownload_test, HttpFixture) {
+  const string content(256 * 1024, 'x');
+  writeFile(distantFirstFile(), content);
+  DataSync::ConnectionConfiguration connection(theLocalHttpConfig());
+  connection.hostUrl    = m_server.url();
+  connection.chunkSize  = 0;
+  connection.bandwidth  = 256 * 1024;
+  connection.ioPriority = DataSync::IoPriority::IDLE;
+  connection.dropCache  = true;
+  DataSync::DependencyConfiguration dependency(connection.distantRoot, connection.localRoot, theDependencyConfig());
+  DataSync::HttpSynchronizer        synchronizer(connection, dependency);
+  const auto                        start = std::chrono::steady_clock::now();
+  synchronizer.downloadAllFiles();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  BOOST_CHECK(contentOf(localFirstFile()) == content);
+  // 64 kB of burst, then 192 kB at 256 kB/s
+  BOOST_CHECK_GE(elapsed.count(), 0.6);
+}
+
+BOOST_FIXTURE_TEST_CASE(decompressedDownload_test, HttpFixture) {
+  const string content = enlargeFirstFile();
+  const auto   archive = distantFirstFile().string() + ".gz";
+  BOOST_REQUIRE(DataSync::runCommand("gzip -c " + distantFirstFile().string() + " > " + archive).succeeded());
+  DataSync::ConnectionConfiguration connection(theLocalHttpConfig());
+  connection.hostUrl = m_server.url();
+  DataSync::DependencyConfiguration dependency(connection.distantRoot, connection.localRoot,
+                                               theCompressedDependencyConfig());
+  DataSync::HttpSynchronizer        synchronizer(connection, dependency);
+  synchronizer.downloadAllFiles();
+  BOOST_CHECK(contentOf(localFirstFile()) == content);
+  // a corrupted archive is reported, and no partial file is left
+  writeFile(archive, "not a gzip archive");
+  boost::filesystem::remove(localFirstFile());
+  BOOST_CHECK_THROW(synchronizer.downloadAllFiles(), DataSync::DownloadFailed);
+  BOOST_CHECK(not boost::filesystem::exists(localFirstFile()));
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <cstddef>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+#include "ElementsServices/DataSync/IrodsSynchronizer.h"
+
+#include "fixtures/ConfigFilesFixture.h"
+#include "fixtures/FileContent.h"
+#include "fixtures/MockIrodsClient.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::path;
+using std::string;
+
+namespace {
+
+struct IrodsBatchFixture : public MockIrodsClient {
+
+  IrodsBatchFixture() : MockIrodsClient(), m_distantRoot(m_top_dir.path() / "distant") {
+    for (const auto& file : theDistantFiles()) {
+      const path distantFile = m_distantRoot / file;
+      DataSync::createLocalDirOf(distantFile);
+      writeFile(distantFile, file.string());
+    }
+  }
+
+  DataSync::IrodsSynchronizer createSynchronizer() const {
+    const DataSync::ConnectionConfiguration connection(theLocalIrodsConfig());
+    const DataSync::DependencyConfiguration dependency(m_distantRoot, connection.localRoot, theDependencyConfig());
+    return DataSync::IrodsSynchronizer(connection, dependency);
+  }
+
+  path localRoot() const {
+    return DataSync::ConnectionConfiguration(theLocalIrodsConfig()).localRoot;
+  }
+
+  path m_distantRoot;
+};
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_SUITE(IrodsBatch_test, IrodsBatchFixture)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(batchesAreGroupedByDirectory_test) {
+  const auto                synchronizer = createSynchronizer();
+  const DataSync::FileBatch files        = {{"d/a.fits", "l/a.fits"},
+                                            {"d/b.fits", "l/b.fits"},
+                                            {"d/c.fits", "l/c.fits"},
+                                            {"d/d.fits", "l/sub/d.fits"},
+                                            {"d/e.fits", "l/renamed.fits"}};
+  const auto                batches      = synchronizer.groupInBatches(files);
+  // a renamed file, two batches of the l directory with at most 2 files, and one of l/sub
+  BOOST_REQUIRE_EQUAL(batches.size(), 4);
+  BOOST_CHECK_EQUAL(batches[0].size(), 1);
+  BOOST_CHECK_EQUAL(batches[0][0].second, "l/renamed.fits");
+  BOOST_CHECK_EQUAL(batches[1].size(), 2);
+  BOOST_CHECK_EQUAL(batches[2].size(), 1);
+  BOOST_CHECK_EQUAL(batches[3][0].second, "l/sub/d.fits");
+  const auto cmd = synchronizer.createBatchDownloadCommand(batches[1]);
+  BOOST_CHECK(DataSync::containsInThisOrder(cmd, {"iget -f", "d/a.fits", "d/b.fits", " l"}));
+}
+
+BOOST_AUTO_TEST_CASE(batchDownload_test) {
+  createSynchronizer().downloadAllFiles();
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), distantFiles[i].string());
+  }
+  // dir/file3.txt and dir/file4.txt in one session, the other files one by one
+  BOOST_CHECK_EQUAL(callCount("iget"), 1);
+  BOOST_CHECK_EQUAL(callCount("irsync"), 3);
+}
+
+BOOST_AUTO_TEST_CASE(failedBatchIsDownloadedFileByFile_test) {
+  boost::filesystem::remove(m_distantRoot / "file3.txt");
+  try {
+    createSynchronizer().downloadAllFiles();
+    BOOST_FAIL("DownloadFailed not thrown");
+  } catch (const DataSync::DownloadFailed& e) {
+    BOOST_CHECK(DataSync::containsInThisOrder(e.what(), {"1 file(s)", "file3.txt"}));
+  }
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "dir/file4.txt"), "dir/file4.txt");
+  // the complete file of the failed batch is kept, only the missing one is downloaded again
+  BOOST_CHECK_EQUAL(log().find("irsync i:" + (m_distantRoot / "dir/file4.txt").string()), string::npos);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -53,6 +53,16 @@ BOOST_AUTO_TEST_CASE(webdavGetCmd_test) {
   BOOST_CHECK(DataSync::containsInThisOrder(cmd, chunks));
 }
 
+BOOST_AUTO_TEST_CASE(irodsMetadataFromListing_test) {
+  const string listing  = "  rods              0 demoResc;child         2880 2020-10-05.10:00   /tempZone/file.fits\n"
+                          "  rods              1 demoResc;other         2880 2020-10-06.10:00 & /tempZone/file.fits\n";
+  const auto   metadata = DataSync::irodsMetadataFromListing(listing);
+  BOOST_CHECK(metadata.known);
+  BOOST_CHECK_EQUAL(metadata.size, 2880);
+  BOOST_CHECK_EQUAL(metadata.version, "2020-10-06.10:00");
+  BOOST_CHECK(not DataSync::irodsMetadataFromListing("").known);
+}
+
 // @TODO test IrodsSynchronizer
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsServices/DataSync/DataSynchronizer.h"
+#include "ElementsServices/DataSync/LazyDownloader.h"
+
+#include "fixtures/ConfigFilesFixture.h"
+#include "fixtures/LocalDataSynchronizer.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::LazyDownloader;
+using DataSync::path;
+
+namespace {
+
+struct LazyFixture : public LocalDataSynchronizer {
+
+  /// a downloader which uses the fixture as synchronizer, without owning it
+  std::unique_ptr<LazyDownloader> createDownloader(std::size_t prefetcherCount) const {
+    const std::shared_ptr<const DataSync::DataSynchronizer> self(std::shared_ptr<void>(), this);
+    std::vector<path>                                       localFiles;
+    for (const auto& file : theLocalFiles()) {
+      localFiles.push_back(localRoot() / file);
+    }
+    return std::unique_ptr<LazyDownloader>(new LazyDownloader(self, localFiles, prefetcherCount));
+  }
+};
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_SUITE(LazyDownloader_test, LazyFixture)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(onlyRequiredFilesAreDownloaded_test) {
+  const auto downloader = createDownloader(0);
+  downloader->require(localRoot() / "file2.txt");
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file2.txt"), "file2-V1.txt");
+  BOOST_CHECK(not boost::filesystem::exists(localRoot() / "file1.txt"));
+  // each file is downloaded once, and the other files are ignored
+  downloader->require(localRoot() / "file2.txt");
+  downloader->require(localRoot() / "unknown.txt");
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(remainingFilesArePrefetched_test) {
+  const auto downloader = createDownloader(2);
+  downloader->require(localRoot() / "file5.txt");
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file5.txt"), "dir/file5-V2.txt");
+  downloader->requireAll();
+  const auto distantFiles = theDistantFiles();
+  const auto localFiles   = theLocalFiles();
+  for (std::size_t i = 0; i < localFiles.size(); ++i) {
+    BOOST_CHECK_EQUAL(contentOf(localRoot() / localFiles[i]), distantFiles[i].string());
+  }
+  BOOST_CHECK_EQUAL(m_downloadCount.load(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(failuresAreReported_test) {
+  boost::filesystem::remove(distantRoot() / "file1.txt");
+  const auto downloader = createDownloader(1);
+  BOOST_CHECK_THROW(downloader->require(localRoot() / "file1.txt"), DataSync::DownloadFailed);
+  try {
+    downloader->requireAll();
+    BOOST_FAIL("DownloadFailed not thrown");
+  } catch (const DataSync::DownloadFailed& e) {
+    BOOST_CHECK(DataSync::containsInThisOrder(e.what(), {"1 file(s)", "file1.txt"}));
+  }
+  BOOST_CHECK_EQUAL(contentOf(localRoot() / "file2.txt"), "file2-V1.txt");
+}
+
+BOOST_AUTO_TEST_CASE(prefetchingStopsWithTheDownloader_test) {
+  createDownloader(4).reset();
+  BOOST_CHECK_LE(m_downloadCount.load(), 5);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
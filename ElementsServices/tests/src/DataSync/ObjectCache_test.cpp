@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <sys/stat.h>  // for stat
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Temporary.h"
+
+#include "ElementsServices/DataSync/ObjectCache.h"
+
+#include "fixtures/FileContent.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::CacheLink;
+using DataSync::ObjectCache;
+using DataSync::path;
+using std::string;
+
+namespace {
+
+DataSync::RemoteMetadata metadataOf(const string& version) {
+  DataSync::RemoteMetadata metadata;
+  metadata.known   = true;
+  metadata.size    = 10;
+  metadata.version = version;
+  return metadata;
+}
+
+}  // namespace
+
+struct ObjectCacheFixture {
+  Elements::TempDir m_dir{"ObjectCache_test-%%%%%%%"};
+  path              m_root = m_dir.path() / "cache";
+  std::atomic<int>  m_fetchCount{0};
+
+  ObjectCache::Fetch fetcher(const string& content) {
+    return [this, content](path object) {
+      ++m_fetchCount;
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      writeFile(object, content);
+    };
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_SUITE(ObjectCache_test, ObjectCacheFixture)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(objectKey_test) {
+  const auto key = ObjectCache::objectKey("host", "dir/file.fits", metadataOf("v1"));
+  BOOST_CHECK_EQUAL(key.size(), 32);
+  BOOST_CHECK_EQUAL(key, ObjectCache::objectKey("host", "dir/file.fits", metadataOf("v1")));
+  BOOST_CHECK_NE(key, ObjectCache::objectKey("host", "dir/file.fits", metadataOf("v2")));
+  BOOST_CHECK_NE(key, ObjectCache::objectKey("other", "dir/file.fits", metadataOf("v1")));
+}
+
+BOOST_AUTO_TEST_CASE(fetchedOnce_test) {
+  ObjectCache cache(m_root);
+  const auto  key    = ObjectCache::objectKey("host", "file.fits", metadataOf("v1"));
+  const path  first  = m_dir.path() / "workspace1" / "file.fits";
+  const path  second = m_dir.path() / "workspace2" / "dir" / "file.fits";
+  BOOST_CHECK(cache.provide(key, first, fetcher("content")) == CacheLink::HARDLINK);
+  BOOST_CHECK(cache.provide(key, second, fetcher("content")) == CacheLink::HARDLINK);
+  BOOST_CHECK_EQUAL(m_fetchCount.load(), 1);
+  BOOST_CHECK_EQUAL(contentOf(second), "content");
+  BOOST_CHECK(boost::filesystem::equivalent(first, cache.objectPath(key)));
+  BOOST_CHECK_EQUAL(cache.usage(), 7);
+  // the object cannot be modified through the links
+  struct stat status;
+  BOOST_REQUIRE_EQUAL(::stat(first.c_str(), &status), 0);
+  BOOST_CHECK_EQUAL(status.st_mode & 0222, 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrentProvide_test) {
+  ObjectCache              cache(m_root);
+  const auto               key = ObjectCache::objectKey("host", "file.fits", metadataOf("v1"));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    const path local = m_dir.path() / ("workspace" + std::to_string(i)) / "file.fits";
+    threads.emplace_back([this, &cache, &key, local]() {
+      cache.provide(key, local, fetcher("content"));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(m_fetchCount.load(), 1);
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK_EQUAL(contentOf(m_dir.path() / ("workspace" + std::to_string(i)) / "file.fits"), "content");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(failedFetch_test) {
+  ObjectCache cache(m_root);
+  const auto  key = ObjectCache::objectKey("host", "file.fits", metadataOf("v1"));
+  BOOST_CHECK_THROW(cache.provide(key, m_dir.path() / "file.fits",
+                                  [](path object) {
+                                    writeFile(object, "partial");
+                                    throw std::runtime_error("failure");
+                                  }),
+                    std::runtime_error);
+  BOOST_CHECK(not boost::filesystem::exists(cache.objectPath(key)));
+  BOOST_CHECK_EQUAL(cache.usage(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(leastRecentlyUsedEviction_test) {
+  ObjectCache       cache(m_root, 25);
+  const string      content(10, 'x');
+  const std::string oldest = ObjectCache::objectKey("host", "file.fits", metadataOf("v1"));
+  const std::string middle = ObjectCache::objectKey("host", "file.fits", metadataOf("v2"));
+  const std::string newest = ObjectCache::objectKey("host", "file.fits", metadataOf("v3"));
+  const path        local  = m_dir.path() / "file.fits";
+  cache.provide(oldest, local, fetcher(content));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  cache.provide(middle, local, fetcher(content));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  cache.provide(newest, local, fetcher(content));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  // a new use of the oldest object
+  cache.provide(oldest, local, fetcher(content));
+  BOOST_CHECK_EQUAL(cache.usage(), 30);
+  BOOST_CHECK_EQUAL(cache.evict(), 1);
+  BOOST_CHECK_EQUAL(cache.usage(), 20);
+  BOOST_CHECK(boost::filesystem::exists(cache.objectPath(oldest)));
+  BOOST_CHECK(not boost::filesystem::exists(cache.objectPath(middle)));
+  BOOST_CHECK(boost::filesystem::exists(cache.objectPath(newest)));
+  // the hard link survives the eviction
+  BOOST_CHECK_EQUAL(contentOf(local), content);
+}
+
+BOOST_AUTO_TEST_CASE(evictedObjectIsFetchedAgain_test) {
+  ObjectCache cache(m_root, 1);
+  const auto  key   = ObjectCache::objectKey("host", "file.fits", metadataOf("v1"));
+  const path  local = m_dir.path() / "file.fits";
+  cache.provide(key, local, fetcher("content"));
+  BOOST_CHECK_EQUAL(cache.evict(), 1);
+  BOOST_CHECK(not boost::filesystem::exists(m_root / "locks" / (key + ".lock")));
+  cache.provide(key, local, fetcher("content"));
+  BOOST_CHECK_EQUAL(m_fetchCount.load(), 2);
+  BOOST_CHECK_EQUAL(contentOf(local), "content");
+  BOOST_CHECK(boost::filesystem::exists(m_root / "locks" / (key + ".lock")));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <fcntl.h>     // for O_RDWR
+#include <sys/mman.h>  // for shm_open, shm_unlink, mmap
+#include <unistd.h>    // for getpid, close
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsServices/DataSync/RateLimiter.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::RateLimiter;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(RateLimiter_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(unlimited_test) {
+  RateLimiter limiter(0);
+  const auto  start = Clock::now();
+  limiter.acquire(std::uint64_t(1) << 40);
+  BOOST_CHECK_LT(secondsSince(start), 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(burstIsImmediate_test) {
+  RateLimiter limiter(1024);
+  const auto  start = Clock::now();
+  limiter.acquire(64 * 1024);
+  BOOST_CHECK_LT(secondsSince(start), 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(rateIsSharedByThreads_test) {
+  // 1 MB of burst, then 1 MB at 4 MB/s
+  RateLimiter              limiter(4 * 1024 * 1024);
+  const auto               start = Clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&limiter]() {
+      for (int i = 0; i < 32; ++i) {
+        limiter.acquire(16 * 1024);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double elapsed = secondsSince(start);
+  BOOST_CHECK_GE(elapsed, 0.2);
+  BOOST_CHECK_LT(elapsed, 2.);
+}
+
+BOOST_AUTO_TEST_CASE(processWide_test) {
+  const auto limiter = RateLimiter::processWide(1000);
+  BOOST_CHECK_EQUAL(limiter, RateLimiter::processWide(1000));
+  BOOST_CHECK_NE(limiter, RateLimiter::processWide(2000));
+  BOOST_CHECK_EQUAL(limiter->bytesPerSecond(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(nodeWide_test) {
+  const std::string name = "/elements-datasync-test-" + std::to_string(::getpid());
+  {
+    RateLimiter first(1024 * 1024, name);
+    RateLimiter second(1024 * 1024, name);
+    // the burst of 256 kB is consumed by the first user: the second one waits for the rate
+    first.acquire(256 * 1024);
+    const auto start = Clock::now();
+    second.acquire(128 * 1024);
+    BOOST_CHECK_GE(secondsSince(start), 0.08);
+  }
+  ::shm_unlink(name.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(corruptedSchedule_test) {
+  const std::string name = "/elements-datasync-test-" + std::to_string(::getpid());
+  {
+    RateLimiter limiter(1024 * 1024, name);
+    // a schedule one day ahead, as written by a faulty process
+    const int descriptor = ::shm_open(name.c_str(), O_RDWR, 0);
+    BOOST_REQUIRE_GE(descriptor, 0);
+    void* mapping = ::mmap(nullptr, sizeof(std::int64_t), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    BOOST_REQUIRE(mapping != MAP_FAILED);
+    auto* schedule = static_cast<std::atomic<std::int64_t>*>(mapping);
+    const auto tomorrow = Clock::now().time_since_epoch() + std::chrono::hours(24);
+    schedule->store(std::chrono::duration_cast<std::chrono::nanoseconds>(tomorrow).count());
+    ::munmap(mapping, sizeof(std::int64_t));
+    // the wait is bounded by a few bursts of 1/4 s
+    const auto start = Clock::now();
+    limiter.acquire(1024);
+    BOOST_CHECK_LT(secondsSince(start), 1.5);
+  }
+  ::shm_unlink(name.c_str());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
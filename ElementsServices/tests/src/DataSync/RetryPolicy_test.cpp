@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsServices/DataSync/RetryPolicy.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::CircuitBreaker;
+using DataSync::RetryPolicy;
+using std::chrono::milliseconds;
+
+namespace {
+
+struct Transient : public std::runtime_error {
+  Transient() : std::runtime_error("transient") {}
+};
+
+bool isTransient(const std::exception& error) {
+  return dynamic_cast<const Transient*>(&error) != nullptr;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(RetryPolicy_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(exponentialBackoff_test) {
+  const RetryPolicy policy(10, milliseconds(100), milliseconds(1000));
+  BOOST_CHECK_EQUAL(policy.maxDelayBefore(1).count(), 100);
+  BOOST_CHECK_EQUAL(policy.maxDelayBefore(2).count(), 200);
+  BOOST_CHECK_EQUAL(policy.maxDelayBefore(4).count(), 800);
+  BOOST_CHECK_EQUAL(policy.maxDelayBefore(5).count(), 1000);
+  BOOST_CHECK_EQUAL(policy.maxDelayBefore(100).count(), 1000);
+  bool varies = false;
+  for (int i = 0; i < 100; ++i) {
+    const auto delay = policy.delayBefore(3);
+    BOOST_CHECK_GE(delay.count(), 0);
+    BOOST_CHECK_LE(delay.count(), 400);
+    varies = varies or delay != policy.delayBefore(3);
+  }
+  BOOST_CHECK(varies);
+}
+
+BOOST_AUTO_TEST_CASE(transientErrorsAreRetried_test) {
+  const RetryPolicy policy(4, milliseconds(1), milliseconds(2));
+  int               attempts = 0;
+  policy.run(
+      [&attempts]() {
+        if (++attempts < 3) {
+          throw Transient();
+        }
+      },
+      isTransient);
+  BOOST_CHECK_EQUAL(attempts, 3);
+  attempts = 0;
+  BOOST_CHECK_THROW(policy.run(
+                        [&attempts]() {
+                          ++attempts;
+                          throw Transient();
+                        },
+                        isTransient),
+                    Transient);
+  BOOST_CHECK_EQUAL(attempts, 4);
+}
+
+BOOST_AUTO_TEST_CASE(fatalErrorsAreNotRetried_test) {
+  const RetryPolicy policy(4, milliseconds(1), milliseconds(2));
+  int               attempts = 0;
+  BOOST_CHECK_THROW(policy.run(
+                        [&attempts]() {
+                          ++attempts;
+                          throw std::logic_error("fatal");
+                        },
+                        isTransient),
+                    std::logic_error);
+  BOOST_CHECK_EQUAL(attempts, 1);
+}
+
+BOOST_AUTO_TEST_CASE(circuitBreaker_test) {
+  CircuitBreaker breaker(2, milliseconds(50));
+  BOOST_CHECK(breaker.allows());
+  breaker.recordFailure();
+  breaker.recordSuccess();
+  breaker.recordFailure();
+  BOOST_CHECK(not breaker.isOpen());
+  breaker.recordFailure();
+  BOOST_CHECK(breaker.isOpen());
+  BOOST_CHECK(not breaker.allows());
+  // a single trial after the cooldown
+  std::this_thread::sleep_for(milliseconds(60));
+  BOOST_CHECK(breaker.allows());
+  BOOST_CHECK(not breaker.allows());
+  breaker.recordFailure();
+  BOOST_CHECK(not breaker.allows());
+  std::this_thread::sleep_for(milliseconds(60));
+  BOOST_CHECK(breaker.allows());
+  breaker.recordSuccess();
+  BOOST_CHECK(not breaker.isOpen());
+  BOOST_CHECK(breaker.allows());
+}
+
+BOOST_AUTO_TEST_CASE(disabledCircuitBreaker_test) {
+  CircuitBreaker breaker(0, milliseconds(50));
+  for (int i = 0; i < 10; ++i) {
+    breaker.recordFailure();
+  }
+  BOOST_CHECK(breaker.allows());
+}
+
+BOOST_AUTO_TEST_CASE(openCircuitStopsTheRetries_test) {
+  const RetryPolicy policy(10, milliseconds(1), milliseconds(2));
+  CircuitBreaker    breaker(3, std::chrono::seconds(60));
+  int               attempts = 0;
+  const auto        failing  = [&attempts]() {
+    ++attempts;
+    throw Transient();
+  };
+  BOOST_CHECK_THROW(policy.run(failing, isTransient, &breaker), Transient);
+  BOOST_CHECK_EQUAL(attempts, 3);
+  BOOST_CHECK_THROW(policy.run(failing, isTransient, &breaker), DataSync::CircuitOpen);
+  BOOST_CHECK_EQUAL(attempts, 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
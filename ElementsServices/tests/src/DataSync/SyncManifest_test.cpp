@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Temporary.h"
+
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+#include "fixtures/FileContent.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::path;
+using DataSync::RemoteMetadata;
+using DataSync::SyncManifest;
+using std::string;
+
+namespace {
+
+RemoteMetadata metadataOf(const string& content, const string& version) {
+  RemoteMetadata metadata;
+  metadata.known   = true;
+  metadata.size    = content.size();
+  metadata.version = version;
+  return metadata;
+}
+
+}  // namespace
+
+struct SyncManifestFixture {
+  Elements::TempDir m_dir{"SyncManifest_test-%%%%%%%"};
+  path              m_manifest = m_dir.path() / ".datasync-manifest";
+  path              m_local    = m_dir.path() / "local.txt";
+  path              m_distant  = "distant/file.txt";
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_SUITE(SyncManifest_test, SyncManifestFixture)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(contentHash_test) {
+  const path other = m_dir.path() / "other.txt";
+  writeFile(m_local, "some content which is longer than a word");
+  writeFile(other, "some content which is longer than a word");
+  BOOST_CHECK_EQUAL(DataSync::contentHash(m_local), DataSync::contentHash(other));
+  writeFile(other, "some content which is longer than a word!");
+  BOOST_CHECK_NE(DataSync::contentHash(m_local), DataSync::contentHash(other));
+  // the trailing zeros are not ignored
+  writeFile(m_local, "a");
+  writeFile(other, string("a\0", 2));
+  BOOST_CHECK_NE(DataSync::contentHash(m_local), DataSync::contentHash(other));
+}
+
+BOOST_AUTO_TEST_CASE(upToDate_test) {
+  writeFile(m_local, "content");
+  const auto   remote = metadataOf("content", "v1");
+  SyncManifest manifest(m_manifest);
+  BOOST_CHECK(not manifest.isUpToDate(m_distant, m_local, remote));
+  manifest.record(m_distant, m_local, remote);
+  BOOST_CHECK(manifest.isUpToDate(m_distant, m_local, remote));
+  BOOST_CHECK(manifest.verify(m_local));
+  BOOST_CHECK(not manifest.isUpToDate(m_distant, m_local, metadataOf("content", "v2")));
+  BOOST_CHECK(not manifest.isUpToDate(m_distant, m_local, RemoteMetadata()));
+  BOOST_CHECK(not manifest.isUpToDate("distant/other.txt", m_local, remote));
+}
+
+BOOST_AUTO_TEST_CASE(localModification_test) {
+  writeFile(m_local, "content");
+  const auto   remote = metadataOf("content", "v1");
+  SyncManifest manifest(m_manifest);
+  manifest.record(m_distant, m_local, remote);
+  writeFile(m_local, "CONTENT");
+  BOOST_CHECK(not manifest.verify(m_local));
+  boost::filesystem::resize_file(m_local, 3);
+  BOOST_CHECK(not manifest.isUpToDate(m_distant, m_local, remote));
+}
+
+BOOST_AUTO_TEST_CASE(verification_test) {
+  writeFile(m_local, "truncated");
+  SyncManifest manifest(m_manifest);
+  BOOST_CHECK_THROW(manifest.record(m_distant, m_local, metadataOf("not truncated", "v1")),
+                    DataSync::ManifestMismatch);
+  writeFile(m_local, "content");
+  manifest.record(m_distant, m_local, metadataOf("content", "v1"));
+  // same version and size, but another content
+  writeFile(m_local, "CONTENT");
+  BOOST_CHECK_THROW(manifest.record(m_distant, m_local, metadataOf("content", "v1")), DataSync::ManifestMismatch);
+  BOOST_CHECK_EQUAL(manifest.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(decompressedFile_test) {
+  // the host reports the size of the compressed file
+  writeFile(m_local, "decompressed content");
+  const auto   remote = metadataOf("gzip", "v1");
+  SyncManifest manifest(m_manifest);
+  BOOST_CHECK_THROW(manifest.record(m_distant, m_local, remote), DataSync::ManifestMismatch);
+  manifest.record(m_distant, m_local, remote, DataSync::Compression::GZIP);
+  BOOST_CHECK(manifest.isUpToDate(m_distant, m_local, remote));
+  boost::filesystem::resize_file(m_local, 4);
+  BOOST_CHECK(not manifest.isUpToDate(m_distant, m_local, remote));
+}
+
+BOOST_AUTO_TEST_CASE(saveAndLoad_test) {
+  writeFile(m_local, "content");
+  const auto remote = metadataOf("content", "\"etag\"");
+  {
+    SyncManifest manifest(m_manifest);
+    manifest.record(m_distant, m_local, remote);
+    manifest.save();
+  }
+  BOOST_CHECK(boost::filesystem::is_regular_file(m_manifest));
+  SyncManifest manifest(m_manifest);
+  BOOST_CHECK_EQUAL(manifest.size(), 1);
+  BOOST_CHECK(manifest.isUpToDate(m_distant, m_local, remote));
+  BOOST_CHECK(manifest.verify(m_local));
+}
+
+BOOST_AUTO_TEST_CASE(corruptedManifest_test) {
+  writeFile(m_manifest, "# elements-datasync manifest 2\nlocal\tdistant\tnot a size\t0\tv1\t0\t0\n");
+  SyncManifest manifest(m_manifest);
+  BOOST_CHECK_EQUAL(manifest.size(), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2012-2020 Euclid Science Ground Segment
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Temporary.h"
+#include "ElementsServices/DataSync/TransferMetrics.h"
+
+#include "fixtures/FileContent.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::TransferMetrics;
+using std::string;
+
+namespace {
+
+bool contains(const string& text, const string& chunk) {
+  return text.find(chunk) != string::npos;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(TransferMetrics_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fileMetrics_test) {
+  TransferMetrics metrics("host", std::chrono::milliseconds(0));
+  metrics.begin();
+  metrics.submit(3);
+  const auto file = metrics.startFile("distant/a", "local/a");
+  metrics.recordTry(file);
+  metrics.recordTry(file);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  metrics.recordBytes(file, 1000);
+  metrics.recordBytes(file, 500);
+  metrics.finishFile(file, true, 0);
+  const auto files = metrics.files();
+  BOOST_REQUIRE_EQUAL(files.size(), 1);
+  BOOST_CHECK_EQUAL(files[0].bytes, 1500);
+  BOOST_CHECK_EQUAL(files[0].tries, 2);
+  BOOST_CHECK(files[0].succeeded);
+  BOOST_CHECK_GE(files[0].firstByteSeconds, 0.02);
+  BOOST_CHECK_GE(files[0].seconds, files[0].firstByteSeconds);
+  BOOST_CHECK_GT(files[0].throughput(), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(sizeIsUsedWithoutBytes_test) {
+  TransferMetrics metrics("host");
+  const auto      file = metrics.startFile("distant/a", "local/a");
+  metrics.finishFile(file, true, 42);
+  const auto files = metrics.files();
+  BOOST_CHECK_EQUAL(files[0].bytes, 42);
+  BOOST_CHECK_LT(files[0].firstByteSeconds, 0.);
+  BOOST_CHECK_EQUAL(files[0].tries, 0);
+}
+
+BOOST_AUTO_TEST_CASE(skippedFile_test) {
+  TransferMetrics metrics("host");
+  const auto      file = metrics.startFile("distant/a", "local/a");
+  metrics.skipFile(file);
+  const auto files = metrics.files();
+  BOOST_CHECK_EQUAL(files[0].bytes, 0);
+  BOOST_CHECK(files[0].succeeded);
+  BOOST_CHECK(files[0].skipped);
+  const auto summary = metrics.summary();
+  BOOST_CHECK_EQUAL(summary.succeeded, 1);
+  BOOST_CHECK_EQUAL(summary.skipped, 1);
+  BOOST_CHECK_EQUAL(summary.bytes, 0);
+  BOOST_CHECK(contains(metrics.jsonSummary(), "\"skipped\": true"));
+}
+
+BOOST_AUTO_TEST_CASE(summary_test) {
+  TransferMetrics metrics("host");
+  metrics.submit(5);
+  const auto done = metrics.startFile("distant/a", "local/a");
+  metrics.recordTry(done);
+  metrics.recordTry(done);
+  metrics.recordTry(done);
+  metrics.recordBytes(done, 100);
+  metrics.finishFile(done, true, 100);
+  const auto failed = metrics.startFile("distant/b", "local/b");
+  metrics.finishFile(failed, false, 0);
+  metrics.startFile("distant/c", "local/c");
+  const auto summary = metrics.summary();
+  BOOST_CHECK_EQUAL(summary.succeeded, 1);
+  BOOST_CHECK_EQUAL(summary.failed, 1);
+  BOOST_CHECK_EQUAL(summary.active, 1);
+  BOOST_CHECK_EQUAL(summary.queued(), 2);
+  BOOST_CHECK_EQUAL(summary.bytes, 100);
+  BOOST_CHECK_EQUAL(summary.retries, 2);
+  BOOST_CHECK(contains(metrics.progressMessage(), "1 done, 1 active, 2 queued, 1 failed"));
+  metrics.begin();
+  BOOST_CHECK_EQUAL(metrics.summary().submitted, 0);
+  BOOST_CHECK(metrics.files().empty());
+}
+
+BOOST_AUTO_TEST_CASE(jsonSummary_test) {
+  TransferMetrics metrics("https://host");
+  const auto      file = metrics.startFile("distant/\"quoted\".fits", "local/a.fits");
+  metrics.recordBytes(file, 2880);
+  metrics.finishFile(file, true, 2880);
+  DataSync::FileMetrics batched;
+  batched.distantFile = "distant/b.fits";
+  batched.localFile   = "local/b.fits";
+  batched.bytes       = 10;
+  batched.succeeded   = true;
+  metrics.recordFile(batched);
+  const string json = metrics.jsonSummary();
+  BOOST_CHECK(contains(json, "\"host\": \"https://host\""));
+  BOOST_CHECK(contains(json, "\"files\": 2"));
+  BOOST_CHECK(contains(json, "\"bytes\": 2890"));
+  BOOST_CHECK(contains(json, "\"distant\": \"distant/\\\"quoted\\\".fits\""));
+  BOOST_CHECK(contains(json, "\"first_byte\": null"));
+  BOOST_CHECK(contains(json, "\"succeeded\": true"));
+  BOOST_CHECK(contains(json, "\"skipped\": 0"));
+  BOOST_CHECK(contains(json, "\"skipped\": false"));
+
+  Elements::TempDir dir;
+  const auto        file_path = dir.path() / "report" / "metrics.json";
+  metrics.writeSummary(file_path);
+  const string written = contentOf(file_path);
+  // the duration of the synchronization changed meanwhile
+  BOOST_CHECK(contains(written, "\"transfers\": [\n    {\"distant\""));
+  BOOST_CHECK_EQUAL(written.substr(written.find("\"transfers\"")), json.substr(json.find("\"transfers\"")));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -19,17 +19,21 @@
 #include <string>
 #include <vector>
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "ElementsServices/DataSync/DataSyncUtils.h"
 #include "ElementsServices/DataSync/WebdavSynchronizer.h"
 
 #include "fixtures/ConfigFilesFixture.h"
+#include "fixtures/FileContent.h"
 
 using std::string;
 
 namespace DataSync = ElementsServices::DataSync;
 
+using DataSync::path;
+
 //-----------------------------------------------------------------------------
 
 BOOST_FIXTURE_TEST_SUITE(WebdavSynchronizer_test, WorkspaceFixture)
@@ -49,8 +53,42 @@ BOOST_AUTO_TEST_CASE(webdavGetCmd_test) {
   string              local_file   = "dst/local_file.fits";
   auto                synchronizer = createTestSynchronizer();
   string              cmd          = synchronizer.createDownloadCommand(distant_file, local_file);
-  std::vector<string> chunks       = {"wget ", "-O", local_file, distant_file, "8"};
+  std::vector<string> chunks       = {"wget ", "-O", local_file, distant_file, "--tries 1"};
   BOOST_CHECK(DataSync::containsInThisOrder(cmd, chunks));
+  // the 8 configured tries are handled by the synchronizer
+  BOOST_CHECK_EQUAL(DataSync::ConnectionConfiguration(theWebdavFrConfig()).tries, 8);
+}
+
+BOOST_AUTO_TEST_CASE(passwordIsNotInTheCommand_test) {
+  const string password     = DataSync::ConnectionConfiguration(theWebdavFrConfig()).password;
+  auto         synchronizer = createTestSynchronizer();
+  BOOST_CHECK_EQUAL(synchronizer.createDownloadCommand("distant.fits", "local.fits").find(password), string::npos);
+  BOOST_CHECK_EQUAL(synchronizer.createStreamingDownloadCommand("distant.fits").find(password), string::npos);
+  // the credentials are read by wget from its private configuration file
+  const string cmd    = synchronizer.createDownloadCommand("distant.fits", "local.fits");
+  const auto   begin  = cmd.find("WGETRC=") + 7;
+  const path   wgetrc = cmd.substr(begin, cmd.find(' ', begin) - begin);
+  BOOST_CHECK(DataSync::containsInThisOrder(contentOf(wgetrc), {"user = ", "password = " + password}));
+  BOOST_CHECK_EQUAL(boost::filesystem::status(wgetrc).permissions(),
+                    boost::filesystem::owner_read | boost::filesystem::owner_write);
+}
+
+BOOST_AUTO_TEST_CASE(webdavMetadataFromHeaders_test) {
+  const string headers = "Spider mode enabled. Check if remote file exists.\n"
+                         "  HTTP/1.1 302 Found\n"
+                         "  Location: https://other.host/file.fits\n"
+                         "  Content-Length: 0\n"
+                         "  HTTP/1.1 200 OK\n"
+                         "  Content-Length: 2880\r\n"
+                         "  Last-Modified: Mon, 05 Oct 2020 10:00:00 GMT\n"
+                         "  ETag: \"5f7aeef0-b40\"\n"
+                         "Length: 2880 (2.8K) [application/fits]\n";
+  const auto   metadata = DataSync::webdavMetadataFromHeaders(headers);
+  BOOST_CHECK(metadata.known);
+  BOOST_CHECK_EQUAL(metadata.size, 2880);
+  BOOST_CHECK_EQUAL(metadata.version, "\"5f7aeef0-b40\"");
+  const auto notFound = DataSync::webdavMetadataFromHeaders("  HTTP/1.1 404 Not Found\n  Content-Length: 10\n");
+  BOOST_CHECK(not notFound.known);
 }
 
 //-----------------------------------------------------------------------------
@@ -26,6 +26,10 @@ path theDependencyConfig() {
   return path("ElementsServices/testdata/test_file_list.txt");
 }
 
+path theCompressedDependencyConfig() {
+  return path("ElementsServices/testdata/test_compressed_file_list.txt");
+}
+
 std::vector<path> theLocalFiles() {
   return std::vector<path>(
       {path("file1.txt"), path("file2.txt"), path("dir/file3.txt"), path("dir/file4.txt"), path("file5.txt")});
@@ -70,3 +74,28 @@ path theNoOverwriteConfig() {
 path aBadConnectionConfig() {
   return path("ElementsServices/testdata/sync_wrong.conf");
 }
+
+path theLocalParallelConfig() {
+  return path("ElementsServices/testdata/sync_local_parallel.conf");
+}
+
+path theLocalIncrementalConfig() {
+  return path("ElementsServices/testdata/sync_local_incremental.conf");
+}
+
+path theLocalCacheConfig() {
+  return path("ElementsServices/testdata/sync_local_cache.conf");
+}
+
+path theLocalHttpConfig() {
+  return path("ElementsServices/testdata/sync_local_http.conf");
+}
+
+path theLocalIrodsConfig() {
+  return path("ElementsServices/testdata/sync_local_irods.conf");
+}
+
+std::vector<path> theDistantFiles() {
+  return std::vector<path>({path("file1.txt"), path("file2-V1.txt"), path("file3.txt"), path("dir/file4.txt"),
+                            path("dir/file5-V2.txt")});
+}
@@ -27,6 +27,8 @@ struct WorkspaceFixture {
 
 ElementsServices::DataSync::path theDependencyConfig();
 
+ElementsServices::DataSync::path theCompressedDependencyConfig();
+
 std::vector<ElementsServices::DataSync::path> theLocalFiles();
 
 ElementsServices::DataSync::path theLocalWorkspace();
@@ -49,4 +51,16 @@ ElementsServices::DataSync::path theNoOverwriteConfig();
 
 ElementsServices::DataSync::path aBadConnectionConfig();
 
+ElementsServices::DataSync::path theLocalParallelConfig();
+
+ElementsServices::DataSync::path theLocalIncrementalConfig();
+
+ElementsServices::DataSync::path theLocalCacheConfig();
+
+ElementsServices::DataSync::path theLocalHttpConfig();
+
+ElementsServices::DataSync::path theLocalIrodsConfig();
+
+std::vector<ElementsServices::DataSync::path> theDistantFiles();
+
 #endif  // ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_CONFIGFILESFIXTURE_H_
@@ -0,0 +1,24 @@
+/**
+ * @file FileContent.cpp
+ *
+ * @copyright 2019
+ *
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "FileContent.h"
+
+using ElementsServices::DataSync::path;
+using std::string;
+
+string contentOf(path file) {
+  std::ifstream stream(file.c_str());
+  return string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void writeFile(path file, const string& content) {
+  std::ofstream(file.c_str()) << content;
+}
@@ -0,0 +1,21 @@
+/**
+ * @file FileContent.h
+ *
+ * @copyright 2019
+ *
+ */
+
+#ifndef ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_FILECONTENT_H_
+#define ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_FILECONTENT_H_
+
+#include <string>
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+/** The whole content of a file, empty if it cannot be read */
+std::string contentOf(ElementsServices::DataSync::path file);
+
+/** Replace the content of a file, whose directory must exist */
+void writeFile(ElementsServices::DataSync::path file, const std::string& content);
+
+#endif  // ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_FILECONTENT_H_
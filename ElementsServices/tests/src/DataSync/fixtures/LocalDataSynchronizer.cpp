@@ -0,0 +1,70 @@
+/**
+ * @file LocalDataSynchronizer.cpp
+ *
+ * @copyright 2019
+ *
+ */
+
+#include <string>
+
+#include "ElementsServices/DataSync/DataSynchronizer.h"
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+#include "LocalDataSynchronizer.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::path;
+using std::string;
+
+namespace {
+
+path localDistantRoot(const WorkspaceFixture& fixture) {
+  return fixture.m_top_dir.path() / "distant";
+}
+
+DataSync::DependencyConfiguration localDependencies(const WorkspaceFixture& fixture, path connection,
+                                                    path dependency) {
+  const DataSync::ConnectionConfiguration config(connection);
+  return DataSync::DependencyConfiguration(localDistantRoot(fixture), config.localRoot, dependency);
+}
+
+}  // namespace
+
+LocalDataSynchronizer::LocalDataSynchronizer(path connection, path dependency)
+    : WorkspaceFixture()
+    , DataSync::DataSynchronizer(DataSync::ConnectionConfiguration(connection),
+                                 localDependencies(*this, connection, dependency)) {
+  for (const auto& file : theDistantFiles()) {
+    const path distantFile = distantRoot() / file;
+    DataSync::createLocalDirOf(distantFile);
+    writeFile(distantFile, file.string());
+  }
+}
+
+string LocalDataSynchronizer::createDownloadCommand(path distantFile, path localFile) const {
+  ++m_downloadCount;
+  return "cp " + distantFile.string() + " " + localFile.string();
+}
+
+DataSync::RemoteMetadata LocalDataSynchronizer::remoteMetadata(path distantFile) const {
+  DataSync::RemoteMetadata metadata;
+  if (boost::filesystem::is_regular_file(distantFile)) {
+    metadata.known   = true;
+    metadata.size    = boost::filesystem::file_size(distantFile);
+    metadata.version = std::to_string(DataSync::localModificationTime(distantFile));
+  }
+  return metadata;
+}
+
+bool LocalDataSynchronizer::failureIsRetryable(const DataSync::CommandResult& result) const {
+  return not DataSync::containsInThisOrder(result.err, {"No such file"});
+}
+
+path LocalDataSynchronizer::distantRoot() const {
+  return localDistantRoot(*this);
+}
+
+path LocalDataSynchronizer::localRoot() const {
+  return m_connection.localRoot;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file LocalDataSynchronizer.h
+ *
+ * @copyright 2019
+ *
+ */
+
+#ifndef ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_LOCALDATASYNCHRONIZER_H_
+#define ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_LOCALDATASYNCHRONIZER_H_
+
+#include <atomic>
+#include <string>
+
+#include "ElementsServices/DataSync/DataSynchronizer.h"
+
+#include "ConfigFilesFixture.h"
+#include "FileContent.h"
+
+/**
+ * @brief A synchronizer which copies the files from a local directory standing for the host.
+ * @details
+ * The distant files are created in the temporary workspace with their relative path as content.
+ */
+struct LocalDataSynchronizer : public WorkspaceFixture, public ElementsServices::DataSync::DataSynchronizer {
+
+  virtual ~LocalDataSynchronizer() = default;
+
+  explicit LocalDataSynchronizer(ElementsServices::DataSync::path connection = theLocalParallelConfig(),
+                                 ElementsServices::DataSync::path dependency = theDependencyConfig());
+
+  std::string createDownloadCommand(ElementsServices::DataSync::path distantFile,
+                                    ElementsServices::DataSync::path localFile) const override;
+
+  ElementsServices::DataSync::RemoteMetadata
+  remoteMetadata(ElementsServices::DataSync::path distantFile) const override;
+
+  /** The missing distant files are not retried */
+  bool failureIsRetryable(const ElementsServices::DataSync::CommandResult& result) const override;
+
+  ElementsServices::DataSync::path distantRoot() const;
+
+  ElementsServices::DataSync::path localRoot() const;
+
+  /** The number of download commands created so far */
+  mutable std::atomic<int> m_downloadCount{0};
+};
+
+#endif  // ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_LOCALDATASYNCHRONIZER_H_
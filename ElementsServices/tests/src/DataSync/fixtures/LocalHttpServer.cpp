@@ -0,0 +1,160 @@
+/**
+ * @file LocalHttpServer.cpp
+ *
+ * @copyright 2019
+ *
+ */
+
+#include "LocalHttpServer.h"
+
+#if BOOST_VERSION >= 107000
+
+#include <cstdio>
+#include <string>
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "ElementsServices/DataSync/SyncManifest.h"
+
+#include "FileContent.h"
+
+namespace DataSync = ElementsServices::DataSync;
+namespace http     = boost::beast::http;
+
+using boost::asio::ip::tcp;
+using DataSync::path;
+
+LocalHttpServer::LocalHttpServer(path root, std::string authorization)
+    : m_root(root)
+    , m_authorization(authorization)
+    , m_context()
+    , m_acceptor(m_context, tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0))
+    , m_stopping(false)
+    , m_connections(0)
+    , m_requests(0) {
+  m_acceptor_thread = std::thread([this]() {
+    accept();
+  });
+}
+
+LocalHttpServer::~LocalHttpServer() {
+  m_stopping = true;
+  // wake up the acceptor
+  boost::system::error_code error;
+  tcp::socket               wake(m_context);
+  wake.connect(m_acceptor.local_endpoint(), error);
+  m_acceptor_thread.join();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& socket : m_sockets) {
+      socket->shutdown(tcp::socket::shutdown_both, error);
+    }
+  }
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+std::string LocalHttpServer::url() const {
+  return "http://127.0.0.1:" + std::to_string(m_acceptor.local_endpoint().port());
+}
+
+std::size_t LocalHttpServer::acceptedConnections() const {
+  return m_connections;
+}
+
+std::size_t LocalHttpServer::servedRequests() const {
+  return m_requests;
+}
+
+void LocalHttpServer::accept() {
+  while (not m_stopping) {
+    auto                      socket = std::make_shared<tcp::socket>(m_context);
+    boost::system::error_code error;
+    m_acceptor.accept(*socket, error);
+    if (error or m_stopping) {
+      continue;
+    }
+    ++m_connections;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sockets.push_back(socket);
+    m_threads.emplace_back([this, socket]() {
+      serve(socket);
+    });
+  }
+}
+
+void LocalHttpServer::serve(std::shared_ptr<tcp::socket> socket) {
+  boost::beast::flat_buffer buffer;
+  for (;;) {
+    boost::system::error_code         error;
+    http::request<http::empty_body> request;
+    http::read(*socket, buffer, request, error);
+    if (error) {
+      return;
+    }
+    ++m_requests;
+
+    const std::string target  = std::string(request.target());
+    const path        file    = m_root / target;
+    const std::string prefix  = "/redirect/";
+    const bool        allowed = m_authorization.empty() or request[http::field::authorization] == m_authorization;
+
+    http::response<http::string_body> response;
+    response.version(11);
+    response.keep_alive(request.keep_alive());
+    if (not allowed) {
+      response.result(http::status::unauthorized);
+      response.body() = "unauthorized";
+    } else if (target.compare(0, prefix.size(), prefix) == 0) {
+      response.result(http::status::moved_permanently);
+      response.set(http::field::location, target.substr(prefix.size() - 1));
+    } else if (target.find("..") != std::string::npos or not boost::filesystem::is_regular_file(file)) {
+      response.result(http::status::not_found);
+      response.body() = "not found";
+    } else {
+      const auto size    = boost::filesystem::file_size(file);
+      const auto version = std::to_string(DataSync::localModificationTime(file));
+      const auto etag    = "\"" + std::to_string(size) + "-" + version + "\"";
+      response.result(http::status::ok);
+      response.set(http::field::etag, etag);
+      response.set(http::field::last_modified, version);
+      if (request.method() == http::verb::get) {
+        response.body() = contentOf(file);
+      }
+      // a single range, if the If-Range validator matches
+      const std::string range   = std::string(request[http::field::range]);
+      const std::string ifRange = std::string(request[http::field::if_range]);
+      std::size_t       first   = 0;
+      std::size_t       last    = 0;
+      if (request.method() == http::verb::get and (ifRange.empty() or ifRange == etag) and
+          std::sscanf(range.c_str(), "bytes=%zu-%zu", &first, &last) == 2 and first <= last and last < size) {
+        response.result(http::status::partial_content);
+        response.set(http::field::content_range, "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+                                                     std::to_string(size));
+        response.body() = response.body().substr(first, last - first + 1);
+        response.content_length(response.body().size());
+      } else {
+        response.content_length(size);
+      }
+      if (request.method() == http::verb::head) {
+        http::response_serializer<http::string_body> serializer(response);
+        http::write_header(*socket, serializer, error);
+        if (error or not request.keep_alive()) {
+          return;
+        }
+        continue;
+      }
+    }
+    if (response.result() != http::status::ok and response.result() != http::status::partial_content) {
+      response.prepare_payload();
+    }
+    http::write(*socket, response, error);
+    if (error or not request.keep_alive()) {
+      return;
+    }
+  }
+}
+
+#endif
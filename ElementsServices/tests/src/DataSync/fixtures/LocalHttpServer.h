@@ -0,0 +1,69 @@
+/**
+ * @file LocalHttpServer.h
+ *
+ * @copyright 2019
+ *
+ */
+
+#ifndef ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_LOCALHTTPSERVER_H_
+#define ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_LOCALHTTPSERVER_H_
+
+#include <boost/version.hpp>
+
+#if BOOST_VERSION >= 107000
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+/**
+ * @brief A minimal keep-alive HTTP server which serves the files of a local directory.
+ * @details
+ * It answers GET and HEAD requests with Content-Length, ETag and Last-Modified,
+ * single Range requests (with If-Range),
+ * redirects /redirect/<path> to /<path>, and checks the basic authentication
+ * if an authorization is given.
+ */
+class LocalHttpServer {
+
+public:
+  explicit LocalHttpServer(ElementsServices::DataSync::path root, std::string authorization = "");
+
+  ~LocalHttpServer();
+
+  /** The URL of the root directory, e.g. http://127.0.0.1:12345 */
+  std::string url() const;
+
+  std::size_t acceptedConnections() const;
+
+  std::size_t servedRequests() const;
+
+private:
+  void accept();
+
+  void serve(std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+
+  ElementsServices::DataSync::path                          m_root;
+  std::string                                               m_authorization;
+  boost::asio::io_context                                   m_context;
+  boost::asio::ip::tcp::acceptor                            m_acceptor;
+  std::atomic<bool>                                         m_stopping;
+  std::atomic<std::size_t>                                  m_connections;
+  std::atomic<std::size_t>                                  m_requests;
+  std::mutex                                                m_mutex;
+  std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> m_sockets;
+  std::vector<std::thread>                                  m_threads;
+  std::thread                                               m_acceptor_thread;
+};
+
+#endif
+
+#endif  // ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_LOCALHTTPSERVER_H_
@@ -31,5 +31,5 @@ string MockDataSynchronizer::createDownloadCommand(path distantFile, path localF
 }
 
 std::map<path, path> MockDataSynchronizer::fileMap() {
-  return m_fileMap;
+  return m_dependencies.fileMap();
 }
@@ -0,0 +1,86 @@
+/**
+ * @file MockIrodsClient.cpp
+ *
+ * @copyright 2019
+ *
+ */
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "FileContent.h"
+#include "MockIrodsClient.h"
+
+namespace DataSync = ElementsServices::DataSync;
+
+using DataSync::path;
+using std::string;
+
+namespace {
+
+const string theMockIget = R"(#!/bin/sh
+[ "$1" = "--help" ] && exit 0
+echo "iget $*" >> "$MOCK_IRODS_LOG"
+while [ $# -gt 0 ]; do
+  case "$1" in
+    -f) shift ;;
+    -N) shift 2 ;;
+    *) break ;;
+  esac
+done
+eval destination=\${$#}
+status=0
+while [ $# -gt 1 ]; do
+  cp "$1" "$destination/" || status=3
+  shift
+done
+exit $status
+)";
+
+const string theMockIrsync = R"(#!/bin/sh
+echo "irsync $*" >> "$MOCK_IRODS_LOG"
+cp "${1#i:}" "$2"
+)";
+
+const string theMockIls = R"(#!/bin/sh
+[ "$1" = "-l" ] && shift
+[ -f "$1" ] || exit 4
+echo "  user 0 demoResc $(wc -c < "$1") 2020-01-01.00:00 & ${1##*/}"
+)";
+
+void writeScript(path file, const string& content) {
+  writeFile(file, content);
+  boost::filesystem::permissions(file, boost::filesystem::owner_all);
+}
+
+}  // namespace
+
+MockIrodsClient::MockIrodsClient()
+    : WorkspaceFixture(), m_binDir(m_top_dir.path() / "bin"), m_logFile(m_top_dir.path() / "irods.log") {
+  boost::filesystem::create_directories(m_binDir);
+  writeScript(m_binDir / "iget", theMockIget);
+  writeScript(m_binDir / "irsync", theMockIrsync);
+  writeScript(m_binDir / "ils", theMockIls);
+  const char* systemPath = std::getenv("PATH");
+  m_env["PATH"]           = m_binDir.string() + ":" + (systemPath ? systemPath : "/usr/bin:/bin");
+  m_env["MOCK_IRODS_LOG"] = m_logFile.string();
+}
+
+int MockIrodsClient::callCount(const string& command) const {
+  std::istringstream lines(log());
+  string             line;
+  int                count = 0;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, command.size() + 1, command + " ") == 0) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+string MockIrodsClient::log() const {
+  return contentOf(m_logFile);
+}
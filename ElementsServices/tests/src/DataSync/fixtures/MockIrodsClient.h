@@ -0,0 +1,36 @@
+/**
+ * @file MockIrodsClient.h
+ *
+ * @copyright 2019
+ *
+ */
+
+#ifndef ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_MOCKIRODSCLIENT_H_
+#define ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_MOCKIRODSCLIENT_H_
+
+#include <string>
+
+#include "ElementsServices/DataSync/DataSyncUtils.h"
+
+#include "ConfigFilesFixture.h"
+
+/**
+ * @brief Shell scripts which stand for the iRODS client commands, put first in the PATH.
+ * @details
+ * iget and irsync copy local files, and log their command lines.
+ */
+struct MockIrodsClient : public WorkspaceFixture {
+
+  MockIrodsClient();
+
+  /** The number of calls to a command */
+  int callCount(const std::string& command) const;
+
+  /** The command lines */
+  std::string log() const;
+
+  ElementsServices::DataSync::path m_binDir;
+  ElementsServices::DataSync::path m_logFile;
+};
+
+#endif  // ELEMENTSSERVICES_TESTS_SRC_DATASYNC_FIXTURES_MOCKIRODSCLIENT_H_
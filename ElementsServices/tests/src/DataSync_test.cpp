@@ -17,12 +17,16 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <boost/version.hpp>
 
 #include "ElementsServices/DataSync.h"
+#include "ElementsServices/DataSync/HttpSynchronizer.h"
 #include "ElementsServices/DataSync/IrodsSynchronizer.h"
 #include "ElementsServices/DataSync/WebdavSynchronizer.h"
 
 #include "DataSync/fixtures/ConfigFilesFixture.h"
+#include "DataSync/fixtures/FileContent.h"
+#include "DataSync/fixtures/LocalHttpServer.h"
 
 namespace DataSync = ElementsServices::DataSync;
 
@@ -69,6 +73,37 @@ BOOST_AUTO_TEST_CASE(dataSyncIrodsFr_test) {
   }
 }
 
+#if BOOST_VERSION >= 107000
+
+BOOST_FIXTURE_TEST_CASE(unavailableFallback_test, WorkspaceFixture) {
+  if (DataSync::irodsIsInstalled()) {
+    return;
+  }
+  // a primary host which serves all the files, configured in a temporary configuration directory
+  for (const auto& file : theDistantFiles()) {
+    const path distantFile = m_top_dir.path() / "distant" / file;
+    DataSync::createLocalDirOf(distantFile);
+    writeFile(distantFile, file.string());
+  }
+  LocalHttpServer server(m_top_dir.path(), DataSync::basicAuthorization("user", "secret"));
+  const path      confDir = m_top_dir.path() / "conf";
+  const path      config  = "ElementsServices/testdata/sync_served_http.conf";
+  DataSync::createLocalDirOf(confDir / config);
+  writeFile(confDir / config, "host = HTTP\nhost-url = " + server.url() +
+                                  "\nuser = user\npassword = secret\n"
+                                  "distant-workspace = distant\nlocal-workspace = /local\n");
+  m_env["ELEMENTS_CONF_PATH"] = confDir.string() + ":" + m_env.get("ELEMENTS_CONF_PATH");
+
+  // the client of the fallback host is missing, which is not an error
+  auto sync = DataSync::DataSync(config, theDependencyConfig());
+  BOOST_CHECK_NO_THROW(sync.downloadWithFallback(theIrodsFrConfig()));
+  for (const auto& file : theLocalFiles()) {
+    BOOST_CHECK(boost::filesystem::is_regular_file(sync.absolutePath(file)));
+  }
+}
+
+#endif
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()